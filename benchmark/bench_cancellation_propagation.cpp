@@ -0,0 +1,135 @@
+/*
+    Copyright (c) 2025 UXL Foundation Contributors
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+//! \file bench_cancellation_propagation.cpp
+//! \brief Measures the cost of cancellations in the presence of many live contexts, as in a service
+//! that keeps a context per in-flight request. A number of contexts bound to a long-lived root stay
+//! alive during the measurement. Concurrently processed requests create trees of nested contexts,
+//! and each request is cancelled from its innermost level while the other requests keep creating
+//! and destroying contexts. The time of the cancellation calls and the throughput of the requests
+//! are reported.
+//!
+//! Options: --live=N (-1 means 0, 1000, 10000, 100000) --requests=N --depth=N (of request trees)
+//!          --fanout=N (of request trees) --threads=N
+
+#include "common/bench_utils.h"
+
+#include "oneapi/tbb/blocked_range.h"
+#include "oneapi/tbb/global_control.h"
+#include "oneapi/tbb/parallel_for.h"
+#include "oneapi/tbb/partitioner.h"
+#include "oneapi/tbb/task_arena.h"
+#include "oneapi/tbb/task_group.h"
+#include "oneapi/tbb/info.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <vector>
+
+namespace {
+
+using clock_type = std::chrono::steady_clock;
+
+struct request_params {
+    long depth;
+    long fanout;
+};
+
+//! Creates a level of the request tree in its own context; the first innermost task cancels the request
+void run_level(long level, const request_params& p, tbb::task_group_context& request_ctx,
+               std::atomic<bool>& cancel_issued, double& cancel_us)
+{
+    if (level == p.depth) {
+        if (!cancel_issued.exchange(true)) {
+            auto start = clock_type::now();
+            request_ctx.cancel_group_execution();
+            cancel_us = std::chrono::duration<double, std::micro>(clock_type::now() - start).count();
+        }
+        return;
+    }
+    tbb::task_group_context ctx;
+    tbb::parallel_for(tbb::blocked_range<long>(0, p.fanout, 1), [&](const tbb::blocked_range<long>& r) {
+        for (long i = r.begin(); i != r.end(); ++i) {
+            run_level(level + 1, p, request_ctx, cancel_issued, cancel_us);
+        }
+    }, tbb::simple_partitioner(), ctx);
+}
+
+//! Processes a request in an isolated context and returns the time of its cancellation
+double run_request(const request_params& p) {
+    tbb::task_group_context request_ctx(tbb::task_group_context::isolated);
+    std::atomic<bool> cancel_issued{false};
+    double cancel_us = 0;
+    tbb::parallel_for(tbb::blocked_range<long>(0, p.fanout, 1), [&](const tbb::blocked_range<long>& r) {
+        for (long i = r.begin(); i != r.end(); ++i) {
+            run_level(1, p, request_ctx, cancel_issued, cancel_us);
+        }
+    }, tbb::simple_partitioner(), request_ctx);
+    return cancel_us;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    bench::options opts(argc, argv);
+    const long requested_live = opts.get("live", -1);
+    const long requests = opts.get("requests", 2000);
+    const long depth = opts.get("depth", 3);
+    const long fanout = opts.get("fanout", 4);
+    const int threads = int(opts.get("threads", tbb::info::default_concurrency()));
+
+    std::vector<long> live_counts;
+    if (requested_live >= 0) {
+        live_counts.push_back(requested_live);
+    } else {
+        live_counts = { 0, 1000, 10000, 100000 };
+    }
+
+    tbb::global_control parallelism(tbb::global_control::max_allowed_parallelism, std::size_t(threads));
+    tbb::task_arena arena(threads);
+    for (long live : live_counts) {
+        request_params params{ depth < 1 ? 1 : depth, fanout < 1 ? 1 : fanout };
+        std::vector<double> cancel_times(std::size_t(requests), 0.);
+        double seconds = 0;
+        arena.execute([&] {
+            // The live contexts are bound to a root that outlives them
+            tbb::task_group_context live_root(tbb::task_group_context::isolated);
+            std::vector<std::unique_ptr<tbb::task_group_context>> live_contexts(static_cast<std::size_t>(live));
+            tbb::parallel_for(tbb::blocked_range<long>(0, live), [&](const tbb::blocked_range<long>& r) {
+                for (long i = r.begin(); i != r.end(); ++i) {
+                    live_contexts[i].reset(new tbb::task_group_context);
+                    // The context is bound at the first use
+                    tbb::parallel_for(0, 1, [](int) {}, *live_contexts[i]);
+                }
+            }, live_root);
+
+            auto start = clock_type::now();
+            tbb::parallel_for(tbb::blocked_range<long>(0, requests, 1), [&](const tbb::blocked_range<long>& r) {
+                for (long i = r.begin(); i != r.end(); ++i) {
+                    cancel_times[i] = run_request(params);
+                }
+            }, tbb::simple_partitioner());
+            seconds = std::chrono::duration<double>(clock_type::now() - start).count();
+        });
+
+        std::printf("%-32s live=%-7ld threads=%-4d cancel median=%.2fus p99=%.2fus requests/s=%.0f\n",
+            "cancel_with_live_contexts", live, threads, bench::median(cancel_times),
+            bench::percentile(cancel_times, 0.99), double(requests) / seconds);
+    }
+    return 0;
+}
@@ -0,0 +1,74 @@
+/*
+    Copyright (c) 2025 UXL Foundation Contributors
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+//! \file bench_context_churn.cpp
+//! \brief Measures the overhead of the contexts of fine-grained nested algorithms. Each iteration of
+//! an outer parallel_for runs a small inner parallel_for, so a context is created, bound to the
+//! context of the outer algorithm and destroyed per inner algorithm, while the inner algorithms do
+//! almost no work. The throughput of the inner algorithms is reported.
+//!
+//! Options: --outer=N (iterations of the outer loop) --inner=N (iterations of each inner loop)
+//!          --repeats=N --threads=N
+
+#include "common/bench_utils.h"
+
+#include "oneapi/tbb/blocked_range.h"
+#include "oneapi/tbb/global_control.h"
+#include "oneapi/tbb/parallel_for.h"
+#include "oneapi/tbb/partitioner.h"
+#include "oneapi/tbb/task_arena.h"
+#include "oneapi/tbb/info.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+int main(int argc, char* argv[]) {
+    bench::options opts(argc, argv);
+    const long outer = opts.get("outer", 200000);
+    const long inner = opts.get("inner", 4);
+    const long repeats = opts.get("repeats", 5);
+    const int threads = int(opts.get("threads", tbb::info::default_concurrency()));
+
+    tbb::global_control parallelism(tbb::global_control::max_allowed_parallelism, std::size_t(threads));
+    tbb::task_arena arena(threads);
+    std::atomic<long> sink{0};
+    std::vector<double> rates;
+    for (long r = 0; r < repeats; ++r) {
+        double seconds = 0;
+        arena.execute([&] {
+            auto start = std::chrono::steady_clock::now();
+            tbb::parallel_for(tbb::blocked_range<long>(0, outer), [&](const tbb::blocked_range<long>& range) {
+                // The inner iterations can be stolen, so the counter is atomic
+                std::atomic<long> local{0};
+                for (long i = range.begin(); i != range.end(); ++i) {
+                    tbb::parallel_for(tbb::blocked_range<long>(0, inner, 1), [&local](const tbb::blocked_range<long>& ir) {
+                        local.fetch_add(long(ir.size()), std::memory_order_relaxed);
+                    }, tbb::simple_partitioner());
+                }
+                sink.fetch_add(local.load(std::memory_order_relaxed), std::memory_order_relaxed);
+            });
+            seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        });
+        rates.push_back(double(outer) / seconds);
+    }
+
+    std::printf("%-32s outer=%-8ld inner=%-4ld threads=%-4d inner algorithms/s median=%.0f max=%.0f\n",
+        "nested_parallel_for_churn", outer, inner, threads, bench::median(rates),
+        bench::percentile(rates, 1.0));
+    return sink.load() == outer * inner * repeats ? 0 : 1;
+}
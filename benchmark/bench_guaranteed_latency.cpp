@@ -0,0 +1,129 @@
+/*
+    Copyright (c) 2025 UXL Foundation Contributors
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+//! \file bench_guaranteed_latency.cpp
+//! \brief Measures the latency of requests to an arena while an antagonist arena keeps all the workers
+//! busy. The requests are served by workers only, so without guaranteed workers each of them waits
+//! until a worker of the antagonist finishes its task and migrates.
+//!
+//! Options: --samples=N --threads=N --guaranteed=N (-1 means 0 and 1) --task-us=N (duration of antagonist tasks)
+
+#define TBB_PREVIEW_TASK_ARENA_MIN_CONCURRENCY 1
+
+#include "common/bench_utils.h"
+
+#include "oneapi/tbb/global_control.h"
+#include "oneapi/tbb/task_arena.h"
+#include "oneapi/tbb/task_group.h"
+#include "oneapi/tbb/info.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using clock_type = std::chrono::steady_clock;
+
+void busy_wait(std::chrono::microseconds duration) {
+    auto finish = clock_type::now() + duration;
+    while (clock_type::now() < finish) {}
+}
+
+//! Occupies a worker of the antagonist arena and resubmits itself until the stop flag is set
+struct antagonist_task {
+    tbb::task_arena* arena;
+    tbb::task_group* tg;
+    const std::atomic<bool>* stop;
+    long task_us;
+
+    void operator()() const {
+        busy_wait(std::chrono::microseconds(task_us));
+        if (!stop->load(std::memory_order_relaxed)) {
+            arena->enqueue(*this, *tg);
+        }
+    }
+};
+
+//! Keeps the arena saturated with tasks until the stop flag is set
+void run_antagonist(tbb::task_arena& arena, tbb::task_group& tg, const std::atomic<bool>& stop, long task_us) {
+    for (int i = 0; i < 2 * arena.max_concurrency(); ++i) {
+        arena.enqueue(antagonist_task{&arena, &tg, &stop, task_us}, tg);
+    }
+}
+
+//! Returns the enqueue-to-start latency of each request in microseconds.
+std::vector<double> measure_latency(tbb::task_arena& arena, long samples) {
+    std::vector<double> latencies;
+    for (long s = 0; s < samples; ++s) {
+        // Requests arrive with pauses, so the arena runs out of work between them
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+
+        std::atomic<bool> started{false};
+        clock_type::time_point start_time;
+        const clock_type::time_point enqueue_time = clock_type::now();
+        arena.enqueue([&] {
+            start_time = clock_type::now();
+            started.store(true, std::memory_order_release);
+        });
+        while (!started.load(std::memory_order_acquire)) {
+            std::this_thread::yield();
+        }
+        latencies.push_back(std::chrono::duration<double, std::micro>(start_time - enqueue_time).count());
+    }
+    return latencies;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    bench::options opts(argc, argv);
+    const long samples = opts.get("samples", 1000);
+    const long threads = opts.get("threads", tbb::info::default_concurrency());
+    const long requested_guaranteed = opts.get("guaranteed", -1);
+    const long task_us = opts.get("task-us", 1000);
+
+    std::vector<long> guarantees;
+    if (requested_guaranteed >= 0) {
+        guarantees.push_back(requested_guaranteed);
+    } else {
+        guarantees = { 0, 1 };
+    }
+
+    // The arenas compete for the same workers
+    tbb::global_control parallelism(tbb::global_control::max_allowed_parallelism, std::size_t(threads) + 1);
+    for (long guaranteed : guarantees) {
+        // The reserved slot of the external thread counts toward the minimal concurrency
+        tbb::task_arena critical(tbb::task_arena::constraints{}
+            .set_max_concurrency(int(threads) + 1)
+            .set_min_concurrency(guaranteed > 0 ? int(guaranteed) + 1 : tbb::task_arena::automatic), 1);
+        tbb::task_arena antagonist(int(threads) + 1, 1);
+        critical.initialize();
+
+        std::atomic<bool> stop{false};
+        tbb::task_group tg;
+        run_antagonist(antagonist, tg, stop, task_us);
+        std::vector<double> latencies = measure_latency(critical, samples);
+        stop = true;
+        tg.wait();
+
+        std::printf("%-32s guaranteed=%-4ld median=%.2fus p99=%.2fus max=%.2fus\n", "request_latency", guaranteed,
+            bench::median(latencies), bench::percentile(latencies, 0.99), bench::percentile(latencies, 1.0));
+    }
+    return 0;
+}
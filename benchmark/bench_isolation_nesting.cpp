@@ -0,0 +1,113 @@
+/*
+    Copyright (c) 2025 UXL Foundation Contributors
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+//! \file bench_isolation_nesting.cpp
+//! \brief Measures the cost of parallel calls made from deeply nested isolated regions, as in a
+//! library that uses the library. Each level leaves a number of its own tasks pending and calls the
+//! next level in an isolated region, so the task pool of the calling thread holds the tasks of all
+//! the enclosing regions while the innermost level runs fine-grained parallel loops. Only the time
+//! of the innermost loops is reported.
+//!
+//! Options: --depth=N (0 means 1, 2, 4, ... up to 32) --pending=N (tasks left by each level)
+//!          --iterations=N (of each innermost loop) --calls=N (innermost loops) --repeats=N --threads=N
+
+#include "common/bench_utils.h"
+
+#include "oneapi/tbb/blocked_range.h"
+#include "oneapi/tbb/global_control.h"
+#include "oneapi/tbb/parallel_for.h"
+#include "oneapi/tbb/partitioner.h"
+#include "oneapi/tbb/task_arena.h"
+#include "oneapi/tbb/task_group.h"
+#include "oneapi/tbb/info.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+namespace {
+
+std::atomic<long> g_sink{0};
+
+//! A tiny amount of work to make the scheduling overhead dominate
+inline void tiny_work(long i) {
+    if ((i & 0xfff) == 0) g_sink.fetch_add(1, std::memory_order_relaxed);
+}
+
+struct nesting_params {
+    long depth;
+    long pending;
+    long iterations;
+    long calls;
+};
+
+//! Returns the duration of the innermost loops in seconds
+double nested_call(long level, const nesting_params& p) {
+    tbb::task_group tg;
+    for (long i = 0; i < p.pending; ++i) {
+        tg.run([i] { tiny_work(i); });
+    }
+    double seconds = 0;
+    if (level < p.depth) {
+        tbb::this_task_arena::isolate([level, &p, &seconds] { seconds = nested_call(level + 1, p); });
+    } else {
+        auto start = std::chrono::steady_clock::now();
+        for (long c = 0; c < p.calls; ++c) {
+            tbb::parallel_for(tbb::blocked_range<long>(0, p.iterations, 1), [](const tbb::blocked_range<long>& r) {
+                for (long i = r.begin(); i != r.end(); ++i) tiny_work(i);
+            }, tbb::simple_partitioner());
+        }
+        seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+    tg.wait();
+    return seconds;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    bench::options opts(argc, argv);
+    const long requested_depth = opts.get("depth", 0);
+    const long pending = opts.get("pending", 64);
+    const long iterations = opts.get("iterations", 256);
+    const long calls = opts.get("calls", 1000);
+    const long repeats = opts.get("repeats", 5);
+    const int threads = int(opts.get("threads", tbb::info::default_concurrency()));
+
+    std::vector<long> depths;
+    if (requested_depth > 0) {
+        depths.push_back(requested_depth);
+    } else {
+        for (long d = 1; d <= 32; d *= 2) depths.push_back(d);
+    }
+
+    tbb::global_control parallelism(tbb::global_control::max_allowed_parallelism, std::size_t(threads));
+    tbb::task_arena arena(threads);
+    for (long depth : depths) {
+        nesting_params params{ depth, pending, iterations, calls };
+        std::vector<double> times;
+        arena.execute([&] {
+            for (long r = 0; r < repeats; ++r) {
+                times.push_back(nested_call(0, params));
+            }
+        });
+        double seconds = bench::median(times);
+        std::printf("%-32s depth=%-4ld threads=%-4d time=%.6fs calls/s=%.0f\n", "isolated_nested_calls",
+            depth, threads, seconds, double(calls) / seconds);
+    }
+    return 0;
+}
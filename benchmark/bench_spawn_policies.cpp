@@ -0,0 +1,152 @@
+/*
+    Copyright (c) 2026 UXL Foundation Contributors
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+//! \file bench_spawn_policies.cpp
+//! \brief Compares the help-first spawn policy of task_group with the work-first policy of
+//! work_first_task_group on recursive algorithms: Fibonacci numbers, which submit two tasks at each
+//! level, and N-Queens search, which submits a task for each free square of a row.
+//!
+//! Options: --fib=N (the Fibonacci number) --fib-cutoff=N --board=N (from 1 to 16) --queens-cutoff=N
+//!          --repeats=N --threads=N (0 means 1, 2, 4, ... up to the hardware concurrency)
+
+#define TBB_PREVIEW_WORK_FIRST_TASK_GROUP 1
+
+#include "common/bench_utils.h"
+
+#include "oneapi/tbb/info.h"
+#include "oneapi/tbb/task_arena.h"
+#include "oneapi/tbb/task_group.h"
+
+#include <cstdio>
+#include <vector>
+
+namespace {
+
+long fib_cutoff = 12;
+long queens_cutoff = 4;
+
+long serial_fib(long n) {
+    return n < 2 ? n : serial_fib(n - 1) + serial_fib(n - 2);
+}
+
+template <typename TaskGroup>
+long parallel_fib(long n) {
+    if (n < fib_cutoff) {
+        return serial_fib(n);
+    }
+    long x = 0, y = 0;
+    TaskGroup g;
+    g.run([&] { x = parallel_fib<TaskGroup>(n - 1); });
+    g.run([&] { y = parallel_fib<TaskGroup>(n - 2); });
+    g.wait();
+    return x + y;
+}
+
+//! Counts the placements of the queens in the remaining rows.
+//! The bits of the masks mark the columns and the diagonals attacked by the queens placed before.
+long serial_queens(unsigned all, unsigned columns, unsigned left, unsigned right) {
+    if (columns == all) {
+        return 1;
+    }
+    long count = 0;
+    for (unsigned free = all & ~(columns | left | right); free != 0; free &= free - 1) {
+        unsigned bit = free & (0 - free);
+        count += serial_queens(all, columns | bit, (left | bit) << 1, (right | bit) >> 1);
+    }
+    return count;
+}
+
+template <typename TaskGroup>
+long parallel_queens(unsigned all, unsigned columns, unsigned left, unsigned right, long depth) {
+    if (depth >= queens_cutoff) {
+        return serial_queens(all, columns, left, right);
+    }
+    std::vector<long> counts(32, 0);
+    TaskGroup g;
+    unsigned i = 0;
+    for (unsigned free = all & ~(columns | left | right); free != 0; free &= free - 1, ++i) {
+        unsigned bit = free & (0 - free);
+        long& count = counts[i];
+        g.run([=, &count] {
+            count = parallel_queens<TaskGroup>(all, columns | bit, (left | bit) << 1, (right | bit) >> 1, depth + 1);
+        });
+    }
+    g.wait();
+    long total = 0;
+    for (long count : counts) {
+        total += count;
+    }
+    return total;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    bench::options opts(argc, argv);
+    const long fib_number = opts.get("fib", 35);
+    const long board_size = opts.get("board", 12);
+    const long repeats = opts.get("repeats", 5);
+    const long requested_threads = opts.get("threads", 0);
+    fib_cutoff = opts.get("fib-cutoff", fib_cutoff);
+    queens_cutoff = opts.get("queens-cutoff", queens_cutoff);
+    if (board_size < 1 || board_size > 16) {
+        std::fprintf(stderr, "The board size must be from 1 to 16\n");
+        return 1;
+    }
+    const unsigned all = (1u << board_size) - 1;
+
+    std::vector<int> thread_counts;
+    if (requested_threads > 0) {
+        thread_counts.push_back(int(requested_threads));
+    } else {
+        const int max_threads = tbb::info::default_concurrency();
+        for (int t = 1; t < max_threads; t *= 2) thread_counts.push_back(t);
+        thread_counts.push_back(max_threads);
+    }
+
+    struct scenario {
+        const char* name;
+        //! The scenarios of a problem solve it with different policies
+        int problem;
+        long (*body)(long, unsigned);
+    } scenarios[] = {
+        { "fib_help_first", 0, [](long n, unsigned) { return parallel_fib<tbb::task_group>(n); } },
+        { "fib_work_first", 0, [](long n, unsigned) { return parallel_fib<tbb::work_first_task_group>(n); } },
+        { "queens_help_first", 1, [](long, unsigned a) { return parallel_queens<tbb::task_group>(a, 0, 0, 0, 0); } },
+        { "queens_work_first", 1, [](long, unsigned a) { return parallel_queens<tbb::work_first_task_group>(a, 0, 0, 0, 0); } }
+    };
+
+    for (int threads : thread_counts) {
+        // The results of both policies are compared to make sure they do the same work
+        long expected[2] = { -1, -1 };
+        for (const scenario& s : scenarios) {
+            tbb::task_arena arena(threads);
+            long result = 0;
+            double seconds = 0;
+            arena.execute([&] {
+                seconds = bench::median(bench::measure(repeats, [&] { result = s.body(fib_number, all); }));
+            });
+            long& reference = expected[s.problem];
+            if (reference >= 0 && reference != result) {
+                std::fprintf(stderr, "%s: the result %ld differs from %ld of the other policy\n", s.name, result, reference);
+                return 1;
+            }
+            reference = result;
+            bench::report(s.name, threads, seconds, 1.0, "runs");
+        }
+    }
+    return 0;
+}
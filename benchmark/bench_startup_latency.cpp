@@ -0,0 +1,111 @@
+/*
+    Copyright (c) 2025 UXL Foundation Contributors
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+//! \file bench_startup_latency.cpp
+//! \brief Measures the time of the first parallel region executed by a freshly started scheduler,
+//! with and without the warm-up of the arena. The scheduler is finalized after each sample, so each
+//! sample creates the worker threads anew. The time of the warm-up itself is reported separately.
+//!
+//! Options: --samples=N --threads=N --warm-up=N (-1 means 0 and 1) --work-us=N (duration of iterations)
+
+#define TBB_PREVIEW_TASK_ARENA_WARM_UP 1
+
+#include "common/bench_utils.h"
+
+#include "oneapi/tbb/global_control.h"
+#include "oneapi/tbb/task_arena.h"
+#include "oneapi/tbb/parallel_for.h"
+#include "oneapi/tbb/info.h"
+
+#include <chrono>
+#include <cstdio>
+#include <new>
+#include <vector>
+
+namespace {
+
+using clock_type = std::chrono::steady_clock;
+
+void busy_wait(std::chrono::microseconds duration) {
+    auto finish = clock_type::now() + duration;
+    while (clock_type::now() < finish) {}
+}
+
+struct startup_sample {
+    double warm_up_us;
+    double first_region_us;
+};
+
+//! Starts the scheduler, executes the first parallel region in it, and finalizes the scheduler
+startup_sample measure_startup(long threads, bool warm_up, long work_us) {
+    startup_sample sample{0, 0};
+    tbb::task_scheduler_handle handle{tbb::attach{}};
+    {
+        tbb::global_control parallelism(tbb::global_control::max_allowed_parallelism, std::size_t(threads));
+        tbb::task_arena arena(static_cast<int>(threads));
+        arena.initialize();
+
+        if (warm_up) {
+            auto start = clock_type::now();
+            arena.warm_up();
+            sample.warm_up_us = std::chrono::duration<double, std::micro>(clock_type::now() - start).count();
+        }
+
+        auto start = clock_type::now();
+        arena.execute([threads, work_us] {
+            tbb::parallel_for(0, int(threads), [work_us](int) {
+                busy_wait(std::chrono::microseconds(work_us));
+            }, tbb::simple_partitioner{});
+        });
+        sample.first_region_us = std::chrono::duration<double, std::micro>(clock_type::now() - start).count();
+    }
+    if (!tbb::finalize(handle, std::nothrow)) {
+        std::printf("The scheduler is not finalized, the next sample reuses the workers\n");
+    }
+    return sample;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    bench::options opts(argc, argv);
+    const long samples = opts.get("samples", 100);
+    const long threads = opts.get("threads", tbb::info::default_concurrency());
+    const long requested_warm_up = opts.get("warm-up", -1);
+    const long work_us = opts.get("work-us", 100);
+
+    std::vector<long> modes;
+    if (requested_warm_up >= 0) {
+        modes.push_back(requested_warm_up);
+    } else {
+        modes = { 0, 1 };
+    }
+
+    for (long warm_up : modes) {
+        std::vector<double> warm_up_times;
+        std::vector<double> first_region_times;
+        for (long s = 0; s < samples; ++s) {
+            startup_sample sample = measure_startup(threads, warm_up != 0, work_us);
+            warm_up_times.push_back(sample.warm_up_us);
+            first_region_times.push_back(sample.first_region_us);
+        }
+
+        std::printf("%-32s warm-up=%-2ld threads=%-4ld median=%.2fus p99=%.2fus warm-up median=%.2fus\n",
+            "first_parallel_region", warm_up, threads, bench::median(first_region_times),
+            bench::percentile(first_region_times, 0.99), bench::median(warm_up_times));
+    }
+    return 0;
+}
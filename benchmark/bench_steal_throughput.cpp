@@ -0,0 +1,110 @@
+/*
+    Copyright (c) 2025 UXL Foundation Contributors
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+//! \file bench_steal_throughput.cpp
+//! \brief Measures the throughput of the task pools of arena slots under stealing pressure.
+//! Build the library with and without TBB_LOCK_FREE_TASK_POOL and compare the outputs
+//! to evaluate the lock-free work-stealing deque against the locked task pool.
+//!
+//! Options: --tasks=N --repeats=N --threads=N (0 means 1, 2, 4, ... up to the hardware concurrency)
+
+#include "common/bench_utils.h"
+
+#include "oneapi/tbb/blocked_range.h"
+#include "oneapi/tbb/parallel_for.h"
+#include "oneapi/tbb/partitioner.h"
+#include "oneapi/tbb/task_arena.h"
+#include "oneapi/tbb/task_group.h"
+#include "oneapi/tbb/info.h"
+
+#include <atomic>
+#include <vector>
+
+namespace {
+
+std::atomic<long> g_sink{0};
+
+//! A tiny amount of work to make the scheduling overhead dominate
+inline void tiny_work(long i) {
+    if ((i & 0xfff) == 0) g_sink.fetch_add(1, std::memory_order_relaxed);
+}
+
+//! All tasks are spawned by a single thread, so every other thread obtains work only by stealing.
+void spawn_storm(long num_tasks) {
+    tbb::task_group tg;
+    for (long i = 0; i < num_tasks; ++i) {
+        tg.run([i] { tiny_work(i); });
+    }
+    tg.wait();
+}
+
+//! Fine-grained parallel_for where the range is split down to single iterations.
+void fine_grained_for(long num_tasks) {
+    tbb::parallel_for(tbb::blocked_range<long>(0, num_tasks, 1), [](const tbb::blocked_range<long>& r) {
+        for (long i = r.begin(); i != r.end(); ++i) tiny_work(i);
+    }, tbb::simple_partitioner());
+}
+
+//! Recursive binary splitting where each thread both spawns and steals.
+void binary_tree(long num_tasks) {
+    if (num_tasks <= 1) {
+        tiny_work(num_tasks);
+        return;
+    }
+    tbb::task_group tg;
+    tg.run([num_tasks] { binary_tree(num_tasks / 2); });
+    binary_tree(num_tasks - num_tasks / 2);
+    tg.wait();
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    bench::options opts(argc, argv);
+    const long num_tasks = opts.get("tasks", 1000000);
+    const long repeats = opts.get("repeats", 5);
+    const long requested_threads = opts.get("threads", 0);
+
+    std::vector<int> thread_counts;
+    if (requested_threads > 0) {
+        thread_counts.push_back(int(requested_threads));
+    } else {
+        const int max_threads = tbb::info::default_concurrency();
+        for (int t = 1; t < max_threads; t *= 2) thread_counts.push_back(t);
+        thread_counts.push_back(max_threads);
+    }
+
+    struct scenario {
+        const char* name;
+        void (*body)(long);
+    } scenarios[] = {
+        { "spawn_storm", spawn_storm },
+        { "fine_grained_parallel_for", fine_grained_for },
+        { "binary_tree", binary_tree }
+    };
+
+    for (const scenario& s : scenarios) {
+        for (int threads : thread_counts) {
+            tbb::task_arena arena(threads);
+            double seconds = 0;
+            arena.execute([&] {
+                seconds = bench::median(bench::measure(repeats, [&] { s.body(num_tasks); }));
+            });
+            bench::report(s.name, threads, seconds, double(num_tasks), "tasks");
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,84 @@
+/*
+    Copyright (c) 2025 UXL Foundation Contributors
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+//! \file bench_wakeup_latency.cpp
+//! \brief Measures the latency from enqueueing a single task into an idle arena to the start of its execution.
+//! The idle period before each enqueue decides where the workers are found: short periods catch them
+//! retained (parked) in the arena, long periods let them leave the arena and fall asleep.
+//!
+//! Options: --samples=N --idle-us=N (0 means 10, 100, 1000 and 10000) --threads=N
+
+#include "common/bench_utils.h"
+
+#include "oneapi/tbb/task_arena.h"
+#include "oneapi/tbb/info.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using clock_type = std::chrono::steady_clock;
+
+//! Returns the enqueue-to-start latency of each sample in microseconds.
+std::vector<double> measure_latency(tbb::task_arena& arena, long samples, long idle_us) {
+    std::vector<double> latencies;
+    for (long s = 0; s < samples; ++s) {
+        std::this_thread::sleep_for(std::chrono::microseconds(idle_us));
+
+        std::atomic<bool> started{false};
+        clock_type::time_point start_time;
+        const clock_type::time_point enqueue_time = clock_type::now();
+        arena.enqueue([&] {
+            start_time = clock_type::now();
+            started.store(true, std::memory_order_release);
+        });
+        while (!started.load(std::memory_order_acquire)) {
+            std::this_thread::yield();
+        }
+        latencies.push_back(std::chrono::duration<double, std::micro>(start_time - enqueue_time).count());
+    }
+    return latencies;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    bench::options opts(argc, argv);
+    const long samples = opts.get("samples", 1000);
+    const long requested_idle_us = opts.get("idle-us", 0);
+    const long threads = opts.get("threads", tbb::info::default_concurrency());
+
+    std::vector<long> idle_periods;
+    if (requested_idle_us > 0) {
+        idle_periods.push_back(requested_idle_us);
+    } else {
+        idle_periods = { 10, 100, 1000, 10000 };
+    }
+
+    // The external thread does not join the arena, so each task is executed by a worker
+    tbb::task_arena arena(int(threads) + 1, /*reserved_for_masters*/ 1);
+    arena.initialize();
+    for (long idle_us : idle_periods) {
+        std::vector<double> latencies = measure_latency(arena, samples, idle_us);
+        std::printf("%-32s idle=%-6ldus median=%.2fus p99=%.2fus max=%.2fus\n", "enqueue_to_start", idle_us,
+            bench::median(latencies), bench::percentile(latencies, 0.99), bench::percentile(latencies, 1.0));
+    }
+    return 0;
+}
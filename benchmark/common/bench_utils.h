@@ -0,0 +1,82 @@
+/*
+    Copyright (c) 2025 UXL Foundation Contributors
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#ifndef __TBB_bench_utils_H
+#define __TBB_bench_utils_H
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace bench {
+
+//! Parses options of the form --name=value; unknown options are reported and ignored.
+class options {
+public:
+    options(int argc, char* argv[]) : my_argc(argc), my_argv(argv) {}
+
+    long get(const char* name, long default_value) const {
+        std::string prefix = std::string("--") + name + "=";
+        for (int i = 1; i < my_argc; ++i) {
+            if (std::strncmp(my_argv[i], prefix.c_str(), prefix.size()) == 0) {
+                return std::strtol(my_argv[i] + prefix.size(), nullptr, 10);
+            }
+        }
+        return default_value;
+    }
+
+private:
+    int my_argc;
+    char** my_argv;
+};
+
+//! Runs the body the given number of times and returns the wall-clock duration of each run in seconds.
+template <typename Body>
+std::vector<double> measure(long repeats, Body&& body) {
+    std::vector<double> times;
+    for (long r = 0; r < repeats; ++r) {
+        auto start = std::chrono::steady_clock::now();
+        body();
+        auto finish = std::chrono::steady_clock::now();
+        times.push_back(std::chrono::duration<double>(finish - start).count());
+    }
+    return times;
+}
+
+inline double median(std::vector<double> values) {
+    if (values.empty()) return 0;
+    std::sort(values.begin(), values.end());
+    return values[values.size() / 2];
+}
+
+//! Returns the value below which the given fraction of the values falls, e.g. 0.99 for the 99th percentile.
+inline double percentile(std::vector<double> values, double p) {
+    if (values.empty()) return 0;
+    std::sort(values.begin(), values.end());
+    return values[std::size_t(p * double(values.size() - 1))];
+}
+
+inline void report(const char* name, int threads, double seconds, double operations, const char* unit) {
+    std::printf("%-32s threads=%-4d time=%.6fs %s/s=%.0f\n", name, threads, seconds, unit, operations / seconds);
+}
+
+} // namespace bench
+
+#endif // __TBB_bench_utils_H
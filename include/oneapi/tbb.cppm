@@ -165,6 +165,9 @@ export namespace tbb {
     using tbb::v1::task_group;
 #if __TBB_PREVIEW_ISOLATED_TASK_GROUP
     using tbb::v1::isolated_task_group;
+#endif
+#if __TBB_PREVIEW_WORK_FIRST_TASK_GROUP
+    using tbb::v1::work_first_task_group;
 #endif
     using tbb::v1::task_group_status;
     using tbb::v1::not_complete;
@@ -175,6 +178,8 @@ export namespace tbb {
 #if __TBB_PREVIEW_TASK_GROUP_EXTENSIONS
     using tbb::v1::task_completion_handle;
     using tbb::v1::task_complete;
+    using tbb::v1::task_continuation;
+    using tbb::v1::continue_with;
 #endif
     using tbb::v1::task_scheduler_observer;
 
@@ -25,6 +25,10 @@
 #include "detail/_containers_helpers.h"
 #include "cache_aligned_allocator.h"
 
+#if __TBB_PREVIEW_COROUTINES
+#include "detail/_coroutine.h"
+#endif
+
 namespace tbb {
 namespace detail {
 namespace d2 {
@@ -310,6 +314,11 @@ namespace r1 {
                                                             , std::size_t ticket );
     TBB_EXPORT void __TBB_EXPORTED_FUNC wait_bounded_queue_monitor( concurrent_monitor* monitors, std::size_t monitor_tag,
                                                             std::ptrdiff_t target, d1::delegate_base& predicate );
+#if __TBB_PREVIEW_COROUTINES
+    TBB_EXPORT bool __TBB_EXPORTED_FUNC wait_bounded_queue_monitor_async( concurrent_monitor* monitors, std::size_t monitor_tag,
+                                                            std::ptrdiff_t target, d1::delegate_base& predicate,
+                                                            d1::suspended_coroutine& sc );
+#endif
 } // namespace r1
 
 
@@ -506,6 +515,111 @@ public:
         return internal_pop_if_present(&result);
     }
 
+#if __TBB_PREVIEW_COROUTINES && __TBB_CPP20_COROUTINES_PRESENT
+private:
+    class pop_awaiter {
+        //! Pops the item of the awaiter's ticket and resumes the coroutine
+        /** The pop is performed by the task rather than by the resumed coroutine: the items of a micro-queue
+            are popped in the order of tickets, and waiting for a preceding coroutine that is not resumed yet
+            could block the only thread of the arena. Instead of waiting, the task is enqueued again. */
+        class pop_task : public d1::suspended_coroutine {
+        public:
+            pop_task( pop_awaiter& awaiter, std::coroutine_handle<> coroutine, d1::small_object_allocator& alloc )
+                : my_awaiter(awaiter), my_coroutine(coroutine), my_allocator(alloc) {}
+
+            //! Registers the task to be executed when the item of the ticket is pushed or the queue is aborted
+            void wait_for_item() {
+                pop_awaiter& awaiter = my_awaiter;
+                queue_representation_type& rep = *awaiter.my_queue.my_queue_representation;
+                auto is_waiting = [&awaiter, &rep] {
+                    return awaiter.my_queue.my_abort_counter.load(std::memory_order_relaxed) == awaiter.my_abort_counter &&
+                        static_cast<std::ptrdiff_t>(rep.tail_counter.load(std::memory_order_relaxed)) <= awaiter.my_ticket;
+                };
+                d1::delegated_function<decltype(is_waiting)> predicate(is_waiting);
+                if (!is_waiting() || !r1::wait_bounded_queue_monitor_async(awaiter.my_queue.my_monitors,
+                        cbq_items_avail_tag, awaiter.my_ticket, predicate, *this)) {
+                    retry();
+                }
+            }
+
+        private:
+            void retry() {
+                r1::suspend_in_current_arena(*this);
+                r1::resume_in_arena(*this);
+            }
+
+            task* execute( d1::execution_data& ed ) override {
+                pop_awaiter& awaiter = my_awaiter;
+                concurrent_bounded_queue& queue = awaiter.my_queue;
+                queue_representation_type& rep = *queue.my_queue_representation;
+                if (m_aborted || queue.my_abort_counter.load(std::memory_order_relaxed) != awaiter.my_abort_counter) {
+                    rep.head_counter--;
+                    awaiter.my_aborted = true;
+                } else if (!rep.choose(awaiter.my_ticket).is_ready_to_pop(awaiter.my_ticket)) {
+                    retry();
+                    return nullptr;
+                } else if (rep.choose(awaiter.my_ticket).pop(&awaiter.my_result, awaiter.my_ticket, rep, queue.my_allocator)) {
+                    r1::notify_bounded_queue_monitor(queue.my_monitors, cbq_slots_avail_tag, awaiter.my_ticket);
+                } else {
+                    // The push of the ticket failed, so take the next ticket as pop() does
+                    awaiter.my_ticket = rep.head_counter++;
+                    wait_for_item();
+                    return nullptr;
+                }
+                std::coroutine_handle<> coroutine = my_coroutine;
+                my_allocator.delete_object(this, ed);
+                coroutine.resume();
+                return nullptr;
+            }
+
+            // The coroutine is resumed even if the context of the arena is cancelled, otherwise it would never complete
+            task* cancel( d1::execution_data& ed ) override {
+                return execute(ed);
+            }
+
+            pop_awaiter& my_awaiter;
+            std::coroutine_handle<> my_coroutine;
+            d1::small_object_allocator my_allocator;
+        };
+
+    public:
+        pop_awaiter( concurrent_bounded_queue& queue, T& result ) : my_queue(queue), my_result(result) {}
+
+        bool await_ready() {
+            my_abort_counter = my_queue.my_abort_counter.load(std::memory_order_relaxed);
+            return my_queue.internal_pop_if_present(&my_result);
+        }
+
+        void await_suspend( std::coroutine_handle<> coroutine ) {
+            d1::small_object_allocator alloc{};
+            pop_task& task = *alloc.new_object<pop_task>(*this, coroutine, alloc);
+            my_ticket = my_queue.my_queue_representation->head_counter++;
+            task.wait_for_item();
+        }
+
+        void await_resume() const {
+            if (my_aborted) {
+                throw_exception(exception_id::user_abort);
+            }
+        }
+
+    private:
+        concurrent_bounded_queue& my_queue;
+        T& my_result;
+        std::ptrdiff_t my_ticket{};
+        unsigned my_abort_counter{};
+        bool my_aborted{false};
+    };
+
+public:
+    // Returns an awaitable that dequeues an item from head of queue.
+    // While the queue is empty, the awaiting coroutine is suspended instead of the thread;
+    // it is resumed as a task in the arena it was suspended in.
+    pop_awaiter async_pop( T& result ) {
+        return pop_awaiter(*this, result);
+    }
+#endif
+
     void abort() {
         internal_abort();
     }
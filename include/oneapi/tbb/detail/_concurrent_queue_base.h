@@ -197,6 +197,12 @@ public:
         return success;
     }
 
+    // Checks if pop of the ticket k does not wait: the item is pushed and the preceding items are popped
+    bool is_ready_to_pop( ticket_type k ) const {
+        k &= -queue_rep_type::n_queue;
+        return head_counter.load(std::memory_order_acquire) == k && tail_counter.load(std::memory_order_acquire) != k;
+    }
+
     micro_queue& assign( const micro_queue& src, queue_allocator_type& allocator,
         item_constructor_type construct_item )
     {
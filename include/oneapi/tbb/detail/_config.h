@@ -283,6 +283,12 @@
     #define __TBB_CPP20_COMPARISONS_PRESENT 0
 #endif
 
+#if defined(__cpp_impl_coroutine) && defined(__cpp_lib_coroutine)
+    #define __TBB_CPP20_COROUTINES_PRESENT ((__cpp_impl_coroutine >= 201902L) && (__cpp_lib_coroutine >= 201902L))
+#else
+    #define __TBB_CPP20_COROUTINES_PRESENT 0
+#endif
+
 #define __TBB_RESUMABLE_TASKS                           (!__TBB_WIN8UI_SUPPORT && !__ANDROID__ && !__QNXNTO__ && (!__linux__ || __GLIBC__))
 
 /* This macro marks incomplete code or comments describing ideas which are considered for the future.
@@ -560,6 +566,38 @@
 #define __TBB_PREVIEW_NUMA_ALLOCATION 1
 #endif
 
+#if TBB_PREVIEW_TASK_ARENA_STATISTICS || __TBB_BUILD || __TBB_TEST_PREVIEW
+#define __TBB_PREVIEW_TASK_ARENA_STATISTICS 1
+#endif
+
+#if TBB_PREVIEW_TASK_ARENA_DEADLINES || __TBB_BUILD || __TBB_TEST_PREVIEW
+#define __TBB_PREVIEW_TASK_ARENA_DEADLINES 1
+#endif
+
+#if TBB_PREVIEW_COROUTINES || __TBB_BUILD || __TBB_TEST_PREVIEW
+#define __TBB_PREVIEW_COROUTINES 1
+#endif
+
+#if TBB_PREVIEW_WORK_FIRST_TASK_GROUP || __TBB_TEST_PREVIEW
+#define __TBB_PREVIEW_WORK_FIRST_TASK_GROUP 1
+#endif
+
+#if TBB_PREVIEW_TASK_ARENA_WEIGHTS || __TBB_BUILD || __TBB_TEST_PREVIEW
+#define __TBB_PREVIEW_TASK_ARENA_WEIGHTS 1
+#endif
+
+#if TBB_PREVIEW_TASK_ARENA_MIN_CONCURRENCY || __TBB_BUILD || __TBB_TEST_PREVIEW
+#define __TBB_PREVIEW_TASK_ARENA_MIN_CONCURRENCY 1
+#endif
+
+#if TBB_PREVIEW_TASK_ARENA_WARM_UP || __TBB_BUILD || __TBB_TEST_PREVIEW
+#define __TBB_PREVIEW_TASK_ARENA_WARM_UP 1
+#endif
+
+#if TBB_PREVIEW_TASK_ARENA_PLACEMENT || __TBB_BUILD || __TBB_TEST_PREVIEW
+#define __TBB_PREVIEW_TASK_ARENA_PLACEMENT 1
+#endif
+
 #if !__TBB_DISABLE_SPEC_EXTENSIONS
 #define TBB_EXT_CUSTOM_ASSERTION_HANDLER 202510
 #endif
@@ -583,8 +621,44 @@
 #define TBB_HAS_TASK_GROUP_WAIT_FOR_SINGLE_TASK 202603
 #endif
 
+#if __TBB_PREVIEW_TASK_GROUP_EXTENSIONS
+#define TBB_HAS_TASK_GROUP_CONTINUATIONS 202610
+#endif
+
 #if __TBB_PREVIEW_NUMA_ALLOCATION
 #define TBB_HAS_NUMA_ALLOCATION 202605
 #endif
 
+#if __TBB_PREVIEW_TASK_ARENA_STATISTICS
+#define TBB_HAS_TASK_ARENA_STATISTICS 202610
+#endif
+
+#if __TBB_PREVIEW_TASK_ARENA_DEADLINES
+#define TBB_HAS_TASK_ARENA_DEADLINES 202610
+#endif
+
+#if __TBB_PREVIEW_COROUTINES && __TBB_CPP20_COROUTINES_PRESENT
+#define TBB_HAS_COROUTINES 202610
+#endif
+
+#if __TBB_PREVIEW_WORK_FIRST_TASK_GROUP
+#define TBB_HAS_WORK_FIRST_TASK_GROUP 202610
+#endif
+
+#if __TBB_PREVIEW_TASK_ARENA_WEIGHTS
+#define TBB_HAS_TASK_ARENA_WEIGHTS 202610
+#endif
+
+#if __TBB_PREVIEW_TASK_ARENA_MIN_CONCURRENCY
+#define TBB_HAS_TASK_ARENA_MIN_CONCURRENCY 202610
+#endif
+
+#if __TBB_PREVIEW_TASK_ARENA_WARM_UP
+#define TBB_HAS_TASK_ARENA_WARM_UP 202610
+#endif
+
+#if __TBB_PREVIEW_TASK_ARENA_PLACEMENT
+#define TBB_HAS_TASK_ARENA_PLACEMENT 202610
+#endif
+
 #endif // __TBB_detail__config_H
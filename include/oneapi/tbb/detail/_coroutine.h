@@ -0,0 +1,107 @@
+/*
+    Copyright (c) 2025 UXL Foundation Contributors
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#ifndef __TBB_detail__coroutine_H
+#define __TBB_detail__coroutine_H
+
+#include "_config.h"
+#include "_task.h"
+#include "_small_object_pool.h"
+
+#if __TBB_PREVIEW_COROUTINES && __TBB_CPP20_COROUTINES_PRESENT
+#include <coroutine>
+#endif
+
+#if __TBB_PREVIEW_COROUTINES
+namespace tbb {
+namespace detail {
+
+namespace d1 {
+class suspended_coroutine;
+}
+
+namespace r1 {
+class arena;
+struct async_wait_impl;
+
+//! C++20 coroutine support entry points
+//! Binds the coroutine to the arena of the calling thread, where it is resumed later
+TBB_EXPORT void __TBB_EXPORTED_FUNC suspend_in_current_arena(d1::suspended_coroutine&);
+//! Resumes the coroutine as a task of the arena it is bound to
+TBB_EXPORT void __TBB_EXPORTED_FUNC resume_in_arena(d1::suspended_coroutine&);
+//! Resumes the coroutine when the wait context is released; returns false if it is released already
+TBB_EXPORT bool __TBB_EXPORTED_FUNC wait_async(d1::wait_context&, d1::suspended_coroutine&);
+} // namespace r1
+
+namespace d1 {
+
+//! The task that resumes a coroutine suspended by an awaitable of the library
+/** The task is enqueued into the arena the coroutine was suspended in, so the suspended
+    coroutine does not occupy a thread or a stack. **/
+class suspended_coroutine : public task {
+protected:
+    //! Set if the awaited operation was aborted instead of completed
+    bool m_aborted{false};
+
+private:
+    r1::arena* m_arena{nullptr};
+
+    friend struct r1::async_wait_impl;
+};
+
+#if __TBB_CPP20_COROUTINES_PRESENT
+class coroutine_resume_task : public suspended_coroutine {
+    std::coroutine_handle<> m_coroutine;
+    small_object_allocator m_allocator;
+
+    task* resume(execution_data& ed) {
+        std::coroutine_handle<> coroutine = m_coroutine;
+        m_allocator.delete_object(this, ed);
+        coroutine.resume();
+        return nullptr;
+    }
+
+    task* execute(execution_data& ed) override {
+        return resume(ed);
+    }
+
+    // The coroutine is resumed even if the context of the arena is cancelled, otherwise it would never complete
+    task* cancel(execution_data& ed) override {
+        return resume(ed);
+    }
+
+public:
+    coroutine_resume_task(std::coroutine_handle<> coroutine, small_object_allocator& alloc)
+        : m_coroutine(coroutine), m_allocator(alloc) {}
+
+    static coroutine_resume_task& allocate(std::coroutine_handle<> coroutine) {
+        small_object_allocator alloc{};
+        return *alloc.new_object<coroutine_resume_task>(coroutine, alloc);
+    }
+
+    //! Destroys the task that was not used to resume the coroutine
+    void release() {
+        m_allocator.delete_object(this);
+    }
+};
+#endif // __TBB_CPP20_COROUTINES_PRESENT
+
+} // namespace d1
+} // namespace detail
+} // namespace tbb
+#endif // __TBB_PREVIEW_COROUTINES
+
+#endif // __TBB_detail__coroutine_H
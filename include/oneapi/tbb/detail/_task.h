@@ -78,6 +78,7 @@ class task_dispatcher;
 class external_waiter;
 struct task_accessor;
 struct task_arena_impl;
+struct async_wait_impl;
 } // namespace r1
 
 namespace d1 {
@@ -137,6 +138,7 @@ class wait_context {
     friend class wait_context_vertex;
     friend struct r1::task_arena_impl;
     friend struct r1::suspend_point_type;
+    friend struct r1::async_wait_impl;
 public:
     // Despite the internal reference count is uin64_t we limit the user interface with uint32_t
     // to preserve a part of the internal reference count for special needs.
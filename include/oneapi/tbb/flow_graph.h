@@ -2840,6 +2840,14 @@ private:
             return my_node->try_put_impl(i);
         }
 
+#if __TBB_PREVIEW_COROUTINES && __TBB_CPP20_COROUTINES_PRESENT
+    private:
+        //! Implements gateway_type::submit_coroutine for an external activity to continue in FG
+        bool submit_coroutine(std::coroutine_handle<> coroutine) override {
+            return my_node->submit_coroutine_impl(coroutine);
+        }
+#endif
+
     private:
         async_node* my_node;
     } my_gateway;
@@ -2847,6 +2855,38 @@ private:
     //The substitute of 'this' for member construction, to prevent compiler warnings
     async_node* self() { return this; }
 
+#if __TBB_PREVIEW_COROUTINES && __TBB_CPP20_COROUTINES_PRESENT
+    //! A task that resumes the coroutine of an external activity in the graph arena
+    class coroutine_resume_task : public graph_task {
+        std::coroutine_handle<> my_coroutine;
+    public:
+        coroutine_resume_task(graph& g, d1::small_object_allocator& allocator, std::coroutine_handle<> coroutine)
+            : graph_task(g, allocator), my_coroutine(coroutine) {}
+
+        // The task keeps the graph reserved until the coroutine is suspended again or completed
+        d1::task* execute(d1::execution_data& ed) override {
+            my_coroutine.resume();
+            finalize<coroutine_resume_task>(ed);
+            return nullptr;
+        }
+
+        // The coroutine is resumed even if the graph is cancelled, otherwise it would never complete
+        d1::task* cancel(d1::execution_data& ed) override {
+            return execute(ed);
+        }
+    };
+
+    bool submit_coroutine_impl(std::coroutine_handle<> coroutine) {
+        if (!is_graph_active(this->my_graph)) {
+            return false;
+        }
+        d1::small_object_allocator allocator{};
+        graph_task* t = allocator.new_object<coroutine_resume_task>(this->my_graph, allocator, coroutine);
+        enqueue_in_graph_arena(this->my_graph, *t);
+        return true;
+    }
+#endif
+
     //! Implements gateway_type::try_put for an external activity to submit a message to FG
     bool try_put_impl(const Output &i) {
         multifunction_output<Output> &port_0 = output_port<0>(*this);
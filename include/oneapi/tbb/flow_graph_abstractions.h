@@ -17,6 +17,12 @@
 #ifndef __TBB_flow_graph_abstractions_H
 #define __TBB_flow_graph_abstractions_H
 
+#include "detail/_config.h"
+
+#if __TBB_PREVIEW_COROUTINES && __TBB_CPP20_COROUTINES_PRESENT
+#include <coroutine>
+#endif
+
 namespace tbb {
 namespace detail {
 namespace d2 {
@@ -41,6 +47,32 @@ public:
 
     //! Submit signal from an asynchronous activity to FG.
     virtual bool try_put(const input_type&) = 0;
+
+#if __TBB_PREVIEW_COROUTINES && __TBB_CPP20_COROUTINES_PRESENT
+    class graph_awaiter {
+    public:
+        graph_awaiter(receiver_gateway& gateway) : my_gateway(gateway) {}
+
+        bool await_ready() const { return false; }
+
+        //! The coroutine is not suspended if the graph is not active
+        bool await_suspend(std::coroutine_handle<> coroutine) {
+            return my_gateway.submit_coroutine(coroutine);
+        }
+
+        void await_resume() const {}
+
+    private:
+        receiver_gateway& my_gateway;
+    };
+
+    //! Returns an awaitable that resumes the coroutine of an asynchronous activity as a task of FG
+    graph_awaiter resume_in_graph() { return graph_awaiter(*this); }
+
+private:
+    //! Submit a task resuming the coroutine to FG; returns false if FG is not active.
+    virtual bool submit_coroutine(std::coroutine_handle<>) = 0;
+#endif
 };
 
 } // d2
@@ -67,6 +67,7 @@ public:
         terminate_on_exception,
         scheduler_handle, // not a public parameter
         leave_policy,
+        worker_retention_limit,
         parameter_max // insert new parameters above this point
     };
 
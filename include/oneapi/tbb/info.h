@@ -35,6 +35,18 @@ namespace d1{
 using numa_node_id = int;
 using core_type_id = int;
 
+//! Policies of pinning the threads of an arena to the processing units allowed by its constraints
+enum class placement_policy : int {
+    //! The threads are not pinned beyond the constraints
+    none     = 0,
+    //! Slots are pinned to consecutive processing units, so the threads share cores and caches
+    compact  = 1,
+    //! Consecutive slots are pinned to different packages, and to different cores within a package
+    scatter  = 2,
+    //! Each slot is pinned to a distinct physical core
+    per_core = 3
+};
+
 // TODO: consider version approach to resolve backward compatibility potential issues.
 struct constraints {
 #if !__TBB_CPP20_PRESENT
@@ -60,11 +72,43 @@ struct constraints {
         max_threads_per_core = threads_number;
         return *this;
     }
+#if __TBB_PREVIEW_TASK_ARENA_WEIGHTS
+    //! Sets the relative share of workers the arena gets when arenas of its priority compete for them
+    constraints& set_weight(int arena_weight) {
+        weight = arena_weight;
+        return *this;
+    }
+#endif
+#if __TBB_PREVIEW_TASK_ARENA_MIN_CONCURRENCY
+    //! Sets the number of threads the arena is guaranteed to have while it has work
+    constraints& set_min_concurrency(int minimal_concurrency) {
+        min_concurrency = minimal_concurrency;
+        return *this;
+    }
+#endif
+#if __TBB_PREVIEW_TASK_ARENA_PLACEMENT
+    //! Sets the policy of pinning the threads of the arena to the processing units
+    constraints& set_placement(placement_policy policy) {
+        placement = policy;
+        return *this;
+    }
+#endif
 
     numa_node_id numa_id = -1;
     int max_concurrency = -1;
     core_type_id core_type = -1;
     int max_threads_per_core = -1;
+    // The library reads only the fields above from the constraints passed to it,
+    // so the preview fields below do not change its view of the structure
+#if __TBB_PREVIEW_TASK_ARENA_WEIGHTS
+    int weight = -1;
+#endif
+#if __TBB_PREVIEW_TASK_ARENA_MIN_CONCURRENCY
+    int min_concurrency = -1;
+#endif
+#if __TBB_PREVIEW_TASK_ARENA_PLACEMENT
+    placement_policy placement = placement_policy::none;
+#endif
 };
 
 } // namespace d1
@@ -103,6 +147,12 @@ inline std::vector<core_type_id> core_types() {
 
 inline int default_concurrency(constraints c) {
     if (c.max_concurrency > 0) { return c.max_concurrency; }
+#if __TBB_PREVIEW_TASK_ARENA_PLACEMENT
+    if (c.placement == placement_policy::per_core && c.max_threads_per_core < 1) {
+        // One thread per core
+        c.max_threads_per_core = 1;
+    }
+#endif
     return r1::constraints_default_concurrency(c);
 }
 
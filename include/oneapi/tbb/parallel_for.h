@@ -97,7 +97,7 @@ struct start_for : public task {
         my_partition.align_depth( d );
     }
     static void run(const Range& range, const Body& body, Partitioner& partitioner) {
-        task_group_context context(PARALLEL_FOR);
+        task_group_context context(PARALLEL_FOR, scoped_context_tag{});
         run(range, body, partitioner, context);
     }
 
@@ -661,7 +661,7 @@ void run_parallel_for_each( Iterator first, Iterator last, const Body& body, tas
 template<typename Iterator, typename Body>
     __TBB_requires(std::input_iterator<Iterator> && parallel_for_each_iterator_body<Body, Iterator>)
 void parallel_for_each(Iterator first, Iterator last, const Body& body) {
-    task_group_context context(PARALLEL_FOR_EACH);
+    task_group_context context(PARALLEL_FOR_EACH, scoped_context_tag{});
     run_parallel_for_each<Iterator, Body>(first, last, body, context);
 }
 
@@ -188,7 +188,7 @@ void parallel_invoke_impl(task_group_context& context, const Fs&... fs) {
 template<typename F1, typename... Fs>
 void parallel_invoke_impl(const F1& f1, const Fs&... fs) {
     static_assert(sizeof...(Fs) >= 1, "Parallel invoke may be called with at least two callable");
-    task_group_context context(PARALLEL_INVOKE);
+    task_group_context context(PARALLEL_INVOKE, scoped_context_tag{});
     wait_context root_wait_ctx{0};
 
     invoke_recursive_separation(root_wait_ctx, context, fs..., f1);
@@ -147,7 +147,7 @@ struct start_reduce : public task {
     static void run(const Range& range, Body& body, Partitioner& partitioner) {
         // Bound context prevents exceptions from body to affect nesting or sibling algorithms,
         // and allows users to handle exceptions safely by wrapping parallel_reduce in the try-block.
-        task_group_context context(PARALLEL_REDUCE);
+        task_group_context context(PARALLEL_REDUCE, scoped_context_tag{});
         run(range, body, partitioner, context);
     }
     //! Run body for range, serves as callback for partitioner
@@ -293,7 +293,7 @@ struct start_deterministic_reduce : public task {
         // Bound context prevents exceptions from body to affect nesting or sibling algorithms,
         // and allows users to handle exceptions safely by wrapping parallel_deterministic_reduce
         // in the try-block.
-        task_group_context context(PARALLEL_REDUCE);
+        task_group_context context(PARALLEL_REDUCE, scoped_context_tag{});
         run(range, body, partitioner, context);
     }
     //! Run body for range, serves as callback for partitioner
@@ -424,7 +424,7 @@ public:
 
     static void run( const Range& range, Body& body, const Partitioner& partitioner ) {
         if( !range.empty() ) {
-            task_group_context context(PARALLEL_SCAN);
+            task_group_context context(PARALLEL_SCAN, scoped_context_tag{});
 
             using start_pass1_type = start_scan<Range,Body,Partitioner>;
             sum_node_type* root = nullptr;
@@ -184,7 +184,7 @@ void do_parallel_quick_sort( RandomAccessIterator begin, RandomAccessIterator en
 /** @ingroup algorithms */
 template<typename RandomAccessIterator, typename Compare>
 void parallel_quick_sort( RandomAccessIterator begin, RandomAccessIterator end, const Compare& comp ) {
-    task_group_context my_context(PARALLEL_SORT);
+    task_group_context my_context(PARALLEL_SORT, scoped_context_tag{});
     constexpr int serial_cutoff = 9;
 
     __TBB_ASSERT( begin + serial_cutoff < end, "min_parallel_size is smaller than serial cutoff?" );
@@ -32,7 +32,15 @@
 #include "info.h"
 #include "task_group.h"
 
+#if __TBB_PREVIEW_COROUTINES && __TBB_CPP20_COROUTINES_PRESENT
+#include "detail/_coroutine.h"
+#include <exception>
+#endif
+
 #include <vector>
+#if __TBB_PREVIEW_TASK_ARENA_DEADLINES
+#include <chrono>
+#endif
 
 namespace tbb {
 namespace detail {
@@ -79,6 +87,9 @@ public:
 
 class task_arena_base;
 class task_scheduler_observer;
+#if __TBB_PREVIEW_TASK_ARENA_STATISTICS
+struct task_arena_statistics;
+#endif
 } // namespace d1
 
 namespace r1 {
@@ -103,6 +114,16 @@ TBB_EXPORT void __TBB_EXPORTED_FUNC exit_parallel_phase(d1::task_arena_base*, st
 
 // Maintained for backwards compatibility
 TBB_EXPORT d1::slot_id __TBB_EXPORTED_FUNC execution_slot(const d1::task_arena_base&);
+
+#if __TBB_PREVIEW_TASK_ARENA_STATISTICS
+TBB_EXPORT void __TBB_EXPORTED_FUNC get_statistics(const d1::task_arena_base*, d1::task_arena_statistics&);
+#endif
+#if __TBB_PREVIEW_TASK_ARENA_DEADLINES
+TBB_EXPORT void __TBB_EXPORTED_FUNC enqueue_with_deadline(d1::task&, d1::task_group_context*, d1::task_arena_base*, std::int64_t);
+#endif
+#if __TBB_PREVIEW_TASK_ARENA_WARM_UP
+TBB_EXPORT void __TBB_EXPORTED_FUNC warm_up(d1::task_arena_base&);
+#endif
 } // namespace r1
 
 namespace d2 {
@@ -120,6 +141,23 @@ inline void enqueue_impl(task_handle&& th, d1::task_arena_base* ta) {
 #endif
     r1::enqueue(*task_ptr, ctx, ta);
 }
+
+#if __TBB_PREVIEW_TASK_ARENA_DEADLINES
+inline void enqueue_impl(task_handle&& th, d1::task_arena_base* ta, std::int64_t deadline) {
+    __TBB_ASSERT(th != nullptr, "Attempt to schedule empty task_handle");
+
+    auto& ctx = task_handle_accessor::ctx_of(th);
+
+    // Do not access th after release
+    task_handle_task* task_ptr = task_handle_accessor::release(th);
+#if __TBB_PREVIEW_TASK_GROUP_EXTENSIONS
+    if (task_ptr->has_dependencies() && !task_ptr->release_dependency()) {
+        return;
+    }
+#endif
+    r1::enqueue_with_deadline(*task_ptr, &ctx, ta, deadline);
+}
+#endif
 } //namespace d2
 
 namespace d1 {
@@ -127,6 +165,147 @@ namespace d1 {
 __TBB_GLOBAL_VAR constexpr unsigned num_priority_levels = 3;
 __TBB_GLOBAL_VAR constexpr int priority_stride = INT_MAX / (num_priority_levels + 1);
 
+#if __TBB_PREVIEW_TASK_ARENA_STATISTICS
+//! Snapshot of the scheduler counters accumulated by an arena since its creation
+struct task_arena_statistics {
+    //! Distance between the thief and the victim of a steal in the hardware topology
+    enum locality_level : unsigned {
+        same_core,
+        same_cache,
+        same_numa_node,
+        //! Different NUMA nodes or the location is unknown
+        system,
+        locality_levels_count
+    };
+
+    //! The number of tasks stolen from victims at each distance
+    std::uint64_t steals_by_locality[locality_levels_count]{};
+
+    //! The number of tasks moved together with stolen tasks by batch stealing
+    /** Each of them would otherwise require a separate steal. **/
+    std::uint64_t steals_saved_by_batching{};
+
+    //! The number of tasks spawned by the threads of the arena
+    std::uint64_t spawned_tasks{};
+    //! The number of tasks executed in the arena
+    std::uint64_t executed_tasks{};
+    //! The number of tasks stolen at any distance
+    std::uint64_t stolen_tasks{};
+    //! The number of steal attempts that did not bring a task
+    std::uint64_t failed_steals{};
+    //! The number of tasks received via mailboxes, i.e. executed by the thread they have affinity to
+    std::uint64_t mailbox_tasks{};
+    //! The number of tasks put into the queue of the arena
+    std::uint64_t enqueued_tasks{};
+    //! The number of times worker threads joined the arena
+    std::uint64_t worker_joins{};
+    //! The number of times worker threads left the arena
+    std::uint64_t worker_leaves{};
+    //! The number of times worker threads joined the arena directly after leaving another arena
+    /** Other joins are by the workers woken up or started by the resource manager. **/
+    std::uint64_t worker_handoffs{};
+    //! The number of times threads in the arena blocked waiting for work
+    std::uint64_t sleeps{};
+    //! The number of times new work in the arena caused a request for threads
+    std::uint64_t wakeups{};
+    //! The number of suspend points of resumable tasks taken from the cache of the arena
+    std::uint64_t reused_suspend_points{};
+    //! The number of suspend points created since the cache of the arena was empty
+    std::uint64_t created_suspend_points{};
+    //! The number of coroutine stacks taken from the pool of the process instead of being mapped
+    /** The pool is shared by all arenas, so the stack counters are process-wide. **/
+    std::uint64_t reused_stacks{};
+    //! The number of coroutine stacks mapped by the process
+    std::uint64_t mapped_stacks{};
+    //! The number of workers the arena is allotted by the scheduler at the moment
+    std::uint64_t allotted_workers{};
+    //! The CPU time in nanoseconds consumed by the threads while they were in the arena
+    /** Accounted if the TBB_ARENA_CPU_TIME environment variable is set. The time of a thread is
+        charged when it leaves the arena, and the time of the calling thread when it collects
+        the statistics. **/
+    std::uint64_t cpu_time_ns{};
+
+    //! Histogram of time intervals in nanoseconds, in the spirit of HdrHistogram
+    /** Each power-of-two range of values is split into sub_buckets_count buckets of equal width,
+        so the value is known with the relative error below 1 / sub_buckets_count. **/
+    struct latency_histogram {
+        static constexpr unsigned sub_bucket_bits = 3;
+        static constexpr unsigned sub_buckets_count = 1u << sub_bucket_bits;
+        //! The number of power-of-two ranges above the first sub_buckets_count values
+        /** Larger values are counted in the last bucket. **/
+        static constexpr unsigned ranges_count = 40;
+        static constexpr unsigned buckets_count = (ranges_count + 1) * sub_buckets_count;
+
+        std::uint64_t counts[buckets_count]{};
+
+        //! Returns the index of the bucket that counts the value
+        static unsigned bucket_index(std::uint64_t value) {
+            if (value < sub_buckets_count) {
+                return unsigned(value);
+            }
+            unsigned msb = 0;
+            for (unsigned step = 32; step != 0; step /= 2) {
+                if (value >> msb >> step) {
+                    msb += step;
+                }
+            }
+            unsigned shift = msb - sub_bucket_bits;
+            if (shift >= ranges_count) {
+                return buckets_count - 1;
+            }
+            return (shift + 1) * sub_buckets_count + unsigned(value >> shift) - sub_buckets_count;
+        }
+
+        //! Returns the smallest value counted in the bucket
+        static std::uint64_t bucket_lower_bound(unsigned index) {
+            if (index < sub_buckets_count) {
+                return index;
+            }
+            unsigned shift = index / sub_buckets_count - 1;
+            return std::uint64_t(sub_buckets_count + index % sub_buckets_count) << shift;
+        }
+
+        std::uint64_t total_count() const {
+            std::uint64_t total = 0;
+            for (std::uint64_t c : counts) {
+                total += c;
+            }
+            return total;
+        }
+
+        //! Returns the lower bound of the bucket where the given fraction (0..1] of the values is reached
+        std::uint64_t percentile(double fraction) const {
+            std::uint64_t total = total_count();
+            std::uint64_t rank = std::uint64_t(fraction * double(total) + 0.5);
+            rank = rank == 0 ? 1 : rank;
+            std::uint64_t accumulated = 0;
+            for (unsigned i = 0; i < buckets_count; ++i) {
+                accumulated += counts[i];
+                if (accumulated >= rank) {
+                    return bucket_lower_bound(i);
+                }
+            }
+            return 0;
+        }
+
+        //! Adds the values of another histogram, e.g. of another arena with the same priority
+        void merge(const latency_histogram& other) {
+            for (unsigned i = 0; i < buckets_count; ++i) {
+                counts[i] += other.counts[i];
+            }
+        }
+    };
+
+    //! Time from enqueueing a task into the arena to the start of its execution
+    /** Collected only if the TBB_ENQUEUE_LATENCY environment variable is set. **/
+    latency_histogram enqueue_latency{};
+
+    //! Time from a worker leaving its previous arena to joining this arena
+    /** Collected only if the TBB_MIGRATION_LATENCY environment variable is set. **/
+    latency_histogram migration_latency{};
+};
+#endif
+
 class task_arena_base {
     friend struct r1::task_arena_impl;
     friend void r1::observe(d1::task_scheduler_observer&, bool);
@@ -143,6 +322,9 @@ public:
     };
 
     using constraints = tbb::detail::d1::constraints;
+#if __TBB_PREVIEW_TASK_ARENA_PLACEMENT
+    using placement_policy = tbb::detail::d1::placement_policy;
+#endif
 protected:
     //! Special settings
     intptr_t my_version_and_traits;
@@ -172,6 +354,15 @@ protected:
     //! Number of threads per core
     int my_max_threads_per_core;
 
+    //! The relative share of workers under contention with arenas of the same priority
+    int my_weight;
+
+    //! The number of threads the arena is guaranteed to have while it has work
+    int my_min_concurrency;
+
+    //! The policy of pinning the threads of the arena to the processing units
+    d1::placement_policy my_placement;
+
     // Backward compatibility checks.
     core_type_id core_type() const {
         return (my_version_and_traits & core_type_support_flag) == core_type_support_flag ? my_core_type : automatic;
@@ -180,6 +371,18 @@ protected:
         return (my_version_and_traits & core_type_support_flag) == core_type_support_flag ? my_max_threads_per_core : automatic;
     }
 
+    int weight() const {
+        return (my_version_and_traits & weight_support_flag) == weight_support_flag ? my_weight : automatic;
+    }
+
+    int min_concurrency() const {
+        return (my_version_and_traits & min_concurrency_support_flag) == min_concurrency_support_flag ? my_min_concurrency : automatic;
+    }
+
+    d1::placement_policy placement() const {
+        return (my_version_and_traits & placement_support_flag) == placement_support_flag ? my_placement : d1::placement_policy::none;
+    }
+
     leave_policy get_leave_policy() const {
         return (my_version_and_traits & fast_leave_policy_flag) ? leave_policy::fast : leave_policy::automatic;
     }
@@ -194,14 +397,18 @@ protected:
     }
 
     enum {
-        default_flags               = 0,
-        core_type_support_flag      = 1,
-        fast_leave_policy_flag      = 1 << 1
+        default_flags                = 0,
+        core_type_support_flag       = 1,
+        fast_leave_policy_flag       = 1 << 1,
+        weight_support_flag          = 1 << 2,
+        min_concurrency_support_flag = 1 << 3,
+        placement_support_flag       = 1 << 4
     };
 
     task_arena_base(int max_concurrency, unsigned reserved_slots, priority a_priority , leave_policy lp
     )
-        : my_version_and_traits(default_flags | core_type_support_flag | leave_policy_trait(lp)
+        : my_version_and_traits(default_flags | core_type_support_flag | weight_support_flag | min_concurrency_support_flag
+                                | placement_support_flag | leave_policy_trait(lp)
         )
         , my_initialization_state(do_once_state::uninitialized)
         , my_arena(nullptr)
@@ -211,11 +418,15 @@ protected:
         , my_numa_id(automatic)
         , my_core_type(automatic)
         , my_max_threads_per_core(automatic)
+        , my_weight(automatic)
+        , my_min_concurrency(automatic)
+        , my_placement(d1::placement_policy::none)
         {}
 
     task_arena_base(const constraints& constraints_, unsigned reserved_slots, priority a_priority, leave_policy lp
     )
-        : my_version_and_traits(default_flags | core_type_support_flag  | leave_policy_trait(lp)
+        : my_version_and_traits(default_flags | core_type_support_flag | weight_support_flag | min_concurrency_support_flag
+                                | placement_support_flag | leave_policy_trait(lp)
                 )
         , my_initialization_state(do_once_state::uninitialized)
         , my_arena(nullptr)
@@ -225,7 +436,26 @@ protected:
         , my_numa_id(constraints_.numa_id)
         , my_core_type(constraints_.core_type)
         , my_max_threads_per_core(constraints_.max_threads_per_core)
-        {}
+        , my_weight(automatic)
+        , my_min_concurrency(automatic)
+        , my_placement(d1::placement_policy::none)
+    {
+        copy_preview_constraints(constraints_);
+    }
+
+    //! Copies the fields of constraints that exist only if the corresponding preview is enabled
+    void copy_preview_constraints(const constraints& constraints_) {
+        suppress_unused_warning(constraints_);
+#if __TBB_PREVIEW_TASK_ARENA_WEIGHTS
+        my_weight = constraints_.weight;
+#endif
+#if __TBB_PREVIEW_TASK_ARENA_MIN_CONCURRENCY
+        my_min_concurrency = constraints_.min_concurrency;
+#endif
+#if __TBB_PREVIEW_TASK_ARENA_PLACEMENT
+        my_placement = constraints_.placement;
+#endif
+    }
 
 public:
     //! Typedef for number of threads that is automatic.
@@ -272,6 +502,20 @@ void enqueue_impl(F&& f, task_arena_base* ta) {
     small_object_allocator alloc{};
     r1::enqueue(*alloc.new_object<enqueue_task<typename std::decay<F>::type>>(std::forward<F>(f), alloc), ta);
 }
+
+#if __TBB_PREVIEW_TASK_ARENA_DEADLINES
+//! The deadline passed to the library: nanoseconds since the epoch of std::chrono::steady_clock
+inline std::int64_t deadline_to_nanoseconds(std::chrono::steady_clock::time_point deadline) {
+    return std::int64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(deadline.time_since_epoch()).count());
+}
+
+template<typename F>
+void enqueue_impl(F&& f, task_arena_base* ta, std::chrono::steady_clock::time_point deadline) {
+    small_object_allocator alloc{};
+    r1::enqueue_with_deadline(*alloc.new_object<enqueue_task<typename std::decay<F>::type>>(std::forward<F>(f), alloc),
+                              nullptr, ta, deadline_to_nanoseconds(deadline));
+}
+#endif
 /** 1-to-1 proxy representation class of scheduler's arena
  * Constructors set up settings only, real construction is deferred till the first method invocation
  * Destructor only removes one of the references to the inner arena representation.
@@ -358,7 +602,11 @@ public:
             , a.my_num_reserved_slots, a.my_priority, a.get_leave_policy()
         )
 
-    {}
+    {
+        my_weight = a.my_weight;
+        my_min_concurrency = a.my_min_concurrency;
+        my_placement = a.my_placement;
+    }
 
     //! Tag class used to indicate the "attaching" constructor
     struct attach {};
@@ -407,6 +655,7 @@ public:
             my_max_concurrency = constraints_.max_concurrency;
             my_core_type = constraints_.core_type;
             my_max_threads_per_core = constraints_.max_threads_per_core;
+            copy_preview_constraints(constraints_);
             my_num_reserved_slots = reserved_slots;
             my_priority = a_priority;
             set_leave_policy(lp);
@@ -429,6 +678,7 @@ public:
             my_max_concurrency = constraints_.max_concurrency;
             my_core_type = constraints_.core_type;
             my_max_threads_per_core = constraints_.max_threads_per_core;
+            copy_preview_constraints(constraints_);
             my_num_reserved_slots = reserved_for_masters;
             my_priority = a_priority;
             set_leave_policy(lp);
@@ -504,6 +754,26 @@ public:
         d2::enqueue_impl(tg.defer(std::forward<F>(f)), this);
     }
 
+#if __TBB_PREVIEW_TASK_ARENA_DEADLINES
+    //! Enqueues a task into the arena to process a functor, and immediately returns.
+    //! The arena takes the tasks enqueued with deadlines in the order of their deadlines,
+    //! before the tasks enqueued without a deadline.
+    //! Does not require the calling thread to join the arena
+    template<typename F>
+    void enqueue(F&& f, std::chrono::steady_clock::time_point deadline) {
+        initialize();
+        enqueue_impl(std::forward<F>(f), this, deadline);
+    }
+
+    //! Enqueues a task wrapped in task_handle into the arena to be taken in the order of deadlines,
+    //! and immediately returns.
+    //! Does not require the calling thread to join the arena
+    void enqueue(d2::task_handle&& th, std::chrono::steady_clock::time_point deadline) {
+        initialize();
+        d2::enqueue_impl(std::move(th), this, deadline_to_nanoseconds(deadline));
+    }
+#endif
+
     //! Waits for all tasks in the task group to complete or be canceled.
     //! During the wait, may execute tasks in the task_arena.
     d2::task_group_status wait_for(d2::task_group& tg) {
@@ -527,6 +797,73 @@ public:
         return execute_impl<decltype(f())>(f);
     }
 
+#if __TBB_PREVIEW_COROUTINES && __TBB_CPP20_COROUTINES_PRESENT
+private:
+    template<typename F, typename R>
+    class execute_awaiter {
+    public:
+        template<typename Func>
+        execute_awaiter(task_arena& arena, Func&& f)
+            : m_arena(arena), m_func(std::forward<Func>(f)), m_delegate(m_func) {}
+
+        // The awaiter is referenced by the enqueued task, so it is neither copied nor moved
+        execute_awaiter(const execute_awaiter&) = delete;
+        execute_awaiter& operator=(const execute_awaiter&) = delete;
+
+        bool await_ready() const {
+            return false;
+        }
+
+        void await_suspend(std::coroutine_handle<> coroutine) {
+            m_arena.initialize();
+            d1::coroutine_resume_task& resume_task = d1::coroutine_resume_task::allocate(coroutine);
+            r1::suspend_in_current_arena(resume_task);
+            execute_awaiter* self = this;
+            // The coroutine can be resumed and the awaiter destroyed right after resume_in_arena,
+            // so neither the task nor the suspending thread accesses the awaiter afterwards
+            enqueue_impl([self, &resume_task] {
+                self->run();
+                r1::resume_in_arena(resume_task);
+            }, &m_arena);
+        }
+
+        R await_resume() {
+            if (m_exception) {
+                std::rethrow_exception(m_exception);
+            }
+            return m_delegate.consume_result();
+        }
+
+    private:
+        void run() {
+            const delegate_base& delegate = m_delegate;
+#if TBB_USE_EXCEPTIONS
+            try {
+                delegate();
+            } catch (...) {
+                m_exception = std::current_exception();
+            }
+#else
+            delegate();
+#endif
+        }
+
+        task_arena& m_arena;
+        F m_func;
+        task_arena_function<F, R> m_delegate;
+        std::exception_ptr m_exception;
+    };
+
+public:
+    //! Returns an awaitable that executes a functor in the arena and returns its result
+    /** The functor is enqueued into the arena instead of the calling thread joining it. The awaiting
+        coroutine is suspended meanwhile and then resumed as a task in the arena it was suspended in. */
+    template<typename F>
+    auto async_execute(F&& f) -> execute_awaiter<typename std::decay<F>::type, decltype(f())> {
+        return execute_awaiter<typename std::decay<F>::type, decltype(f())>(*this, std::forward<F>(f));
+    }
+#endif
+
     class parallel_phase : no_copy {
     public:
         class flags {
@@ -622,6 +959,47 @@ public:
         return (my_max_concurrency > 1) ? my_max_concurrency : r1::max_concurrency(this);
     }
 
+#if __TBB_PREVIEW_TASK_ARENA_WEIGHTS
+    //! Returns the weight of the arena or automatic if it is not set
+    int weight() const {
+        return task_arena_base::weight();
+    }
+#endif
+
+#if __TBB_PREVIEW_TASK_ARENA_MIN_CONCURRENCY
+    //! Returns the number of threads the arena is guaranteed to have or automatic if it is not set
+    int min_concurrency() const {
+        return task_arena_base::min_concurrency();
+    }
+#endif
+
+#if __TBB_PREVIEW_TASK_ARENA_PLACEMENT
+    //! Returns the policy of pinning the threads of the arena to the processing units
+    placement_policy placement() const {
+        return task_arena_base::placement();
+    }
+#endif
+
+#if __TBB_PREVIEW_TASK_ARENA_STATISTICS
+    //! Returns the snapshot of the scheduler counters of the arena
+    task_arena_statistics get_statistics() {
+        initialize();
+        task_arena_statistics statistics;
+        r1::get_statistics(this, statistics);
+        return statistics;
+    }
+#endif
+
+#if __TBB_PREVIEW_TASK_ARENA_WARM_UP
+    //! Brings the workers the arena can have into the arena and returns when they are ready to execute tasks
+    /** The calling thread does not join the arena. Returns immediately if the calling thread
+        is already in the arena. **/
+    void warm_up() {
+        initialize();
+        r1::warm_up(*this);
+    }
+#endif
+
     friend void submit(task& t, task_arena& ta, task_group_context& ctx, bool as_critical) {
         __TBB_ASSERT(ta.is_active(), nullptr);
         call_itt_task_notify(releasing, &t);
@@ -653,6 +1031,15 @@ inline int max_concurrency() {
     return r1::max_concurrency(nullptr);
 }
 
+#if __TBB_PREVIEW_TASK_ARENA_STATISTICS
+//! Returns the snapshot of the scheduler counters of the current arena
+inline task_arena_statistics get_statistics() {
+    task_arena_statistics statistics;
+    r1::get_statistics(nullptr, statistics);
+    return statistics;
+}
+#endif
+
 inline void enqueue(d2::task_handle&& th) {
     d2::enqueue_impl(std::move(th), nullptr);
 }
@@ -667,6 +1054,17 @@ inline void enqueue(F&& f, d2::task_group& tg) {
     d2::enqueue_impl(tg.defer(std::forward<F>(f)), nullptr);
 }
 
+#if __TBB_PREVIEW_TASK_ARENA_DEADLINES
+template<typename F>
+inline void enqueue(F&& f, std::chrono::steady_clock::time_point deadline) {
+    enqueue_impl(std::forward<F>(f), nullptr, deadline);
+}
+
+inline void enqueue(d2::task_handle&& th, std::chrono::steady_clock::time_point deadline) {
+    d2::enqueue_impl(std::move(th), nullptr, deadline_to_nanoseconds(deadline));
+}
+#endif
+
 inline void start_parallel_phase(task_arena::parallel_phase::flags f = {}) {
     r1::enter_parallel_phase(nullptr, static_cast<std::uintptr_t>(f.my_start_flags));
 }
@@ -701,10 +1099,17 @@ using detail::d1::create_numa_task_arenas;
 using detail::d1::is_inside_task;
 #endif
 
+#if __TBB_PREVIEW_TASK_ARENA_STATISTICS
+using detail::d1::task_arena_statistics;
+#endif
+
 namespace this_task_arena {
 using detail::d1::current_thread_index;
 using detail::d1::max_concurrency;
 using detail::d1::isolate;
+#if __TBB_PREVIEW_TASK_ARENA_STATISTICS
+using detail::d1::get_statistics;
+#endif
 
 using detail::d1::enqueue;
 
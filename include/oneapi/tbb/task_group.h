@@ -28,9 +28,15 @@
 #include "detail/_small_object_pool.h"
 #include "detail/_intrusive_list_node.h"
 #include "detail/_task_handle.h"
+#include "detail/_aligned_space.h"
+#if __TBB_PREVIEW_COROUTINES
+#include "detail/_coroutine.h"
+#endif
 
 #include "profiling.h"
 
+#include <atomic>
+#include <new>
 #include <type_traits>
 
 #if _MSC_VER && !defined(__INTEL_COMPILER)
@@ -46,12 +52,14 @@ namespace d1 {
 class delegate_base;
 class task_arena_base;
 class task_group_context;
+
+//! Selects the constructor of the context of a oneTBB algorithm that is destroyed before the algorithm returns
+struct scoped_context_tag {};
 }
 
 namespace r1 {
 // Forward declarations
 class tbb_exception_ptr;
-class cancellation_disseminator;
 class thread_data;
 class task_dispatcher;
 template <bool>
@@ -78,10 +86,89 @@ namespace d2 {
 template<typename F>
 d1::task* task_ptr_or_nullptr(F&& f);
 
+#if __TBB_PREVIEW_TASK_GROUP_EXTENSIONS
+//! The next step returned from a task body of type F.
+/** The step is executed in the storage of the completing task without allocating and spawning a new task. */
+template<typename F>
+class task_continuation {
+    static_assert(std::is_nothrow_move_constructible<F>::value,
+                  "The body of the continuation should be nothrow move constructible");
+public:
+    //! Constructs the continuation without the next step
+    task_continuation() noexcept = default;
+
+    task_continuation(F&& f) noexcept : m_has_body(true) {
+        new (m_body.begin()) F(std::move(f));
+    }
+
+    task_continuation(const F& f) : m_has_body(true) {
+        new (m_body.begin()) F(f);
+    }
+
+    task_continuation(task_continuation&& other) noexcept : m_has_body(other.m_has_body) {
+        if (m_has_body) {
+            new (m_body.begin()) F(std::move(*other.m_body.begin()));
+        }
+    }
+
+    task_continuation& operator=(task_continuation&& other) noexcept {
+        if (this != &other) {
+            reset();
+            if (other.m_has_body) {
+                new (m_body.begin()) F(std::move(*other.m_body.begin()));
+                m_has_body = true;
+            }
+        }
+        return *this;
+    }
+
+    ~task_continuation() {
+        reset();
+    }
+
+    explicit operator bool() const noexcept {
+        return m_has_body;
+    }
+
+    //! The body of the next step
+    F& body() noexcept {
+        __TBB_ASSERT(m_has_body, "The continuation has no next step");
+        return *m_body.begin();
+    }
+
+private:
+    void reset() noexcept {
+        if (m_has_body) {
+            m_body.begin()->~F();
+            m_has_body = false;
+        }
+    }
+
+    aligned_space<F> m_body;
+    bool m_has_body{false};
+};
+
+template<typename F>
+task_continuation<typename std::decay<F>::type> continue_with(F&& f) {
+    return task_continuation<typename std::decay<F>::type>(std::forward<F>(f));
+}
+
+template<typename T>
+struct is_task_continuation : std::false_type {};
+
+template<typename F>
+struct is_task_continuation<task_continuation<F>> : std::true_type {};
+#endif // __TBB_PREVIEW_TASK_GROUP_EXTENSIONS
+
 template<typename F>
 class function_task : public task_handle_task  {
     //TODO: apply empty base optimization here
+#if __TBB_PREVIEW_TASK_GROUP_EXTENSIONS
+    // Not const since the body is replaced by the continuation returned from it
+    F m_func;
+#else
     const F m_func;
+#endif
 
 private:
     static void destroy_function_task(task_handle_task* p, d1::small_object_allocator& alloc,
@@ -94,10 +181,35 @@ private:
         }
     }
 
+#if __TBB_PREVIEW_TASK_GROUP_EXTENSIONS
     d1::task* execute(d1::execution_data& ed) override {
         __TBB_ASSERT(ed.context == &this->ctx(), "The task group context should be used for all tasks");
-        task* next_task = task_ptr_or_nullptr(m_func);
-#if __TBB_PREVIEW_TASK_GROUP_EXTENSIONS
+        using body_result_type = decltype(std::declval<const F&>()());
+        return execute_body(ed, is_task_continuation<body_result_type>{});
+    }
+
+    // The body returns the next step to execute in place of this task
+    d1::task* execute_body(d1::execution_data& ed, std::true_type) {
+        using continuation_type = decltype(std::declval<const F&>()());
+        static_assert(std::is_same<continuation_type, task_continuation<F>>::value,
+                      "The continuation should have the type of the task body");
+
+        continuation_type next = static_cast<const F&>(m_func)();
+        if (next) {
+            // The task is not completed until the last step of the chain, so the reservation
+            // of the wait tree vertex, the dependencies and the successors are kept
+            m_func.~F();
+            new (&m_func) F(std::move(next.body()));
+            return this;
+        }
+        return complete(ed, nullptr);
+    }
+
+    d1::task* execute_body(d1::execution_data& ed, std::false_type) {
+        return complete(ed, task_ptr_or_nullptr(static_cast<const F&>(m_func)));
+    }
+
+    d1::task* complete(d1::execution_data& ed, d1::task* next_task) {
         task_handle_task* successor_task = this->complete_and_try_get_successor();
 
         if (next_task != nullptr) {
@@ -107,10 +219,17 @@ private:
         } else {
             next_task = successor_task;
         }
-#endif
         this->destroy(&ed);
         return next_task;
     }
+#else
+    d1::task* execute(d1::execution_data& ed) override {
+        __TBB_ASSERT(ed.context == &this->ctx(), "The task group context should be used for all tasks");
+        task* next_task = task_ptr_or_nullptr(m_func);
+        this->destroy(&ed);
+        return next_task;
+    }
+#endif
     d1::task* cancel(d1::execution_data& ed) override {
         task* task_ptr = nullptr;
 #if __TBB_PREVIEW_TASK_GROUP_EXTENSIONS
@@ -147,13 +266,31 @@ public:
         return nullptr;
     }
 
+    struct continuation_result {};
+
+    // The stack task has no storage to reuse, so the steps are executed one after another
+    template<typename F>
+    d1::task* task_ptr_or_nullptr_impl(continuation_result, F&& f){
+        using continuation_type = decltype(std::forward<F>(f)());
+        static_assert(std::is_same<continuation_type, task_continuation<typename std::decay<F>::type>>::value,
+                      "The continuation should have the type of the task body");
+
+        continuation_type next = std::forward<F>(f)();
+        while (next) {
+            continuation_type step = std::move(next);
+            const auto& body = step.body();
+            next = body();
+        }
+        return nullptr;
+    }
+
     template<typename F>
     d1::task* task_ptr_or_nullptr(F&& f){
-        using is_void_t = std::is_void<
-            decltype(std::forward<F>(f)())
-            >;
+        using result_type = decltype(std::forward<F>(f)());
+        using result_kind = typename std::conditional<is_task_continuation<result_type>::value,
+            continuation_result, std::is_void<result_type>>::type;
 
-        return  task_ptr_or_nullptr_impl(is_void_t{}, std::forward<F>(f));
+        return  task_ptr_or_nullptr_impl(result_kind{}, std::forward<F>(f));
     }
 #else
     template<typename F>
@@ -220,7 +357,7 @@ private:
         bool fp_settings        : 1;
         bool concurrent_wait    : 1;
         bool bound              : 1;
-        bool reserved1          : 1;
+        bool scoped             : 1;
         bool reserved2          : 1;
         bool reserved3          : 1;
         bool reserved4          : 1;
@@ -253,13 +390,13 @@ private:
         task_group_context* my_actual_context;
     };
 
-    //! Thread data instance that registered this context in its list.
+    //! List of the children of the parent context this context is registered in.
     r1::context_list* my_context_list;
     static_assert(sizeof(std::atomic<r1::thread_data*>) == sizeof(r1::context_list*), "To preserve backward compatibility these types should have the same size");
 
-    //! Used to form the thread specific list of contexts without additional memory allocation.
-    /** A context is included into the list of the current thread when its binding to
-        its parent happens. Any context can be present in the list of one thread only. **/
+    //! Used to form the list of children of the parent context without additional memory allocation.
+    /** A context is included into the list of its parent when its binding to
+        the parent happens. A scoped context is included when it gets the first child. **/
     intrusive_list_node my_node;
     static_assert(sizeof(intrusive_list_node) == sizeof(context_list_node), "To preserve backward compatibility these types should have the same size");
 
@@ -274,6 +411,9 @@ private:
     //! Description of algorithm for scheduler based instrumentation.
     string_resource_index my_name;
 
+    //! List of the contexts bound to this context. Allocated when the first child is bound.
+    std::atomic<r1::context_list*> my_children;
+
     char padding[max_nfs_size
         - sizeof(std::uint64_t)                          // my_cpu_ctl_env
         - sizeof(std::atomic<std::uint32_t>)             // my_cancellation_requested
@@ -287,6 +427,7 @@ private:
         - sizeof(std::atomic<r1::tbb_exception_ptr*>)    // my_exception
         - sizeof(void*)                                  // my_itt_caller
         - sizeof(string_resource_index)                  // my_name
+        - sizeof(std::atomic<r1::context_list*>)         // my_children
     ];
 
     task_group_context(context_traits t, string_resource_index name)
@@ -313,7 +454,14 @@ private:
         ct.fp_settings = (user_traits & fp_settings) == fp_settings;
         ct.concurrent_wait = (user_traits & concurrent_wait) == concurrent_wait;
         ct.bound = relation_with_parent == bound;
-        ct.reserved1 = ct.reserved2 = ct.reserved3 = ct.reserved4 = ct.reserved5 = false;
+        ct.scoped = false;
+        ct.reserved2 = ct.reserved3 = ct.reserved4 = ct.reserved5 = false;
+        return ct;
+    }
+
+    static context_traits make_scoped_traits() {
+        context_traits ct = make_traits(bound, default_traits);
+        ct.scoped = true;
         return ct;
     }
 
@@ -372,6 +520,11 @@ public:
     task_group_context(string_resource_index name )
         : task_group_context(make_traits(bound, default_traits), name) {}
 
+    // Custom constructor for the context of oneTBB algorithm that is destroyed before the algorithm returns.
+    // Such a context never outlives its parent, so it is linked to the parent only when it gets children.
+    task_group_context(string_resource_index name, scoped_context_tag)
+        : task_group_context(make_scoped_traits(), name) {}
+
     // Do not introduce any logic on user side since it might break state propagation assumptions
     ~task_group_context() {
         // When 'this' serves as a proxy, the initialization does not happen - nor should the
@@ -435,7 +588,6 @@ public:
     }
 private:
     //// TODO: cleanup friends
-    friend class r1::cancellation_disseminator;
     friend class r1::thread_data;
     friend class r1::task_dispatcher;
     template <bool>
@@ -628,6 +780,44 @@ public:
     void cancel() {
         context().cancel_group_execution();
     }
+
+#if __TBB_PREVIEW_COROUTINES && __TBB_CPP20_COROUTINES_PRESENT
+protected:
+    class wait_awaiter {
+    public:
+        wait_awaiter(task_group_base& group) : m_group(group) {}
+
+        bool await_ready() const {
+            return !m_group.m_wait_vertex.continue_execution();
+        }
+
+        bool await_suspend(std::coroutine_handle<> coroutine) {
+            d1::coroutine_resume_task& resume_task = d1::coroutine_resume_task::allocate(coroutine);
+            if (!r1::wait_async(m_group.m_wait_vertex.get_context(), resume_task)) {
+                resume_task.release();
+                return false;
+            }
+            return true;
+        }
+
+        // The tasks are completed, so wait() does not block; it resets the context,
+        // returns the status and rethrows the exception of the group if any
+        task_group_status await_resume() {
+            return m_group.wait();
+        }
+
+    private:
+        task_group_base& m_group;
+    };
+
+public:
+    //! Returns an awaitable that completes when all tasks in the group are completed
+    /** Instead of the thread, the awaiting coroutine is suspended. It is resumed as a task
+        in the arena it was suspended in. */
+    wait_awaiter async_wait() {
+        return wait_awaiter(*this);
+    }
+#endif
 }; // class task_group_base
 
 class task_group : public task_group_base {
@@ -807,6 +997,182 @@ public:
     }
 }; // class isolated_task_group
 #endif // __TBB_PREVIEW_ISOLATED_TASK_GROUP
+
+#if __TBB_PREVIEW_WORK_FIRST_TASK_GROUP
+//! The task group that executes the last submitted task by the waiting thread
+/** task_group spawns each task and the thread continues the submitting code (help-first).
+    The work-first group holds the last submitted task back: the next submission spawns it,
+    and wait executes it immediately, bypassing the task pool, so recursive algorithms
+    that submit several tasks and wait for them push one task less per level.
+    Therefore, a single submitted task is not executed until the next run, run_and_wait, or wait.
+    While the group is waited for, tasks are not held back, since a task submitted by a task
+    of the group might not be executed by anyone otherwise. */
+class work_first_task_group : public task_group_base {
+    //! The last submitted task that is not spawned yet, or the number of threads waiting for the group
+    /** Tasks are aligned, so the low bit of a task address is clear. While the group is waited for,
+        the bit is set and the rest of the state counts the waiting threads. */
+    std::atomic<std::uintptr_t> m_state{0};
+
+    static constexpr std::uintptr_t waiting_flag = 1;
+    static constexpr std::uintptr_t one_waiter = 2;
+    static_assert(alignof(d1::task) > waiting_flag, "The task address cannot hold the waiting flag");
+
+    //! Holds the task back and spawns the previously held one, so it becomes available for stealing
+    void defer_task(d1::task& t) {
+        std::uintptr_t state = m_state.load(std::memory_order_relaxed);
+        do {
+            if (state & waiting_flag) {
+                // The waiting threads take the task from the task pool
+                d1::spawn(t, context());
+                return;
+            }
+        } while (!m_state.compare_exchange_weak(state, reinterpret_cast<std::uintptr_t>(&t)));
+        if (state != 0) {
+            d1::spawn(*reinterpret_cast<d1::task*>(state), context());
+        }
+    }
+
+    //! Stops holding tasks back while the calling thread waits for the group
+    class waiting_scope : d0::no_copy {
+    public:
+        waiting_scope(work_first_task_group& group) : m_group(group) {
+            std::uintptr_t state = m_group.m_state.load(std::memory_order_relaxed);
+            std::uintptr_t new_state{};
+            do {
+                new_state = (state & waiting_flag) ? state + one_waiter : one_waiter | waiting_flag;
+            } while (!m_group.m_state.compare_exchange_weak(state, new_state));
+            m_deferred_task = (state & waiting_flag) ? nullptr : reinterpret_cast<d1::task*>(state);
+        }
+
+        ~waiting_scope() {
+            std::uintptr_t state = m_group.m_state.load(std::memory_order_relaxed);
+            std::uintptr_t new_state{};
+            do {
+                __TBB_ASSERT(state & waiting_flag, "The group is not waited for");
+                new_state = state == (one_waiter | waiting_flag) ? 0 : state - one_waiter;
+            } while (!m_group.m_state.compare_exchange_weak(state, new_state));
+        }
+
+        //! Returns the task held back before the wait, which the caller has to execute or spawn
+        d1::task* take_deferred_task() {
+            d1::task* deferred = m_deferred_task;
+            m_deferred_task = nullptr;
+            return deferred;
+        }
+
+        void spawn_deferred_task() {
+            if (d1::task* deferred = take_deferred_task()) {
+                d1::spawn(*deferred, m_group.context());
+            }
+        }
+
+    private:
+        work_first_task_group& m_group;
+        d1::task* m_deferred_task{nullptr};
+    };
+
+#if __TBB_PREVIEW_COROUTINES && __TBB_CPP20_COROUTINES_PRESENT
+    //! The group is waited for until the awaiter is destroyed
+    class work_first_wait_awaiter : public wait_awaiter {
+    public:
+        work_first_wait_awaiter(work_first_task_group& group) : wait_awaiter(group), m_scope(group) {
+            // The awaiting coroutine does not occupy the thread
+            m_scope.spawn_deferred_task();
+        }
+
+    private:
+        waiting_scope m_scope;
+    };
+#endif
+
+public:
+    work_first_task_group() : task_group_base(d1::task_group_context::concurrent_wait) {}
+    work_first_task_group(d1::task_group_context& ctx) : task_group_base(ctx) {}
+
+    ~work_first_task_group() {
+        // The deferred task is cancelled together with the group if wait is missing
+        waiting_scope scope(*this);
+        scope.spawn_deferred_task();
+    }
+
+    template<typename F>
+    void run(F&& f) {
+        defer_task(*prepare_task(std::forward<F>(f)));
+    }
+
+    void run(d2::task_handle&& h) {
+        __TBB_ASSERT(h != nullptr, "Attempt to schedule empty task_handle");
+
+        using acs = d2::task_handle_accessor;
+        __TBB_ASSERT(&acs::ctx_of(h) == &context(), "Attempt to schedule task_handle into different task_group");
+
+        task_handle_task* task_ptr = acs::release(h);
+#if __TBB_PREVIEW_TASK_GROUP_EXTENSIONS
+        // If the task has dependencies and the task_handle is not the last dependency
+        if (task_ptr->has_dependencies() && !task_ptr->release_dependency()) {
+            return;
+        }
+#endif
+        defer_task(*task_ptr);
+    }
+
+    template<typename F>
+    d2::task_handle defer(F&& f) {
+        return prepare_task_handle(std::forward<F>(f));
+    }
+
+    //! Executes the deferred task, if any, and waits for the rest of the tasks
+    task_group_status wait() {
+        waiting_scope scope(*this);
+        if (d1::task* deferred = scope.take_deferred_task()) {
+            // Returns when all tasks of the group are completed, so the base wait only resets the context
+            try_call([&] {
+                execute_and_wait(*deferred, context(), m_wait_vertex.get_context(), context());
+            }).on_exception([&] {
+                context().reset();
+            });
+        }
+        return task_group_base::wait();
+    }
+
+    template<typename F>
+    task_group_status run_and_wait(const F& f) {
+        waiting_scope scope(*this);
+        scope.spawn_deferred_task();
+        return internal_run_and_wait(f);
+    }
+
+    task_group_status run_and_wait(d2::task_handle&& h) {
+        waiting_scope scope(*this);
+        scope.spawn_deferred_task();
+        return internal_run_and_wait(std::move(h));
+    }
+
+#if __TBB_PREVIEW_TASK_GROUP_EXTENSIONS
+    task_group_status run_and_wait_for_task(d2::task_handle&& h) {
+        waiting_scope scope(*this);
+        scope.spawn_deferred_task();
+        return internal_run_and_wait_for_task(std::move(h));
+    }
+
+    task_group_status wait_for_task(task_completion_handle& comp_handle) {
+        // The awaited task might be the deferred one
+        waiting_scope scope(*this);
+        scope.spawn_deferred_task();
+        return task_group_base::wait_for_task(comp_handle);
+    }
+#endif
+
+#if __TBB_PREVIEW_COROUTINES && __TBB_CPP20_COROUTINES_PRESENT
+    //! Returns an awaitable that completes when all tasks in the group are completed
+    /** The deferred task is spawned since the awaiting coroutine does not occupy the thread.
+        Tasks are not held back until the awaitable is destroyed. */
+    work_first_wait_awaiter async_wait() {
+        return work_first_wait_awaiter(*this);
+    }
+#endif
+}; // class work_first_task_group
+#endif // __TBB_PREVIEW_WORK_FIRST_TASK_GROUP
 } // namespace d2
 } // namespace detail
 
@@ -816,6 +1182,9 @@ using detail::d2::task_group;
 #if __TBB_PREVIEW_ISOLATED_TASK_GROUP
 using detail::d2::isolated_task_group;
 #endif
+#if __TBB_PREVIEW_WORK_FIRST_TASK_GROUP
+using detail::d2::work_first_task_group;
+#endif
 
 using detail::d2::task_group_status;
 using detail::d2::not_complete;
@@ -829,6 +1198,8 @@ using detail::d2::task_handle;
 #if __TBB_PREVIEW_TASK_GROUP_EXTENSIONS
 using detail::d2::task_completion_handle;
 using detail::d2::task_complete;
+using detail::d2::task_continuation;
+using detail::d2::continue_with;
 #endif
 }
 
@@ -26,6 +26,7 @@
 #include "oneapi/tbb/info.h"
 #include "oneapi/tbb/tbb_allocator.h"
 
+#include <algorithm>
 #include <atomic>
 #include <cstring>
 #include <functional>
@@ -37,9 +38,10 @@ namespace r1 {
 class numa_binding_observer : public tbb::task_scheduler_observer {
     binding_handler* my_binding_handler;
 public:
-    numa_binding_observer( d1::task_arena* ta, int num_slots, int numa_id, core_type_id core_type, int max_threads_per_core )
+    numa_binding_observer( d1::task_arena* ta, int num_slots, int numa_id, core_type_id core_type, int max_threads_per_core,
+                           d1::placement_policy placement )
         : task_scheduler_observer(*ta)
-        , my_binding_handler(construct_binding_handler(num_slots, numa_id, core_type, max_threads_per_core))
+        , my_binding_handler(construct_binding_handler(num_slots, numa_id, core_type, max_threads_per_core, int(placement)))
     {}
 
     void on_scheduler_entry( bool ) override {
@@ -59,10 +61,14 @@ public:
     }
 };
 
-numa_binding_observer* construct_binding_observer( d1::task_arena* ta, int num_slots, int numa_id, core_type_id core_type, int max_threads_per_core ) {
+numa_binding_observer* construct_binding_observer( d1::task_arena* ta, int num_slots, int numa_id, core_type_id core_type, int max_threads_per_core,
+                                                   d1::placement_policy placement ) {
     numa_binding_observer* binding_observer = nullptr;
-    if ((multi_core_type_codec::is_core_type(core_type) && core_type_count() > 1) || (numa_id >= 0 && numa_node_count() > 1) || max_threads_per_core > 0) {
-        binding_observer = new(allocate_memory(sizeof(numa_binding_observer))) numa_binding_observer(ta, num_slots, numa_id, core_type, max_threads_per_core);
+    if ((multi_core_type_codec::is_core_type(core_type) && core_type_count() > 1) || (numa_id >= 0 && numa_node_count() > 1) || max_threads_per_core > 0
+        || placement != d1::placement_policy::none)
+    {
+        binding_observer = new(allocate_memory(sizeof(numa_binding_observer)))
+            numa_binding_observer(ta, num_slots, numa_id, core_type, max_threads_per_core, placement);
         __TBB_ASSERT(binding_observer, "Failure during NUMA binding observer allocation and construction");
     }
     return binding_observer;
@@ -152,6 +158,22 @@ void arena::on_thread_leaving(unsigned ref_param) {
     }
 }
 
+void arena::on_coroutine_suspended() {
+    // The first suspended coroutine takes the reference for all of them, so there is no limit
+    // on the number of coroutines as there is for external references.
+    // The calling thread is in the arena, so the arena cannot be destroyed meanwhile.
+    if (my_suspended_coroutines.fetch_add(1) == 0) {
+        my_references += ref_external;
+    }
+}
+
+void arena::on_coroutine_resumed() {
+    if (my_suspended_coroutines.fetch_sub(1) == 1) {
+        // Do not access the arena after that point, it might be destroyed already
+        on_thread_leaving(ref_external);
+    }
+}
+
 std::size_t arena::occupy_free_slot_in_range( thread_data& tls, std::size_t lower, std::size_t upper ) {
     if ( lower >= upper ) return out_of_arena;
     // Start search for an empty slot from the one we occupied the last time
@@ -200,6 +222,17 @@ void arena::process(thread_data& tls) {
 
     __TBB_ASSERT( index >= my_num_reserved_slots, "Workers cannot occupy reserved slots" );
     tls.attach_arena(*this, index);
+    tls.my_arena_slot->count(worker_join_event);
+    if (tls.my_is_handed_off) {
+        tls.my_arena_slot->count(worker_handoff_event);
+    }
+    if (my_migration_latency && tls.my_arena_leave_time != 0) {
+        std::uint64_t now = enqueue_clock_now();
+        my_migration_latency->record(now > tls.my_arena_leave_time ? now - tls.my_arena_leave_time : 0);
+    }
+    tls.my_arena_leave_time = 0;
+    tls.trace(trace_event::arena_join, this);
+    tls.start_arena_cpu_time();
     // worker thread enters the dispatch loop to look for a work
     tls.my_inbox.set_is_idle(true);
     if (tls.my_arena_slot->is_task_pool_published()) {
@@ -224,6 +257,9 @@ void arena::process(thread_data& tls) {
     __TBB_ASSERT(governor::is_thread_data_set(&tls), nullptr);
     __TBB_ASSERT(tls.my_task_dispatcher == &task_disp, nullptr);
 
+    // Charged before the exit observers are notified, so they see the time of the leaving thread
+    tls.stop_arena_cpu_time();
+
     my_observers.notify_exit_observers(tls.my_last_observer, tls.my_is_worker);
     tls.my_last_observer = nullptr;
 
@@ -231,6 +267,11 @@ void arena::process(thread_data& tls) {
 
     // Arena slot detach (arena may be used in market::process)
     // TODO: Consider moving several calls below into a new method(e.g.detach_arena).
+    tls.my_arena_slot->count(worker_leave_event);
+    if (governor::migration_latency_tracking()) {
+        tls.my_arena_leave_time = enqueue_clock_now();
+    }
+    tls.trace(trace_event::arena_leave, this);
     tls.my_arena_slot->release();
     tls.my_arena_slot = nullptr;
     tls.my_inbox.detach();
@@ -257,9 +298,17 @@ arena::arena(threading_control* control, unsigned num_slots, unsigned num_reserv
     my_num_reserved_slots = min(num_reserved_slots, num_slots);
     my_max_num_workers = num_slots-my_num_reserved_slots;
     my_priority_level = priority_level;
+    my_locality_aware_stealing = governor::locality_aware_stealing() && my_num_slots > 1;
+    my_steal_batch_size = min(governor::steal_batch_size(), std::size_t(arena_slot::max_steal_batch_size));
+    my_enqueue_latency = governor::enqueue_latency_tracking() ?
+        new (cache_aligned_allocate(sizeof(latency_recorder))) latency_recorder() : nullptr;
+    my_migration_latency = governor::migration_latency_tracking() ?
+        new (cache_aligned_allocate(sizeof(latency_recorder))) latency_recorder() : nullptr;
+    my_cpu_time_accounting = governor::arena_cpu_time_accounting();
     my_references = ref_external; // accounts for the external thread
     my_observers.my_arena = this;
-    my_co_cache.init(4 * num_slots);
+    std::size_t co_cache_capacity = governor::suspend_point_cache_size();
+    my_co_cache.init(co_cache_capacity ? unsigned(co_cache_capacity) : 4 * num_slots);
     __TBB_ASSERT ( my_max_num_workers <= my_num_slots, nullptr);
     // Initialize the default context. It should be allocated before task_dispatch construction.
     my_default_ctx = new (cache_aligned_allocate(sizeof(d1::task_group_context)))
@@ -275,14 +324,19 @@ arena::arena(threading_control* control, unsigned num_slots, unsigned num_reserv
         my_slots[i].my_default_task_dispatcher = new(base_td_pointer + i) task_dispatcher(this);
         my_slots[i].my_is_occupied.store(false, std::memory_order_relaxed);
     }
-    my_fifo_task_stream.initialize(my_num_slots);
+    // Binding the lanes to NUMA nodes makes sense only when the threads are spread over several nodes
+    my_fifo_task_stream.initialize(my_num_slots, governor::numa_task_streams() ? numa_node_count() : 1);
+    my_deadline_task_stream.initialize(my_num_slots);
     my_resume_task_stream.initialize(my_num_slots);
 #if __TBB_CRITICAL_TASKS
     my_critical_task_stream.initialize(my_num_slots);
 #endif
     my_mandatory_requests = 0;
+    my_suspended_coroutines.store(0, std::memory_order_relaxed);
 
     my_thread_leave.set_initial_state(lp);
+    my_arrival_predictor.set_retention_limit(
+        std::chrono::microseconds(global_control::active_value(global_control::worker_retention_limit)));
 }
 
 arena& arena::allocate_arena(threading_control* control, unsigned num_slots, unsigned num_reserved_slots,
@@ -320,11 +374,20 @@ void arena::free_arena () {
         my_slots[i].my_default_task_dispatcher->~task_dispatcher();
     }
     __TBB_ASSERT(my_fifo_task_stream.empty(), "Not all enqueued tasks were executed");
+    __TBB_ASSERT(my_deadline_task_stream.empty(), "Not all enqueued tasks were executed");
     __TBB_ASSERT(my_resume_task_stream.empty(), "Not all enqueued tasks were executed");
     // Cleanup coroutines/schedulers cache
     my_co_cache.cleanup();
     my_default_ctx->~task_group_context();
     cache_aligned_deallocate(my_default_ctx);
+    if (my_enqueue_latency) {
+        my_enqueue_latency->~latency_recorder();
+        cache_aligned_deallocate(my_enqueue_latency);
+    }
+    if (my_migration_latency) {
+        my_migration_latency->~latency_recorder();
+        cache_aligned_deallocate(my_migration_latency);
+    }
 #if __TBB_CRITICAL_TASKS
     __TBB_ASSERT( my_critical_task_stream.empty(), "Not all critical tasks were executed");
 #endif
@@ -341,20 +404,61 @@ void arena::free_arena () {
 }
 
 bool arena::has_enqueued_tasks() {
-    return !my_fifo_task_stream.empty();
+    return !my_fifo_task_stream.empty() || !my_deadline_task_stream.empty();
 }
 
 void arena::request_workers(int mandatory_delta, int workers_delta, bool wakeup_threads) {
     my_threading_control->adjust_demand(my_tc_client, mandatory_delta, workers_delta);
 
     if (wakeup_threads) {
-        // Notify all sleeping threads that work has appeared in the arena.
-        get_waiting_threads_monitor().notify([&] (market_context context) {
-            return this == context.my_arena_addr;
-        });
+        my_shared_counters.count_concurrently(thread_wakeup_event);
+        // A worker parked in the arena is the fastest to pick up the work. Only if there is none,
+        // or it may leave the arena because of a recall, notify all sleeping threads that work has
+        // appeared in the arena.
+        if (is_recall_requested() || !unpark_worker()) {
+            get_waiting_threads_monitor().notify([&] (market_context context) {
+                return this == context.my_arena_addr;
+            });
+        }
+    }
+}
+
+//! The upper bound of a single park, so the conditions to leave the arena are rechecked periodically
+static constexpr std::chrono::microseconds max_parking_duration{100};
+
+void arena::park_worker(arena_slot& slot, std::chrono::microseconds timeout) {
+    __TBB_ASSERT(slot.is_occupied(), "The worker must occupy the slot to park there");
+    const bool tracing = governor::scheduler_tracing();
+    if (tracing) {
+        trace_current_thread(trace_event::thread_sleep_begin, this);
+    }
+    my_parked_workers.fetch_add(1);
+    slot.my_parking_slot.park(std::min(timeout, max_parking_duration), [this] {
+        return !is_empty() && !is_recall_requested();
+    });
+    my_parked_workers.fetch_sub(1, std::memory_order_relaxed);
+    if (tracing) {
+        trace_current_thread(trace_event::thread_sleep_end, this);
     }
 }
 
+bool arena::unpark_worker() {
+    // Pairs with the seq_cst publication of the parked state: either the parked worker observes
+    // the new work before blocking or the parked state is observed here.
+    if (my_parked_workers.load() == 0) {
+        return false;
+    }
+    // Each advertisement of new work wakes one worker. The other parked workers recheck the arena
+    // when their park times out, so a burst of work does not wake all of them at once.
+    std::size_t n = my_limit.load(std::memory_order_acquire);
+    for (std::size_t k = my_num_reserved_slots; k < n; ++k) {
+        if (my_slots[k].my_parking_slot.unpark()) {
+            return true;
+        }
+    }
+    return false;
+}
+
 bool arena::has_tasks() {
     // TODO: rework it to return at least a hint about where a task was found; better if the task itself.
     std::size_t n = my_limit.load(std::memory_order_acquire);
@@ -383,6 +487,9 @@ void arena::out_of_work() {
             // We had set workers_delta to 1 when enabled mandatory concurrency, so revert it now
             workers_delta = -1;
         }
+        if (release_workers) {
+            my_arrival_predictor.on_out_of_work(work_arrival_predictor::clock::now());
+        }
         request_workers(mandatory_delta, workers_delta);
     }
 }
@@ -447,14 +554,45 @@ thread_control_monitor& arena::get_waiting_threads_monitor() {
     return my_threading_control->get_waiting_threads_monitor();
 }
 
-void arena::enqueue_task(d1::task& t, d1::task_group_context& ctx, thread_data& td) {
+void arena::prepare_enqueued_task(d1::task& t, d1::task_group_context& ctx, thread_data& td) {
     task_group_context_impl::bind_to(ctx, &td);
     task_accessor::context(t) = &ctx;
     task_accessor::isolation(t) = no_isolation;
-    my_fifo_task_stream.push( &t, random_lane_selector(td.my_random) );
+    mark_enqueue_time(t);
+}
+
+void arena::on_task_enqueued(thread_data& td) {
+    if (td.my_arena_slot && td.is_attached_to(this)) {
+        td.my_arena_slot->count(task_enqueued_event);
+    } else {
+        my_shared_counters.count_concurrently(task_enqueued_event);
+    }
     advertise_new_work<work_enqueued>();
 }
 
+void arena::push_to_fifo_stream(d1::task& t, thread_data& td) {
+    if (my_fifo_task_stream.is_partitioned()) {
+        int numa_node = td.numa_node();
+        if (numa_node != unknown_numa_node) {
+            my_fifo_task_stream.push_local( &t, unsigned(numa_node), random_lane_selector(td.my_random) );
+            return;
+        }
+    }
+    my_fifo_task_stream.push( &t, random_lane_selector(td.my_random) );
+}
+
+void arena::enqueue_task(d1::task& t, d1::task_group_context& ctx, thread_data& td) {
+    prepare_enqueued_task(t, ctx, td);
+    push_to_fifo_stream(t, td);
+    on_task_enqueued(td);
+}
+
+void arena::enqueue_task(d1::task& t, d1::task_group_context& ctx, thread_data& td, std::int64_t deadline) {
+    prepare_enqueued_task(t, ctx, td);
+    my_deadline_task_stream.push( &t, deadline, random_lane_selector(td.my_random) );
+    on_task_enqueued(td);
+}
+
 arena &arena::create(threading_control *control, unsigned num_slots,
                      unsigned num_reserved_slots, unsigned arena_priority_level,
                      d1::constraints constraints, numa_binding_observer* observer, tbb::task_arena::leave_policy lp)
@@ -464,6 +602,10 @@ arena &arena::create(threading_control *control, unsigned num_slots,
     arena& a = arena::allocate_arena(control, num_slots, num_reserved_slots, arena_priority_level, lp);
     __TBB_ASSERT(a.my_num_reserved_slots <= a.my_num_slots, NULL);
     a.my_numa_binding_observer = observer;
+    // The reserved slots are not filled by workers, so they count toward the guaranteed concurrency
+    if (constraints.min_concurrency > int(a.my_num_reserved_slots)) {
+        a.my_num_guaranteed_workers = min(unsigned(constraints.min_concurrency) - a.my_num_reserved_slots, a.my_max_num_workers);
+    }
     a.my_tc_client = control->create_client(a);
     // We should not publish arena until all fields are initialized
     control->publish_client(a.my_tc_client, constraints);
@@ -515,9 +657,12 @@ struct task_arena_impl {
     static void wait(d1::task_arena_base&);
     static int max_concurrency(const d1::task_arena_base*);
     static void enqueue(d1::task&, d1::task_group_context*, d1::task_arena_base*);
+    static void enqueue(d1::task&, d1::task_group_context*, d1::task_arena_base*, std::int64_t);
     static d1::slot_id execution_slot(const d1::task_arena_base&);
     static void enter_parallel_phase(d1::task_arena_base*, std::uintptr_t);
     static void exit_parallel_phase(d1::task_arena_base*, std::uintptr_t);
+    static void get_statistics(const d1::task_arena_base*, d1::task_arena_statistics&);
+    static void warm_up(d1::task_arena_base&);
 };
 
 void __TBB_EXPORTED_FUNC initialize(d1::task_arena_base& ta) {
@@ -548,6 +693,11 @@ void __TBB_EXPORTED_FUNC enqueue(d1::task& t, d1::task_group_context& ctx, d1::t
     task_arena_impl::enqueue(t, &ctx, ta);
 }
 
+void __TBB_EXPORTED_FUNC enqueue_with_deadline(d1::task& t, d1::task_group_context* ctx, d1::task_arena_base* ta,
+                                               std::int64_t deadline) {
+    task_arena_impl::enqueue(t, ctx, ta, deadline);
+}
+
 d1::slot_id __TBB_EXPORTED_FUNC execution_slot(const d1::task_arena_base& arena) {
     return task_arena_impl::execution_slot(arena);
 }
@@ -560,6 +710,14 @@ void __TBB_EXPORTED_FUNC exit_parallel_phase(d1::task_arena_base* ta, std::uintp
     task_arena_impl::exit_parallel_phase(ta, flags);
 }
 
+void __TBB_EXPORTED_FUNC get_statistics(const d1::task_arena_base* ta, d1::task_arena_statistics& statistics) {
+    task_arena_impl::get_statistics(ta, statistics);
+}
+
+void __TBB_EXPORTED_FUNC warm_up(d1::task_arena_base& ta) {
+    task_arena_impl::warm_up(ta);
+}
+
 void task_arena_impl::initialize(d1::task_arena_base& ta) {
     // Enforce global market initialization to properly initialize soft limit
     thread_data* td = governor::get_thread_data();
@@ -569,7 +727,10 @@ void task_arena_impl::initialize(d1::task_arena_base& ta) {
     arena_constraints = d1::constraints{}
         .set_core_type(ta.core_type())
         .set_max_threads_per_core(ta.max_threads_per_core())
-        .set_numa_id(ta.my_numa_id);
+        .set_numa_id(ta.my_numa_id)
+        .set_weight(ta.weight())
+        .set_min_concurrency(ta.min_concurrency())
+        .set_placement(ta.placement());
 
     if (ta.my_max_concurrency < 1) {
         ta.my_max_concurrency = (int)default_concurrency(arena_constraints);
@@ -579,7 +740,7 @@ void task_arena_impl::initialize(d1::task_arena_base& ta) {
 #if __TBB_CPUBIND_PRESENT
     observer = construct_binding_observer(
         static_cast<d1::task_arena*>(&ta), arena::num_arena_slots(ta.my_max_concurrency, ta.my_num_reserved_slots),
-        ta.my_numa_id, ta.core_type(), ta.max_threads_per_core());
+        ta.my_numa_id, ta.core_type(), ta.max_threads_per_core(), ta.placement());
     // Apply the constraints to this thread and make it appear as slot 0 during arena initialization.
     const d1::slot_id current_slot = td->my_arena_index;
     if (observer) {
@@ -655,6 +816,16 @@ void task_arena_impl::enqueue(d1::task& t, d1::task_group_context* c, d1::task_a
      a->enqueue_task(t, *ctx, *td);
 }
 
+void task_arena_impl::enqueue(d1::task& t, d1::task_group_context* c, d1::task_arena_base* ta, std::int64_t deadline) {
+    thread_data* td = governor::get_thread_data();  // thread data is only needed for FastRandom instance
+    assert_pointer_valid(td, "thread_data pointer should not be null");
+    arena* a = ta ? ta->my_arena.load(std::memory_order_relaxed) : td->my_arena;
+    assert_pointer_valid(a, "arena pointer should not be null");
+    auto* ctx = c ? c : a->my_default_ctx;
+    assert_pointer_valid(ctx, "context pointer should not be null");
+    a->enqueue_task(t, *ctx, *td, deadline);
+}
+
 d1::slot_id task_arena_impl::execution_slot(const d1::task_arena_base& ta) {
     thread_data* td = governor::get_thread_data_if_initialized();
     if (td && (td->is_attached_to(ta.my_arena.load(std::memory_order_relaxed)))) {
@@ -675,7 +846,10 @@ public:
             m_orig_is_thread_registered = td.my_is_registered;
 
             td.detach_task_dispatcher();
+            m_orig_cpu_time_accounted = td.stop_arena_cpu_time();
             td.attach_arena(nested_arena, slot_index);
+            td.trace(trace_event::arena_join, &nested_arena);
+            td.start_arena_cpu_time();
             td.my_is_registered = false;
             if (td.my_inbox.is_idle_state(true))
                 td.my_inbox.set_is_idle(false);
@@ -715,6 +889,7 @@ public:
         m_task_dispatcher->allow_fifo_task(m_orig_fifo_tasks_allowed);
         m_task_dispatcher->m_properties.critical_task_allowed = m_orig_critical_task_allowed;
         if (m_orig_arena) {
+            td.stop_arena_cpu_time();
             td.my_arena->my_observers.notify_exit_observers(td.my_last_observer, /*worker*/ false);
             td.my_last_observer = m_orig_last_observer;
 
@@ -725,10 +900,14 @@ public:
             }
 
             td.leave_task_dispatcher();
+            td.trace(trace_event::arena_leave, td.my_arena);
             td.my_arena_slot->release();
             td.my_arena->my_exit_monitors.notify_one(); // do not relax!
             td.my_is_registered = m_orig_is_thread_registered;
             td.attach_arena(*m_orig_arena, m_orig_slot_index);
+            if (m_orig_cpu_time_accounted) {
+                td.start_arena_cpu_time();
+            }
             td.attach_task_dispatcher(*m_orig_execute_data_ext.task_disp);
             __TBB_ASSERT(td.my_inbox.is_idle_state(false), nullptr);
         }
@@ -744,6 +923,7 @@ private:
     bool                m_orig_fifo_tasks_allowed{};
     bool                m_orig_critical_task_allowed{};
     bool                m_orig_is_thread_registered{};
+    bool                m_orig_cpu_time_accounted{};
 };
 
 class delegated_task : public d1::task {
@@ -912,22 +1092,203 @@ void task_arena_impl::exit_parallel_phase(d1::task_arena_base* ta, std::uintptr_
     a->my_thread_leave.unregister_parallel_phase(flags);
 }
 
+//! The longest time the warm-up waits for the workers to join the arena
+static constexpr std::chrono::milliseconds warm_up_timeout{100};
+
+class warm_up_task;
+
+//! The state shared by the warm-up tasks and the thread that waits for them
+/** The tasks can be taken by the workers after the waiting thread gives up, so the state is
+    released by whichever of them finishes last. **/
+struct warm_up_rendezvous {
+    std::atomic<unsigned> arrived{0};
+    std::atomic<unsigned> finished{0};
+    std::atomic<unsigned> ref_count;
+    std::chrono::steady_clock::time_point deadline;
+    arena& my_arena;
+    warm_up_task* tasks{nullptr};
+    unsigned num_tasks;
+    d1::task_group_context context{d1::task_group_context::isolated};
+
+    warm_up_rendezvous(arena& a, unsigned n)
+        : ref_count{n + 1}, deadline{std::chrono::steady_clock::now() + warm_up_timeout}, my_arena{a}, num_tasks{n} {}
+
+    void release();
+};
+
+//! The task that holds a worker in the arena until all the workers being warmed up join it
+/** Holding the worker forces the other warm-up tasks to be taken by distinct workers, so each of them
+    is created, initializes its scheduler data, occupies a slot and, for an arena with constraints,
+    is bound to the hardware resources of the arena. **/
+class warm_up_task : public d1::task {
+    warm_up_rendezvous* m_rendezvous{nullptr};
+
+    //! Faults in the pages of the stack that tasks of the worker typically use
+    static void touch_stack() {
+        constexpr std::size_t size = 64 * 1024;
+        constexpr std::size_t page_size = 4 * 1024;
+        volatile char pages[size];
+        for (std::size_t i = 0; i < size; i += page_size) {
+            pages[i] = 0;
+        }
+        suppress_unused_warning(pages);
+    }
+
+    d1::task* execute(d1::execution_data&) override {
+        warm_up_rendezvous& r = *m_rendezvous;
+        if (std::chrono::steady_clock::now() < r.deadline) {
+            touch_stack();
+            r.arrived.fetch_add(1);
+            // The allotment is re-read, since it changes while other arenas demand workers
+            auto is_waiting = [&r] {
+                unsigned expected = std::min(r.my_arena.my_max_num_workers,
+                                             r.my_arena.my_num_workers_allotted.load(std::memory_order_relaxed));
+                return r.arrived.load(std::memory_order_acquire) < expected;
+            };
+            while (is_waiting() && std::chrono::steady_clock::now() < r.deadline) {
+                d0::yield();
+            }
+        }
+        r.finished.fetch_add(1, std::memory_order_release);
+        r.release();
+        return nullptr;
+    }
+    d1::task* cancel(d1::execution_data&) override {
+        m_rendezvous->finished.fetch_add(1, std::memory_order_release);
+        m_rendezvous->release();
+        return nullptr;
+    }
+public:
+    void set_rendezvous(warm_up_rendezvous& r) {
+        m_rendezvous = &r;
+    }
+};
+
+void warm_up_rendezvous::release() {
+    if (ref_count.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        for (unsigned i = 0; i < num_tasks; ++i) {
+            tasks[i].~warm_up_task();
+        }
+        cache_aligned_deallocate(tasks);
+        this->~warm_up_rendezvous();
+        cache_aligned_deallocate(this);
+    }
+}
+
+void task_arena_impl::warm_up(d1::task_arena_base& ta) {
+    arena* a = ta.my_arena.load(std::memory_order_relaxed);
+    __TBB_ASSERT(a != nullptr, nullptr);
+    unsigned num_tasks = a->my_max_num_workers;
+    if (num_tasks == 0) {
+        return;
+    }
+    thread_data* td = governor::get_thread_data();
+    if (td->my_arena == a) {
+        // The arena is in use by the calling thread, and a worker waiting for the warm-up would
+        // take the place of one of the workers being warmed up, so they never all arrive
+        return;
+    }
+    warm_up_rendezvous* r = new (cache_aligned_allocate(sizeof(warm_up_rendezvous))) warm_up_rendezvous(*a, num_tasks);
+    task_group_context_impl::copy_fp_settings(r->context, *a->my_default_ctx);
+    r->tasks = static_cast<warm_up_task*>(cache_aligned_allocate(num_tasks * sizeof(warm_up_task)));
+    for (unsigned i = 0; i < num_tasks; ++i) {
+        new (r->tasks + i) warm_up_task();
+        r->tasks[i].set_rendezvous(*r);
+    }
+    for (unsigned i = 0; i < num_tasks; ++i) {
+        a->enqueue_task(r->tasks[i], r->context, *td);
+    }
+    // The calling thread does not join the arena, so the tasks are executed only by workers.
+    // The workers may never come, e.g. when other arenas take all of them, so the wait is bounded.
+    while (r->finished.load(std::memory_order_acquire) < num_tasks && std::chrono::steady_clock::now() < r->deadline) {
+        d0::yield();
+    }
+    if (r->finished.load(std::memory_order_acquire) < num_tasks) {
+        // The tasks that are not started yet are skipped when the workers take them
+        r->context.cancel_group_execution();
+    }
+    r->release();
+}
+
+void task_arena_impl::get_statistics(const d1::task_arena_base* ta, d1::task_arena_statistics& statistics) {
+    static_assert(unsigned(d1::task_arena_statistics::locality_levels_count) == unsigned(locality_levels_count),
+                  "Locality levels of the statistics and the scheduler mismatch");
+    arena* a = ta ? ta->my_arena.load(std::memory_order_relaxed) : governor::get_thread_data()->my_arena;
+    __TBB_ASSERT(a, "arena should be initialized before collecting statistics");
+    statistics = d1::task_arena_statistics{};
+    auto add_counters = [&statistics] (const scheduler_counters& counters) {
+        statistics.spawned_tasks += counters.value(task_spawned_event);
+        statistics.executed_tasks += counters.value(task_executed_event);
+        statistics.failed_steals += counters.value(steal_failed_event);
+        statistics.mailbox_tasks += counters.value(mailbox_task_event);
+        statistics.enqueued_tasks += counters.value(task_enqueued_event);
+        statistics.worker_joins += counters.value(worker_join_event);
+        statistics.worker_leaves += counters.value(worker_leave_event);
+        statistics.worker_handoffs += counters.value(worker_handoff_event);
+        statistics.sleeps += counters.value(thread_sleep_event);
+        statistics.wakeups += counters.value(thread_wakeup_event);
+        statistics.reused_suspend_points += counters.value(suspend_point_reused_event);
+        statistics.created_suspend_points += counters.value(suspend_point_created_event);
+    };
+    // The counters are updated by the slot owners without synchronization, so the snapshot is approximate.
+    for (unsigned i = 0; i < a->my_num_slots; ++i) {
+        for (unsigned level = 0; level < locality_levels_count; ++level) {
+            std::uint64_t steals = a->my_slots[i].steals_count(locality_level(level));
+            statistics.steals_by_locality[level] += steals;
+            statistics.stolen_tasks += steals;
+        }
+        statistics.steals_saved_by_batching += a->my_slots[i].batch_stolen_count();
+        add_counters(a->my_slots[i].counters());
+    }
+    add_counters(a->my_shared_counters);
+    if (a->my_enqueue_latency) {
+        a->my_enqueue_latency->add_to(statistics.enqueue_latency);
+    }
+    if (a->my_migration_latency) {
+        a->my_migration_latency->add_to(statistics.migration_latency);
+    }
+    // The time of the calling thread is charged, so a thread inside the arena sees its own share
+    thread_data* td = governor::get_thread_data_if_initialized();
+    if (td && td->my_arena == a) {
+        td->account_arena_cpu_time();
+    }
+    statistics.cpu_time_ns = a->my_cpu_time.load(std::memory_order_relaxed);
+    statistics.allotted_workers = a->my_num_workers_allotted.load(std::memory_order_relaxed);
+#if __TBB_CO_STACK_POOL_PRESENT
+    statistics.reused_stacks = co_stack_pool::instance().reused_stacks();
+    statistics.mapped_stacks = co_stack_pool::instance().mapped_stacks();
+#endif
+}
+
 void isolate_within_arena(d1::delegate_base& d, std::intptr_t isolation) {
     // TODO: Decide what to do if the scheduler is not initialized. Is there a use case for it?
     thread_data* tls = governor::get_thread_data();
     assert_pointers_valid(tls, tls->my_task_dispatcher);
     task_dispatcher* dispatcher = tls->my_task_dispatcher;
     isolation_type previous_isolation = dispatcher->m_execute_data_ext.isolation;
+    // The tasks of a region with a unique tag are spawned after the region starts, so the owner looks for
+    // them only above the current tail. A tag passed by the caller may be used by the tasks spawned before.
+    arena_slot* slot = isolation ? nullptr : tls->my_arena_slot;
+    isolation_segment outer_segment{};
     try_call([&] {
         // We temporarily change the isolation tag of the currently running task. It will be restored in the destructor of the guard.
         isolation_type current_isolation = isolation ? isolation : reinterpret_cast<isolation_type>(&d);
         // Save the current isolation value and set new one
         previous_isolation = dispatcher->set_isolation(current_isolation);
+        if (slot) {
+            outer_segment = slot->enter_isolation_segment(current_isolation);
+        }
         // Isolation within this callable
         d();
     }).on_completion([&] {
-        __TBB_ASSERT(governor::get_thread_data()->my_task_dispatcher == dispatcher, nullptr);
+        thread_data* td = governor::get_thread_data();
+        __TBB_ASSERT(td->my_task_dispatcher == dispatcher, nullptr);
         dispatcher->set_isolation(previous_isolation);
+        // A resumed region might continue in another slot, which has the segments of its own. The segments
+        // of the original slot were dropped when the region was suspended.
+        if (slot && td->my_arena_slot == slot) {
+            slot->leave_isolation_segment(outer_segment);
+        }
     });
 }
 
@@ -19,6 +19,7 @@
 #define _TBB_arena_H
 
 #include <atomic>
+#include <chrono>
 #include <cstring>
 
 #include "oneapi/tbb/detail/_task.h"
@@ -246,6 +247,70 @@ public:
     }
 };
 
+//! Predicts how soon new work arrives into an arena that has run out of work
+/** Learns the smoothed duration of the recent idle periods of the arena, i.e. the time from the moment
+    the arena is found empty to the arrival of new work. Idle workers wait in the arena only if new work
+    is likely to arrive before the retention limit expires; otherwise, they leave it and sleep at once. **/
+class work_arrival_predictor {
+public:
+    using clock = std::chrono::steady_clock;
+
+    //! The default retention limit, used if it is not set with global_control
+    static constexpr std::size_t default_retention_limit_us = 1000;
+    //! The shortest retention; covers the cost of the wakeup itself
+    static constexpr std::int64_t min_retention_us = 20;
+    //! The weight of the new idle period is 1/smoothing_factor
+    static constexpr std::int64_t smoothing_factor = 8;
+
+    // This method is not thread-safe!
+    // Required to be called after construction.
+    void set_retention_limit(std::chrono::microseconds limit) {
+        my_retention_limit = limit;
+        my_idle_since.store(0, std::memory_order_relaxed);
+        my_mean_idle_us.store(-1, std::memory_order_relaxed);
+    }
+
+    void on_out_of_work(clock::time_point now) {
+        my_idle_since.store(now.time_since_epoch().count(), std::memory_order_relaxed);
+    }
+
+    void on_work_arrival(clock::time_point now) {
+        clock::rep idle_since = my_idle_since.exchange(0, std::memory_order_relaxed);
+        if (idle_since == 0) {
+            // The arena has not been found empty since the previous arrival
+            return;
+        }
+        std::int64_t idle = std::chrono::duration_cast<std::chrono::microseconds>(
+            now - clock::time_point(clock::duration(idle_since))).count();
+        std::int64_t mean = my_mean_idle_us.load(std::memory_order_relaxed);
+        // The races between concurrent updates only lose a sample
+        mean = mean < 0 ? idle : mean + (idle - mean) / smoothing_factor;
+        my_mean_idle_us.store(mean, std::memory_order_relaxed);
+    }
+
+    //! The time an idle worker waits for new work before it leaves the arena
+    std::chrono::microseconds retention_duration() const {
+        std::int64_t mean = my_mean_idle_us.load(std::memory_order_relaxed);
+        if (mean < 0) {
+            // No history yet
+            return my_retention_limit;
+        }
+        if (mean > my_retention_limit.count()) {
+            // The work is not expected soon, so waiting only burns CPU
+            return std::chrono::microseconds(0);
+        }
+        // Twice the expected idle period tolerates the jitter of arrivals
+        return std::chrono::microseconds(min(my_retention_limit.count(), max(2 * mean, std::int64_t(min_retention_us))));
+    }
+
+private:
+    std::chrono::microseconds my_retention_limit{std::chrono::microseconds::rep(default_retention_limit_us)};
+    //! The moment the arena was found empty; zero if new work has arrived since then
+    std::atomic<clock::rep> my_idle_since{0};
+    //! The smoothed duration of the idle periods; negative if there were no idle periods yet
+    std::atomic<std::int64_t> my_mean_idle_us{-1};
+};
+
 //! The structure of an arena, except the array of slots.
 /** Separated in order to simplify padding.
     Intrusive list node base class is used by market to form a list of arenas. **/
@@ -270,6 +335,10 @@ struct arena_base : padded<intrusive_list_node> {
         - the enqueuing thread does not call any of wait_for_all methods. **/
     task_stream<front_accessor> my_fifo_task_stream; // heavy use in stealing loop
 
+    //! Task pool for the enqueued tasks that are taken in the order of their deadlines.
+    /** Such tasks are preferred to the tasks in the FIFO stream. **/
+    deadline_task_stream my_deadline_task_stream;
+
     //! Task pool for the tasks scheduled via tbb::resume() function.
     task_stream<front_accessor> my_resume_task_stream; // heavy use in stealing loop
 
@@ -313,9 +382,19 @@ struct arena_base : padded<intrusive_list_node> {
     //! Manages state of thread_leave state machine
     thread_leave_manager my_thread_leave;
 
+    //! Decides how long idle workers stay in the arena when the retention is allowed
+    work_arrival_predictor my_arrival_predictor;
+
+    //! The number of retained workers parked in their slots
+    std::atomic<unsigned> my_parked_workers;
+
     //! Coroutines (task_dispathers) cache buffer
     arena_co_cache my_co_cache;
 
+    //! The number of C++20 coroutines that wait to be resumed in the arena
+    /** All of them share a single external reference to the arena. **/
+    std::atomic<std::size_t> my_suspended_coroutines;
+
     // arena needs an extra worker despite the arena limit
     atomic_flag my_mandatory_concurrency;
     // the number of local mandatory concurrency requests
@@ -327,9 +406,37 @@ struct arena_base : padded<intrusive_list_node> {
     unsigned my_num_reserved_slots;
     //! The number of workers requested by the external thread owning the arena.
     unsigned my_max_num_workers;
+    //! The number of workers the arena gets before the others are distributed among all arenas.
+    unsigned my_num_guaranteed_workers;
+
+    //! Indicates if thieves prefer victims that are close in the hardware topology.
+    bool my_locality_aware_stealing;
+
+    //! The maximal number of tasks a thief moves into its pool together with a stolen task.
+    /** Zero if batch stealing is disabled. **/
+    std::size_t my_steal_batch_size;
+
+    //! Delays of the enqueued tasks in the queue of the arena.
+    /** nullptr if the enqueue latency tracking is disabled. **/
+    latency_recorder* my_enqueue_latency;
+
+    //! Delays between a worker leaving its previous arena and joining this one.
+    /** nullptr if the migration latency tracking is disabled. **/
+    latency_recorder* my_migration_latency;
+
+    //! Indicates if the CPU time of the threads is accounted while they are in the arena.
+    bool my_cpu_time_accounting;
 
     threading_control_client my_tc_client;
 
+    //! Scheduler events that are not attributed to an arena slot.
+    /** Modified concurrently, so the counters do not share a cache line with other fields. **/
+    alignas(max_nfs_size) scheduler_counters my_shared_counters;
+
+    //! The CPU time in nanoseconds the threads have spent in the arena.
+    /** Charged when a thread leaves the arena. **/
+    std::atomic<std::uint64_t> my_cpu_time;
+
 #if TBB_USE_ASSERT
     //! Used to trap accesses to the object after its destruction.
     std::uintptr_t my_guard;
@@ -402,15 +509,30 @@ public:
 
     void request_workers(int mandatory_delta, int workers_delta, bool wakeup_threads = false);
 
+    //! Blocks the retained worker occupying the slot until new work is advertised or the timeout expires
+    void park_worker(arena_slot& slot, std::chrono::microseconds timeout);
+
+    //! Wakes up one parked worker, if any; returns false if no worker was parked. Does not take locks.
+    bool unpark_worker();
+
     //! If necessary, raise a flag that there is new job in arena.
     template<arena::new_work_type work_type> void advertise_new_work();
 
     //! Attempts to steal a task from a randomly chosen arena slot
-    d1::task* steal_task(unsigned arena_index, FastRandom& frnd, execution_data_ext& ed, isolation_type isolation);
+    d1::task* steal_task(unsigned arena_index, FastRandom& frnd, steal_locality_state& locality_state,
+                         execution_data_ext& ed, isolation_type isolation);
+
+    //! Chooses a victim for stealing, preferring the slots within the current locality level
+    std::size_t select_victim(unsigned arena_index, unsigned slot_num_limit, FastRandom& frnd,
+                              const steal_locality_state& locality_state);
 
     //! Get a task from a global starvation resistant queue
+    /** If the lanes of the stream are bound to NUMA nodes, the lanes of the given node are drained first. **/
     template<task_stream_accessor_type accessor>
-    d1::task* get_stream_task(task_stream<accessor>& stream, unsigned& hint);
+    d1::task* get_stream_task(task_stream<accessor>& stream, unsigned& hint, int numa_node = unknown_numa_node);
+
+    //! Puts the task into the starvation resistant queue, into a lane of the thread's NUMA node if possible
+    void push_to_fifo_stream(d1::task& t, thread_data& td);
 
 #if __TBB_CRITICAL_TASKS
     //! Tries to find a critical task in global critical task stream
@@ -423,6 +545,30 @@ public:
     //! enqueue a task into starvation-resistance queue
     void enqueue_task(d1::task&, d1::task_group_context&, thread_data&);
 
+    //! enqueue a task that is taken before the enqueued tasks with later deadlines
+    /** The deadline is the number of nanoseconds since the epoch of std::chrono::steady_clock. **/
+    void enqueue_task(d1::task&, d1::task_group_context&, thread_data&, std::int64_t deadline);
+
+    //! Timestamps the task put into the starvation-resistant queue if the latency is tracked
+    void mark_enqueue_time(d1::task& t) {
+        task_accessor::enqueue_time(t) = my_enqueue_latency ? enqueue_clock_now() : 0;
+    }
+
+    //! Accounts the time the task taken from the starvation-resistant queue spent there
+    void record_enqueue_latency(d1::task& t) {
+        std::uint64_t& enqueue_time = task_accessor::enqueue_time(t);
+        if (enqueue_time != 0 && my_enqueue_latency) {
+            std::uint64_t now = enqueue_clock_now();
+            my_enqueue_latency->record(now > enqueue_time ? now - enqueue_time : 0);
+            enqueue_time = 0;
+        }
+    }
+
+    static std::uint64_t enqueue_clock_now() {
+        return std::uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+
     //! Registers the worker with the arena and enters TBB scheduler dispatch loop
     void process(thread_data&);
 
@@ -430,9 +576,24 @@ public:
 
     void on_thread_leaving(unsigned ref_param);
 
+    //! Notification that a C++20 coroutine is suspended to be resumed in the arena
+    void on_coroutine_suspended();
+
+    //! Notification that the task resuming a C++20 coroutine is enqueued into the arena
+    void on_coroutine_resumed();
+
     //! Check for the presence of enqueued tasks
     bool has_enqueued_tasks();
 
+private:
+    //! Binds the task to be enqueued to its context and the arena
+    void prepare_enqueued_task(d1::task&, d1::task_group_context&, thread_data&);
+
+    //! Accounts the enqueued task and requests threads to process it
+    void on_task_enqueued(thread_data&);
+
+public:
+
     //! Check for the presence of any tasks
     bool has_tasks();
 
@@ -441,6 +602,8 @@ public:
     thread_control_monitor& get_waiting_threads_monitor();
 
     static const std::size_t out_of_arena = ~size_t(0);
+    //! The number of random victims checked at a locality level before the steal attempt is failed
+    static constexpr unsigned locality_victim_probes = 4;
     //! Tries to occupy a slot in the arena. On success, returns the slot index; if no slot is available, returns out_of_arena.
     template <bool as_worker>
     std::size_t occupy_free_slot(thread_data&);
@@ -512,32 +675,65 @@ void arena::advertise_new_work() {
         }
 
         my_thread_leave.reset_if_needed();
+        if (are_workers_needed) {
+            my_arrival_predictor.on_work_arrival(work_arrival_predictor::clock::now());
+        }
         request_workers(mandatory_delta, workers_delta, /* wakeup_threads = */ true);
     }
 }
 
-inline d1::task* arena::steal_task(unsigned arena_index, FastRandom& frnd, execution_data_ext& ed, isolation_type isolation) {
+inline std::size_t arena::select_victim(unsigned arena_index, unsigned slot_num_limit, FastRandom& frnd,
+                                        const steal_locality_state& locality_state)
+{
+    auto random_victim = [&] {
+        std::size_t k = frnd.get() % (slot_num_limit - 1);
+        // The following condition excludes the external thread that might have
+        // already taken our previous place in the arena from the list .
+        // of potential victims. But since such a situation can take
+        // place only in case of significant oversubscription, keeping
+        // the checks simple seems to be preferable to complicating the code.
+        if (k >= arena_index) {
+            ++k; // Adjusts random distribution to exclude self
+        }
+        return k;
+    };
+    locality_type own_locality = my_slots[arena_index].locality();
+    if (!my_locality_aware_stealing || own_locality == unknown_locality || locality_state.level == system_level) {
+        return random_victim();
+    }
+    // Look for a victim within the current locality level. The number of probes is bounded;
+    // if all of them miss, a uniformly random victim is tried, so that every steal attempt
+    // visits a victim and only failed steals move the search outward.
+    for (unsigned probe = 0; probe < locality_victim_probes; ++probe) {
+        std::size_t k = random_victim();
+        if (locality_distance(own_locality, my_slots[k].locality()) <= locality_state.level) {
+            return k;
+        }
+    }
+    return random_victim();
+}
+
+inline d1::task* arena::steal_task(unsigned arena_index, FastRandom& frnd, steal_locality_state& locality_state,
+                                   execution_data_ext& ed, isolation_type isolation)
+{
     auto slot_num_limit = my_limit.load(std::memory_order_relaxed);
     if (slot_num_limit == 1) {
         // No slots to steal from
         return nullptr;
     }
     // Try to steal a task from a random victim.
-    std::size_t k = frnd.get() % (slot_num_limit - 1);
-    // The following condition excludes the external thread that might have
-    // already taken our previous place in the arena from the list .
-    // of potential victims. But since such a situation can take
-    // place only in case of significant oversubscription, keeping
-    // the checks simple seems to be preferable to complicating the code.
-    if (k >= arena_index) {
-        ++k; // Adjusts random distribution to exclude self
-    }
+    std::size_t k = select_victim(arena_index, slot_num_limit, frnd, locality_state);
+    arena_slot& own_slot = my_slots[arena_index];
     arena_slot* victim = &my_slots[k];
     d1::task **pool = victim->task_pool.load(std::memory_order_relaxed);
     d1::task *t = nullptr;
-    if (pool == EmptyTaskPool || !(t = victim->steal_task(*this, isolation, k))) {
+    if (pool == EmptyTaskPool || !(t = victim->steal_task(*this, isolation, k, own_slot))) {
+        locality_state.on_failure();
+        own_slot.count(steal_failed_event);
         return nullptr;
     }
+    own_slot.count_steal(locality_distance(own_slot.locality(), victim->locality()));
+    locality_state.on_success();
     if (task_accessor::is_proxy_task(*t)) {
         task_proxy &tp = *(task_proxy*)t;
         d1::slot_id slot = tp.slot;
@@ -559,9 +755,14 @@ inline d1::task* arena::steal_task(unsigned arena_index, FastRandom& frnd, execu
 }
 
 template<task_stream_accessor_type accessor>
-inline d1::task* arena::get_stream_task(task_stream<accessor>& stream, unsigned& hint) {
+inline d1::task* arena::get_stream_task(task_stream<accessor>& stream, unsigned& hint, int numa_node) {
     if (stream.empty())
         return nullptr;
+    if (numa_node != unknown_numa_node && stream.is_partitioned()) {
+        // Remote lanes are visited only when the local ones are empty
+        if (d1::task* t = stream.pop_local(unsigned(numa_node), subsequent_lane_selector(hint)))
+            return t;
+    }
     return stream.pop(subsequent_lane_selector(hint));
 }
 
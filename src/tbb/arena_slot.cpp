@@ -26,6 +26,272 @@ namespace r1 {
 //------------------------------------------------------------------------
 // Arena Slot
 //------------------------------------------------------------------------
+#if __TBB_LOCK_FREE_TASK_POOL
+// The lock-free variant of the task pool is a Chase-Lev work-stealing deque
+// (see "Correct and Efficient Work-Stealing for Weak Memory Models" by N.M. Le et al.).
+// The owner pushes and takes tasks at the tail, thieves take tasks at the head by CAS.
+// The indices grow monotonically and are mapped onto the circular buffer. As in the locked
+// variant, the tasks that do not satisfy the isolation constraint are left in place: a thief
+// checks the isolation kept in the cell before claiming the task. To take a task below the tail
+// that is not at the head, the owner or a thief locks the head and leaves a hole in place of the
+// task. The owner waits while a thief holds the lock, since the thief may take any task up to
+// the tail it has read.
+
+static d1::task* task_of_cell(std::uintptr_t cell_value) {
+    return reinterpret_cast<d1::task*>(cell_value & ~proxy_task_tag);
+}
+
+d1::task* arena_slot::pop_task(bool& is_empty) {
+    std::size_t T = tail.load(std::memory_order_relaxed) - 1;
+    tail.store(T, std::memory_order_relaxed);
+    // The full fence is required to sync the store of `tail` with the load of `head` (write-read barrier).
+    // A thief that locked the head before it might not observe the new tail, so it is waited for.
+    atomic_fence_seq_cst();
+    std::size_t H = unlocked_head();
+    if (std::intptr_t(T - H) < 0) {
+        // The deque is empty; restore the tail.
+        tail.store(H, std::memory_order_relaxed);
+        is_empty = true;
+        return nullptr;
+    }
+    std::uintptr_t result = task_pool_cell(T).task.load(std::memory_order_relaxed);
+    if (T == H) {
+        // The last task is being taken; arbitrate with thieves.
+        if (!head.compare_exchange_strong(H, H + 1)) {
+            result = 0;
+        }
+        tail.store(T + 1, std::memory_order_relaxed);
+    }
+    return task_of_cell(result);
+}
+
+d1::task* arena_slot::get_task_in_place(execution_data_ext& ed, isolation_type isolation, std::size_t base) {
+    std::size_t H = lock_head();
+    const std::size_t T = tail.load(std::memory_order_relaxed);
+    // The tasks below the base of the segment of an isolated region belong to the enclosing regions
+    const std::size_t lowest = base && std::intptr_t(base - H) > 0 ? base : H;
+    d1::task* result = nullptr;
+    std::size_t new_head = H;
+    for (std::size_t i = T; std::intptr_t(i - lowest) > 0 && !result; ) {
+        task_pool_cell_data& cell = task_pool_cell(--i);
+        std::uintptr_t value = cell.task.load(std::memory_order_relaxed);
+        if (!value || isolation != cell.isolation.load(std::memory_order_relaxed)) {
+            continue;
+        }
+        // No one else can take the task while the head is locked
+        d1::task* t = task_of_cell(value);
+        if (value & proxy_task_tag) {
+            task_proxy& tp = static_cast<task_proxy&>(*t);
+            d1::slot_id aff_id = tp.slot;
+            if ((result = tp.extract_task<task_proxy::pool_bit>())) {
+                ed.affinity_slot = aff_id;
+            } else {
+                // Proxy was empty, so it's our responsibility to free it
+                tp.allocator.delete_object(&tp, ed);
+            }
+        } else {
+            result = t;
+        }
+        if (i == H) {
+            // A thief may have read this cell before the lock, so the head is moved past it instead of
+            // leaving a hole. Otherwise, the claim of the thief would succeed once the head is restored.
+            new_head = H + 1;
+        } else {
+            cell.task.store(0, std::memory_order_relaxed);
+        }
+    }
+    // The release store makes the holes visible to the thieves that acquire the head
+    head.store(new_head, std::memory_order_release);
+    if (!result && std::intptr_t(T - new_head) <= 0) {
+        // No tasks in the task pool.
+        leave_task_pool();
+    }
+    return result;
+}
+
+d1::task* arena_slot::get_task(execution_data_ext& ed, isolation_type isolation) {
+    __TBB_ASSERT(is_task_pool_published(), nullptr);
+    // The tasks below the base of the segment of an isolated region belong to the enclosing regions.
+    const std::size_t base = isolation_segment_base(isolation);
+    d1::task* result = nullptr;
+    while (!base || std::intptr_t(tail.load(std::memory_order_relaxed) - base) > 0) {
+        // The cell at the tail is read without a claim. A thief may leave a hole in it meanwhile,
+        // which pop_task reports.
+        task_pool_cell_data& last = task_pool_cell(tail.load(std::memory_order_relaxed) - 1);
+        if (isolation != no_isolation && last.task.load(std::memory_order_relaxed) &&
+            isolation != last.isolation.load(std::memory_order_relaxed))
+        {
+            // The task at the tail cannot be executed due to isolation, so it is skipped in place.
+            // The cell of an empty deque may be checked as well, which does no harm.
+            result = get_task_in_place(ed, isolation, base);
+            break;
+        }
+        bool is_empty = false;
+        d1::task* t = pop_task(is_empty);
+        if (is_empty) {
+            // No tasks in the task pool.
+            leave_task_pool();
+            break;
+        }
+        if (!t) {
+            // A hole, or the last task has been taken by a thief
+            continue;
+        }
+        if (!task_accessor::is_proxy_task(*t)) {
+            result = t;
+            break;
+        }
+        task_proxy& tp = static_cast<task_proxy&>(*t);
+        d1::slot_id aff_id = tp.slot;
+        if (d1::task* extracted = tp.extract_task<task_proxy::pool_bit>()) {
+            ed.affinity_slot = aff_id;
+            result = extracted;
+            break;
+        }
+        // Proxy was empty, so it's our responsibility to free it
+        tp.allocator.delete_object(&tp, ed);
+    }
+    check_isolation_segment();
+    return result;
+}
+
+d1::task* arena_slot::steal_head_task(isolation_type isolation, bool& is_left_in_place) {
+    for (;;) {
+        std::size_t H = head.load(std::memory_order_acquire);
+        if (H == locked_head) {
+            // A task is being taken out of order
+            return nullptr;
+        }
+        // The full fence is required to sync the load of `head` with the load of `tail`
+        atomic_fence_seq_cst();
+        std::size_t T = tail.load(std::memory_order_acquire);
+        if (std::intptr_t(T - H) <= 0) {
+            return nullptr;
+        }
+        // The pool pointer is read after the tail to observe the buffer the task at H was put to.
+        d1::task** victim_pool = task_pool.load(std::memory_order_acquire);
+        if (victim_pool == EmptyTaskPool) {
+            return nullptr;
+        }
+        __TBB_ASSERT(victim_pool != LockedTaskPool, "The lock-free task pool cannot be locked");
+        // The cell is not changed while the head stays at H, so the checks below hold if the claim succeeds.
+        task_pool_cell_data& cell = get_task_pool_cells(victim_pool)[H & (get_task_pool_header(victim_pool).size - 1)];
+        std::uintptr_t value = cell.task.load(std::memory_order_relaxed);
+        if (value) {
+            // A proxy might be released as soon as someone else claims it, so it is inspected under the lock only
+            if ((isolation != no_isolation && isolation != cell.isolation.load(std::memory_order_relaxed)) ||
+                (value & proxy_task_tag))
+            {
+                is_left_in_place = true;
+                return nullptr;
+            }
+        }
+        if (!head.compare_exchange_strong(H, H + 1)) {
+            // Another thief or the owner has taken the task
+            return nullptr;
+        }
+        if (value) {
+            d1::task* result = task_of_cell(value);
+            assert_task_valid(result);
+            return result;
+        }
+        // A hole has been passed; look at the next task
+    }
+}
+
+d1::task* arena_slot::steal_task_in_place(arena& a, isolation_type isolation, std::size_t slot_index, bool& tasks_omitted) {
+    std::size_t H = head.load(std::memory_order_relaxed);
+    if (H == locked_head || !head.compare_exchange_strong(H, locked_head)) {
+        // Someone else takes a task; give up as the locked task pool does on a failed steal
+        return nullptr;
+    }
+    // The full fence is required to sync the lock of `head` with the load of `tail`. The owner that
+    // has not observed the lock is not going to take the tasks below the observed tail.
+    atomic_fence_seq_cst();
+    const std::size_t T = tail.load(std::memory_order_acquire);
+    // The owner does not replace the buffer while the head is locked
+    d1::task** victim_pool = task_pool.load(std::memory_order_acquire);
+    d1::task* result = nullptr;
+    std::size_t new_head = H;
+    if (victim_pool != EmptyTaskPool) {
+        const std::size_t size = get_task_pool_header(victim_pool).size;
+        for (std::size_t i = H; std::intptr_t(T - i) > 0 && !result; ++i) {
+            task_pool_cell_data& cell = get_task_pool_cells(victim_pool)[i & (size - 1)];
+            std::uintptr_t value = cell.task.load(std::memory_order_relaxed);
+            if (!value) {
+                // The holes in front of the skipped tasks are passed
+                if (i == new_head) {
+                    ++new_head;
+                }
+                continue;
+            }
+            if (isolation != no_isolation && isolation != cell.isolation.load(std::memory_order_relaxed)) {
+                tasks_omitted = true;
+                continue;
+            }
+            // No one else can take the task while the head is locked, so the proxy can be inspected
+            if (value & proxy_task_tag) {
+                task_proxy& tp = static_cast<task_proxy&>(*task_of_cell(value));
+                // If mailed task is likely to be grabbed by its destination thread, skip it.
+                if (task_proxy::is_shared(tp.task_and_tag) && tp.outbox->recipient_is_idle() && !a.mailbox(slot_index).recipient_is_idle()) {
+                    tasks_omitted = true;
+                    continue;
+                }
+            }
+            result = task_of_cell(value);
+            assert_task_valid(result);
+            if (i == new_head) {
+                // A thief may have read this cell before the lock, so the head is moved past it
+                ++new_head;
+            } else {
+                cell.task.store(0, std::memory_order_relaxed);
+            }
+        }
+    }
+    // The release store makes the holes visible to the owner and the thieves that acquire the head
+    head.store(new_head, std::memory_order_release);
+    return result;
+}
+
+d1::task* arena_slot::steal_task(arena& a, isolation_type isolation, std::size_t slot_index, arena_slot& thief_slot) {
+    bool is_left_in_place = false;
+    d1::task* result = steal_head_task(isolation, is_left_in_place);
+    bool tasks_omitted = false;
+    if (is_left_in_place) {
+        // The task at the head cannot be claimed without inspection, so look further under the lock.
+        result = steal_task_in_place(a, isolation, slot_index, tasks_omitted);
+    }
+    if (!result) {
+        return nullptr;
+    }
+
+    std::size_t batch_limit = a.my_steal_batch_size;
+    if (batch_limit && !tasks_omitted) {
+        // Take up to half of the remaining tasks. A range of cells cannot be claimed by a single CAS
+        // because the owner takes tasks without CAS unless the last one is left, so the tasks are
+        // claimed one by one. As in the locked task pool, the batch ends at the first task that
+        // cannot be moved into our pool due to isolation or because it is a proxy.
+        std::intptr_t remaining = std::intptr_t(tail.load(std::memory_order_relaxed) - head.load(std::memory_order_relaxed));
+        batch_limit = remaining > 1 ? min(batch_limit, std::size_t(remaining / 2)) : 0;
+        d1::task* batch[max_steal_batch_size];
+        std::size_t batch_size = 0;
+        while (batch_size < batch_limit) {
+            bool is_batch_end = false;
+            d1::task* t = steal_head_task(isolation, is_batch_end);
+            if (!t) {
+                break;
+            }
+            batch[batch_size++] = t;
+        }
+        if (batch_size) {
+            thief_slot.spawn(batch, batch_size);
+            thief_slot.count_batch_steal(batch_size);
+            a.advertise_new_work<arena::work_spawned>();
+        }
+    }
+    return result;
+}
+#else /* !__TBB_LOCK_FREE_TASK_POOL */
 d1::task* arena_slot::get_task_impl(size_t T, execution_data_ext& ed, bool& tasks_omitted, isolation_type isolation) {
     __TBB_ASSERT(tail.load(std::memory_order_relaxed) <= T || is_local_task_pool_quiescent(),
             "Is it safe to get a task at position T?");
@@ -61,8 +327,16 @@ d1::task* arena_slot::get_task_impl(size_t T, execution_data_ext& ed, bool& task
 
 d1::task* arena_slot::get_task(execution_data_ext& ed, isolation_type isolation) {
     __TBB_ASSERT(is_task_pool_published(), nullptr);
+    // The tasks below the base of the segment of an isolated region belong to the enclosing regions,
+    // so they are neither examined nor skipped.
+    const std::size_t base = isolation_segment_base(isolation);
     // The current task position in the task pool.
     std::size_t T0 = tail.load(std::memory_order_relaxed);
+    __TBB_ASSERT(base <= T0, "The tail has dropped below the base of the isolation segment");
+    if ( base && T0 == base ) {
+        // No tasks of the isolated region in the task pool.
+        return nullptr;
+    }
     // The bounds of available tasks in the task pool. H0 is only used when the head bound is reached.
     std::size_t H0 = (std::size_t)-1, T = T0;
     d1::task* result = nullptr;
@@ -106,7 +380,7 @@ d1::task* arena_slot::get_task(execution_data_ext& ed, isolation_type isolation)
             __TBB_ASSERT( T0 == T+1, nullptr );
             T0 = T;
         }
-    } while ( !result && !task_pool_empty );
+    } while ( !result && !task_pool_empty && !(base && T == base) );
 
     if ( tasks_omitted ) {
         if ( task_pool_empty ) {
@@ -130,10 +404,13 @@ d1::task* arena_slot::get_task(execution_data_ext& ed, isolation_type isolation)
                 ed.task_disp->m_thread_data->my_arena->advertise_new_work<arena::wakeup>();
             }
         } else {
-            // A task has been obtained. We need to make a hole in position T.
+            // Either a task has been obtained, and we need to make a hole in position T,
+            // or all the tasks of the isolation segment have been checked.
             __TBB_ASSERT( is_task_pool_published(), nullptr );
-            __TBB_ASSERT( result, nullptr );
-            task_pool_ptr[T] = nullptr;
+            __TBB_ASSERT( result || T == base, nullptr );
+            if ( result ) {
+                task_pool_ptr[T] = nullptr;
+            }
             tail.store(T0, std::memory_order_release);
             // Synchronize with snapshot as we published some tasks.
             // TODO: consider some approach not to call wakeup for each time. E.g. check if the tail reached the head.
@@ -142,11 +419,12 @@ d1::task* arena_slot::get_task(execution_data_ext& ed, isolation_type isolation)
     }
 
     __TBB_ASSERT( (std::intptr_t)tail.load(std::memory_order_relaxed) >= 0, nullptr );
-    __TBB_ASSERT( result || tasks_omitted || is_quiescent_local_task_pool_reset(), nullptr );
+    __TBB_ASSERT( result || tasks_omitted || (base && T == base) || is_quiescent_local_task_pool_reset(), nullptr );
+    check_isolation_segment();
     return result;
 }
 
-d1::task* arena_slot::steal_task(arena& a, isolation_type isolation, std::size_t slot_index) {
+d1::task* arena_slot::steal_task(arena& a, isolation_type isolation, std::size_t slot_index, arena_slot& thief_slot) {
     d1::task** victim_pool = lock_task_pool();
     if (!victim_pool) {
         return nullptr;
@@ -155,6 +433,8 @@ d1::task* arena_slot::steal_task(arena& a, isolation_type isolation, std::size_t
     std::size_t H = head.load(std::memory_order_relaxed); // mirror
     std::size_t H0 = H;
     bool tasks_omitted = false;
+    d1::task* batch[max_steal_batch_size];
+    std::size_t batch_size = 0;
     do {
         // The full fence is required to sync the store of `head` with the load of `tail` (write-read barrier)
         H = ++head;
@@ -199,6 +479,28 @@ d1::task* arena_slot::steal_task(arena& a, isolation_type isolation, std::size_t
         victim_pool[H-1] = nullptr;
         // The release store synchronizes the victim_pool update(the store of nullptr).
         head.store( /*dead: H = */ H0, std::memory_order_release );
+    } else if (std::size_t batch_limit = a.my_steal_batch_size) {
+        // While the pool is locked, take up to half of the remaining tasks. The batch ends at the first
+        // task that cannot be moved into our pool, so the consumed part of the pool stays contiguous.
+        std::intptr_t remaining = std::intptr_t(tail.load(std::memory_order_acquire)) - std::intptr_t(H);
+        batch_limit = remaining > 1 ? min(batch_limit, std::size_t(remaining / 2)) : 0;
+        while (batch_size < batch_limit) {
+            // The same arbitration with the owner as for the first task
+            H = ++head;
+            if ((std::intptr_t)H > (std::intptr_t)(tail.load(std::memory_order_acquire))) {
+                head.store(H - 1, std::memory_order_relaxed);
+                break;
+            }
+            d1::task* t = victim_pool[H-1];
+            __TBB_ASSERT( !is_poisoned( t ), nullptr );
+            if (!t || task_accessor::is_proxy_task(*t) ||
+                (isolation != no_isolation && isolation != task_accessor::isolation(*t))) {
+                head.store(H - 1, std::memory_order_relaxed);
+                break;
+            }
+            poison_pointer( victim_pool[H-1] );
+            batch[batch_size++] = t;
+        }
     }
 unlock:
     unlock_task_pool(victim_pool);
@@ -210,9 +512,14 @@ unlock:
     if (tasks_omitted) {
         // Synchronize with snapshot as the head and tail can be bumped which can falsely trigger EMPTY state
         a.advertise_new_work<arena::wakeup>();
+    } else if (batch_size) {
+        thief_slot.spawn(batch, batch_size);
+        thief_slot.count_batch_steal(batch_size);
+        a.advertise_new_work<arena::work_spawned>();
     }
     return result;
 }
+#endif /* !__TBB_LOCK_FREE_TASK_POOL */
 
 } // namespace r1
 } // namespace detail
@@ -28,6 +28,9 @@
 #include "misc.h"
 #include "mailbox.h"
 #include "scheduler_common.h"
+#include "thread_locality.h"
+#include "scheduler_counters.h"
+#include "parking_slot.h"
 
 #include <atomic>
 
@@ -45,6 +48,54 @@ class task_group_context;
 static d1::task** const EmptyTaskPool  = nullptr;
 static d1::task** const LockedTaskPool = reinterpret_cast<d1::task**>(~std::intptr_t(0));
 
+#if __TBB_LOCK_FREE_TASK_POOL
+//! Header stored in front of each task pool buffer of the lock-free deque.
+/** Thieves may still read a buffer after the owner has replaced it by a larger one,
+    so replaced buffers are chained and released only together with the slot. **/
+struct task_pool_header {
+    //! The buffer that was replaced by this one (if any)
+    d1::task** retired_pool;
+    //! Capacity of the buffer (always a power of two)
+    std::size_t size;
+};
+
+inline task_pool_header& get_task_pool_header(d1::task** pool) {
+    return reinterpret_cast<task_pool_header*>(pool)[-1];
+}
+
+//! Element of the buffer of the lock-free deque
+/** The isolation and the kind of the task are kept next to it, so a thief decides whether it can
+    take the task before claiming it, i.e. without accessing a task that might be already taken. **/
+struct task_pool_cell_data {
+    //! The task, tagged by proxy_task_tag for a task proxy; zero for a hole left by the owner
+    std::atomic<std::uintptr_t> task;
+    std::atomic<isolation_type> isolation;
+};
+
+static constexpr std::uintptr_t proxy_task_tag = 1;
+static_assert(alignof(d1::task) > proxy_task_tag, "The tag does not fit the alignment of tasks");
+
+inline task_pool_cell_data* get_task_pool_cells(d1::task** pool) {
+    return reinterpret_cast<task_pool_cell_data*>(pool);
+}
+
+//! The value of the head while a task is taken out of order
+/** The owner and a thief lock the head to take a task below the tail that is not at the head. Other
+    thieves do not claim tasks while the head has this value, and the owner waits until it is restored.
+    When the index of the head reaches this value after a wrap around, the thieves only wait until
+    the owner takes the task at it. **/
+static constexpr std::size_t locked_head = ~std::size_t(0);
+#endif /* __TBB_LOCK_FREE_TASK_POOL */
+
+//! The part of a task pool that holds the tasks of an isolated region of the owner thread
+/** The tasks spawned by the owner within the region are located at or above the base. The base is
+    valid only while the epoch matches the epoch of the slot. **/
+struct isolation_segment {
+    isolation_type isolation;
+    std::size_t base;
+    std::uintptr_t epoch;
+};
+
 struct alignas(max_nfs_size) arena_slot_shared_state {
     //! Scheduler of the thread attached to the slot
     /** Marks the slot as busy, and is used to iterate through the schedulers belonging to this arena **/
@@ -53,12 +104,23 @@ struct alignas(max_nfs_size) arena_slot_shared_state {
     // Synchronization of access to Task pool
     /** Also is used to specify if the slot is empty or locked:
          0 - empty
-        -1 - locked **/
+        -1 - locked
+        With the lock-free task pool the locked state is never used. **/
     std::atomic<d1::task**> task_pool;
 
     //! Index of the first ready task in the deque.
-    /** Modified by thieves, and by the owner during compaction/reallocation **/
+    /** Modified by thieves, and by the owner during compaction/reallocation.
+        With the lock-free task pool the index only grows and is advanced by CAS. The owner
+        replaces it by locked_head for the duration of taking a task out of order. **/
     std::atomic<std::size_t> head;
+
+    //! Location of the thread attached to the slot in the hardware topology
+    /** Set only if the arena uses locality aware stealing, read by thieves. **/
+    std::atomic<locality_type> my_locality;
+
+    //! The retained worker occupying the slot blocks here while waiting for new work
+    /** Unparked by the thread that advertises new work in the arena. **/
+    parking_slot my_parking_slot;
 };
 
 struct alignas(max_nfs_size) arena_slot_private_state {
@@ -84,6 +146,24 @@ struct alignas(max_nfs_size) arena_slot_private_state {
     //! Task pool of the scheduler that owns this slot
     // TODO: previously was task**__TBB_atomic, but seems like not accessed on other thread
     d1::task** task_pool_ptr;
+
+    //! The segment of the task pool of the innermost isolated region of the owner thread.
+    isolation_segment my_isolation_segment;
+
+    //! Incremented when the tasks below the base of the current segment are taken or relocated.
+    /** Invalidates all the segments recorded before. **/
+    std::uintptr_t my_isolation_segment_epoch;
+
+    //! The number of tasks stolen by the owner thread, per distance to the victim.
+    /** Modified by the owner thread, read when arena statistics are collected. **/
+    std::atomic<std::uint64_t> my_steals_by_locality[locality_levels_count];
+
+    //! The number of tasks moved by the owner thread into its pool in addition to the stolen ones.
+    /** Each of them is a steal saved by batch stealing. Modified by the owner thread. **/
+    std::atomic<std::uint64_t> my_batch_stolen_tasks;
+
+    //! Scheduler events of the owner thread, read when arena statistics are collected.
+    scheduler_counters my_counters;
 };
 
 class arena_slot : private arena_slot_shared_state, private arena_slot_private_state {
@@ -107,6 +187,43 @@ class arena_slot : private arena_slot_shared_state, private arena_slot_private_s
 
     static constexpr std::size_t min_task_pool_size = 64;
 
+    //! The upper bound of the number of tasks a thief moves into its pool in addition to the stolen one
+    static constexpr std::size_t max_steal_batch_size = 32;
+
+#if __TBB_LOCK_FREE_TASK_POOL
+    static_assert(sizeof(task_pool_header) <= max_nfs_size, "Task pool header does not fit its padding");
+
+    //! Allocates a buffer of at least n elements; the capacity is rounded up to a power of two.
+    static d1::task** allocate_lock_free_pool( std::size_t n, d1::task** retired_pool ) {
+        std::size_t size = min_task_pool_size;
+        while ( size < n ) size *= 2;
+        char* storage = (char*)cache_aligned_allocate(max_nfs_size + size * sizeof(task_pool_cell_data));
+        d1::task** pool = reinterpret_cast<d1::task**>(storage + max_nfs_size);
+        get_task_pool_header(pool) = task_pool_header{ retired_pool, size };
+        return pool;
+    }
+
+    static void deallocate_lock_free_pool( d1::task** pool ) {
+        cache_aligned_deallocate(reinterpret_cast<char*>(pool) - max_nfs_size);
+    }
+
+    void allocate_task_pool( std::size_t n ) {
+        task_pool_ptr = allocate_lock_free_pool(n, nullptr);
+        my_task_pool_size = get_task_pool_header(task_pool_ptr).size;
+    }
+
+    //! The element of the circular buffer that corresponds to the deque index i
+    task_pool_cell_data& task_pool_cell( std::size_t i ) {
+        return get_task_pool_cells(task_pool_ptr)[i & (my_task_pool_size - 1)];
+    }
+
+    void put_task( std::size_t i, d1::task* t ) {
+        task_pool_cell_data& cell = task_pool_cell(i);
+        std::uintptr_t tag = task_accessor::is_proxy_task(*t) ? proxy_task_tag : 0;
+        cell.isolation.store(task_accessor::isolation(*t), std::memory_order_relaxed);
+        cell.task.store(reinterpret_cast<std::uintptr_t>(t) | tag, std::memory_order_relaxed);
+    }
+#else
     void allocate_task_pool( std::size_t n ) {
         std::size_t byte_size = ((n * sizeof(d1::task*) + max_nfs_size - 1) / max_nfs_size) * max_nfs_size;
         my_task_pool_size = byte_size / sizeof(d1::task*);
@@ -116,6 +233,12 @@ class arena_slot : private arena_slot_shared_state, private arena_slot_private_s
         fill_with_canary_pattern( 0, my_task_pool_size );
     }
 
+    void put_task( std::size_t i, d1::task* t ) {
+        __TBB_ASSERT(is_poisoned(task_pool_ptr[i]), nullptr);
+        task_pool_ptr[i] = t;
+    }
+#endif /* __TBB_LOCK_FREE_TASK_POOL */
+
 public:
     //! Deallocate task pool that was allocated by means of allocate_task_pool.
     void free_task_pool( ) {
@@ -123,7 +246,15 @@ public:
         // __TBB_ASSERT( !task_pool /* TODO: == EmptyTaskPool */, nullptr);
         if( task_pool_ptr ) {
            __TBB_ASSERT( my_task_pool_size, nullptr);
+#if __TBB_LOCK_FREE_TASK_POOL
+           while ( task_pool_ptr ) {
+               d1::task** retired_pool = get_task_pool_header(task_pool_ptr).retired_pool;
+               deallocate_lock_free_pool( task_pool_ptr );
+               task_pool_ptr = retired_pool;
+           }
+#else
            cache_aligned_deallocate( task_pool_ptr );
+#endif
            task_pool_ptr = nullptr;
            my_task_pool_size = 0;
         }
@@ -136,7 +267,9 @@ public:
     d1::task* get_task(execution_data_ext&, isolation_type);
 
     //! Steal task from slot's ready pool
-    d1::task* steal_task(arena&, isolation_type, std::size_t);
+    /** The last argument is the slot of the stealing thread. If the arena uses batch stealing,
+        a part of the remaining tasks is moved into that slot as well. **/
+    d1::task* steal_task(arena&, isolation_type, std::size_t, arena_slot&);
 
     //! Some thread is now the owner of this slot
     void occupy() {
@@ -152,33 +285,112 @@ public:
     //! Some thread is now the owner of this slot
     void release() {
         __TBB_ASSERT(my_is_occupied.load(std::memory_order_relaxed), nullptr);
+        // The next owner does not continue the isolated regions of this one
+        reset_isolation_segment();
         my_is_occupied.store(false, std::memory_order_release);
     }
 
     //! Spawn newly created tasks
     void spawn(d1::task& t) {
         std::size_t T = prepare_task_pool(1);
-        __TBB_ASSERT(is_poisoned(task_pool_ptr[T]), nullptr);
-        task_pool_ptr[T] = &t;
+        put_task(T, &t);
         commit_spawned_tasks(T + 1);
         if (!is_task_pool_published()) {
             publish_task_pool();
         }
     }
 
+    //! Spawn the tasks in the given order, so the last one is taken first by the owner
+    void spawn(d1::task** tasks, std::size_t n) {
+        std::size_t T = prepare_task_pool(n);
+        for (std::size_t i = 0; i < n; ++i) {
+            put_task(T + i, tasks[i]);
+        }
+        commit_spawned_tasks(T + n);
+        if (!is_task_pool_published()) {
+            publish_task_pool();
+        }
+    }
+
     bool is_task_pool_published() const {
         return task_pool.load(std::memory_order_relaxed) != EmptyTaskPool;
     }
 
     bool is_empty() const {
+#if __TBB_LOCK_FREE_TASK_POOL
+        // The indices grow monotonically, so compare their difference to be tolerant to wrap around.
+        return task_pool.load(std::memory_order_relaxed) == EmptyTaskPool ||
+               std::intptr_t(tail.load(std::memory_order_relaxed) - head.load(std::memory_order_relaxed)) <= 0;
+#else
         return task_pool.load(std::memory_order_relaxed) == EmptyTaskPool ||
                head.load(std::memory_order_relaxed) >= tail.load(std::memory_order_relaxed);
+#endif
     }
 
     bool is_occupied() const {
         return my_is_occupied.load(std::memory_order_relaxed);
     }
 
+    void set_locality(locality_type l) {
+        my_locality.store(l, std::memory_order_relaxed);
+    }
+
+    locality_type locality() const {
+        return my_locality.load(std::memory_order_relaxed);
+    }
+
+    //! Accounts a task stolen by the owner thread
+    void count_steal(locality_level level) {
+        // Only the owner modifies the counter, so the read-modify-write does not need to be atomic.
+        std::atomic<std::uint64_t>& counter = my_steals_by_locality[level];
+        counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+
+    std::uint64_t steals_count(locality_level level) const {
+        return my_steals_by_locality[level].load(std::memory_order_relaxed);
+    }
+
+    //! Accounts the tasks moved by the owner thread together with a stolen task
+    void count_batch_steal(std::size_t num_tasks) {
+        my_batch_stolen_tasks.store(my_batch_stolen_tasks.load(std::memory_order_relaxed) + num_tasks,
+                                    std::memory_order_relaxed);
+    }
+
+    std::uint64_t batch_stolen_count() const {
+        return my_batch_stolen_tasks.load(std::memory_order_relaxed);
+    }
+
+    //! Accounts a scheduler event of the owner thread
+    void count(scheduler_event e) {
+        my_counters.count(e);
+    }
+
+    const scheduler_counters& counters() const {
+        return my_counters;
+    }
+
+    //! Starts the segment of an isolated region at the tail of the task pool
+    /** Only a region with a unique isolation tag can have its own segment, because the tasks with
+        the tag cannot be spawned before the region starts. Returns the segment of the enclosing
+        region, which is restored when the region ends. **/
+    isolation_segment enter_isolation_segment(isolation_type isolation) {
+        isolation_segment outer = my_isolation_segment;
+        my_isolation_segment = { isolation, tail.load(std::memory_order_relaxed), my_isolation_segment_epoch };
+        return outer;
+    }
+
+    void leave_isolation_segment(const isolation_segment& outer) {
+        my_isolation_segment = outer;
+    }
+
+    //! Drops the segments of the regions that are not continued by the current task dispatcher
+    /** Called by the owner when it switches to another task dispatcher or leaves the slot. A region
+        that is resumed later restores an outer segment that is no longer valid. **/
+    void reset_isolation_segment() {
+        my_isolation_segment = isolation_segment{};
+        ++my_isolation_segment_epoch;
+    }
+
     task_dispatcher& default_task_dispatcher() {
         __TBB_ASSERT(my_default_task_dispatcher != nullptr, nullptr);
         return *my_default_task_dispatcher;
@@ -200,6 +412,35 @@ public:
     }
 #endif
 private:
+    //! The lowest position of the task pool where a task with the given isolation can be found
+    std::size_t isolation_segment_base(isolation_type isolation) const {
+        const isolation_segment& segment = my_isolation_segment;
+        if (isolation != no_isolation && isolation == segment.isolation && segment.epoch == my_isolation_segment_epoch) {
+            return segment.base;
+        }
+        return 0;
+    }
+
+    //! Invalidates the segments if the owner has taken the tasks below the base of the current one
+    /** New tasks would be spawned below the base otherwise. **/
+    void check_isolation_segment() {
+        if (std::intptr_t(tail.load(std::memory_order_relaxed) - my_isolation_segment.base) < 0) {
+            ++my_isolation_segment_epoch;
+        }
+    }
+
+#if !__TBB_LOCK_FREE_TASK_POOL
+    //! Moves the base of the current segment after the tasks have been relocated
+    /** The enclosing segments cannot be updated, so they are invalidated. **/
+    void relocate_isolation_segment(std::size_t new_base) {
+        bool is_valid = my_isolation_segment.epoch == my_isolation_segment_epoch;
+        ++my_isolation_segment_epoch;
+        if (is_valid) {
+            my_isolation_segment.base = new_base;
+            my_isolation_segment.epoch = my_isolation_segment_epoch;
+        }
+    }
+
     //! Get a task from the local pool at specified location T.
     /** Returns the pointer to the task or nullptr if the task cannot be executed,
         e.g. proxy has been deallocated or isolation constraint is not met.
@@ -207,7 +448,118 @@ private:
         Called only by the pool owner. The caller should guarantee that the
         position T is not available for a thief. **/
     d1::task* get_task_impl(size_t T, execution_data_ext& ed, bool& tasks_omitted, isolation_type isolation);
+#endif
+
+#if __TBB_LOCK_FREE_TASK_POOL
+    //! Takes the task at the tail of the deque (Chase-Lev "take" operation).
+    /** Returns nullptr for a hole, if the last task has been grabbed by a thief, or if the deque is
+        empty, which is reported by is_empty. Called only by the pool owner. **/
+    d1::task* pop_task(bool& is_empty);
+
+    //! Takes a task below the tail that satisfies the isolation, leaving the tasks above it in place
+    /** The head is locked meanwhile, so the task is claimed without arbitration with thieves. The
+        task leaves a hole, which is skipped by whoever reaches it. Called only by the pool owner. **/
+    d1::task* get_task_in_place(execution_data_ext& ed, isolation_type isolation, std::size_t base);
+
+    //! Claims the task at the head of the deque (Chase-Lev "steal" operation).
+    /** The task is left in place if it does not satisfy the isolation or is a proxy, which has to be
+        inspected before it is claimed; is_left_in_place is set then. Returns nullptr if the deque
+        is empty, locked, the task has been taken by someone else or it is left in place. **/
+    d1::task* steal_head_task(isolation_type isolation, bool& is_left_in_place);
+
+    //! Claims a task below the tail that can be stolen, skipping the tasks that cannot
+    /** The same tasks are skipped as in the locked task pool: the ones that do not satisfy the isolation
+        and the proxies that are likely to be taken by the recipient of the mailed task. The head is
+        locked meanwhile, so the task is claimed without arbitration and leaves a hole, as in
+        get_task_in_place. Returns nullptr if no task is found or the head is locked by someone else. **/
+    d1::task* steal_task_in_place(arena& a, isolation_type isolation, std::size_t slot_index, bool& tasks_omitted);
+
+    //! Locks the head on behalf of the owner, waiting until a thief unlocks it; returns the head index
+    std::size_t lock_head() {
+        atomic_backoff backoff;
+        std::size_t H = head.load(std::memory_order_relaxed);
+        while (H == locked_head || !head.compare_exchange_weak(H, locked_head)) {
+            if (H == locked_head) {
+                backoff.pause();
+                H = head.load(std::memory_order_relaxed);
+            }
+        }
+        return H;
+    }
+
+    //! Returns the head index once it is not locked by a thief. Called only by the pool owner.
+    /** The acquire load makes the holes left by the thief visible to the owner. **/
+    std::size_t unlocked_head() {
+        std::size_t H = head.load(std::memory_order_acquire);
+        for (atomic_backoff backoff; H == locked_head; H = head.load(std::memory_order_acquire)) {
+            backoff.pause();
+        }
+        return H;
+    }
+
+    //! Makes sure that the task pool can accommodate at least n more elements
+    /** Grows the circular buffer if necessary. Unlike the locked variant, tasks are never
+        relocated inside the buffer since thieves may access it at any moment.
+     *  Returns the tail index. **/
+    std::size_t prepare_task_pool(std::size_t num_tasks) {
+        std::size_t T = tail.load(std::memory_order_relaxed); // mirror
+        if ( !my_task_pool_size ) {
+            __TBB_ASSERT( !is_task_pool_published(), nullptr );
+            __TBB_ASSERT( !task_pool_ptr, nullptr );
+            allocate_task_pool( num_tasks );
+            return T;
+        }
+        // The head only grows while the owner pushes tasks, so the free space is not underestimated
+        std::size_t H = unlocked_head();
+        __TBB_ASSERT( std::intptr_t(T - H) >= 0, "The owner observes an inconsistent task pool" );
+        if ( T - H + num_tasks <= my_task_pool_size ) {
+            return T;
+        }
+        // Grow the buffer. The old one is kept alive because thieves can still read from it;
+        // the elements are copied to the same logical positions, so a thief reads the same task
+        // from either buffer. The head is locked meanwhile, so no thief leaves a hole in the old
+        // buffer after its cell is copied.
+        d1::task** new_pool = allocate_lock_free_pool( T - H + num_tasks, task_pool_ptr );
+        std::size_t new_size = get_task_pool_header(new_pool).size;
+        H = lock_head();
+        for ( std::size_t i = H; i != T; ++i ) {
+            task_pool_cell_data& cell = get_task_pool_cells(new_pool)[i & (new_size - 1)];
+            cell.task.store(task_pool_cell(i).task.load(std::memory_order_relaxed), std::memory_order_relaxed);
+            cell.isolation.store(task_pool_cell(i).isolation.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        }
+        task_pool_ptr = new_pool;
+        my_task_pool_size = new_size;
+        if ( is_task_pool_published() ) {
+            task_pool.store( task_pool_ptr, std::memory_order_release );
+        }
+        head.store(H, std::memory_order_release);
+        return T;
+    }
+
+    //! Makes newly spawned tasks visible to thieves
+    void commit_spawned_tasks(std::size_t new_tail) {
+        // Release fence is necessary to make sure that previously stored task pointers
+        // are visible to thieves.
+        tail.store(new_tail, std::memory_order_release);
+    }
 
+    //! Used by workers to enter the task pool
+    void publish_task_pool() {
+        __TBB_ASSERT ( task_pool == EmptyTaskPool, "someone else grabbed my arena slot?" );
+        __TBB_ASSERT ( std::intptr_t(tail.load(std::memory_order_relaxed) - head.load(std::memory_order_relaxed)) > 0,
+                "entering arena without tasks to share" );
+        // Release signal on behalf of previously spawned tasks (when this thread was not in arena yet)
+        task_pool.store(task_pool_ptr, std::memory_order_release );
+    }
+
+    //! Leave the task pool
+    /** Only hides the deque from thieves; a thief that has already read the pool pointer
+        operates on the indices which stay consistent. **/
+    void leave_task_pool() {
+        __TBB_ASSERT(is_task_pool_published(), "Not in arena");
+        task_pool.store(EmptyTaskPool, std::memory_order_relaxed);
+    }
+#else
     //! Makes sure that the task pool can accommodate at least n more elements
     /** If necessary relocates existing task pointers or grows the ready task deque.
      *  Returns (possible updated) tail index (not accounting for n). **/
@@ -244,12 +596,15 @@ private:
             allocate_task_pool( new_size ); // updates my_task_pool_size
         }
         // Filter out skipped tasks. Consider using std::copy_if.
-        std::size_t T1 = 0;
+        // The tasks keep their order, so the tasks of an isolated region stay above the new base.
+        std::size_t T1 = 0, segment_base = 0;
         for ( std::size_t i = H; i < T; ++i ) {
             if ( new_task_pool[i] ) {
+                if ( i < my_isolation_segment.base ) ++segment_base;
                 task_pool_ptr[T1++] = new_task_pool[i];
             }
         }
+        relocate_isolation_segment( segment_base );
         // Deallocate the previous task pool if a new one has been allocated.
         if ( allocate )
             cache_aligned_deallocate( new_task_pool );
@@ -406,6 +761,7 @@ private:
         tail.store(new_tail, std::memory_order_release);
         release_task_pool();
     }
+#endif /* __TBB_LOCK_FREE_TASK_POOL */
 };
 
 } // namespace r1
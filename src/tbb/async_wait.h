@@ -0,0 +1,109 @@
+/*
+    Copyright (c) 2025 UXL Foundation Contributors
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#ifndef __TBB_async_wait_H
+#define __TBB_async_wait_H
+
+#include "oneapi/tbb/detail/_coroutine.h"
+#include "oneapi/tbb/cache_aligned_allocator.h"
+#include "concurrent_monitor.h"
+
+#include <atomic>
+
+namespace tbb {
+namespace detail {
+namespace r1 {
+
+struct async_wait_impl {
+    //! Binds the coroutine to the arena of the calling thread
+    static void suspend(d1::suspended_coroutine& sc);
+    //! Enqueues the task resuming the coroutine into the arena it is bound to
+    static void resume(d1::suspended_coroutine& sc, bool aborted);
+    //! Releases the arena of the coroutine that was not suspended
+    static void cancel(d1::suspended_coroutine& sc);
+
+    static bool continue_execution(const d1::wait_context& wc) {
+        return wc.continue_execution();
+    }
+};
+
+//! The wait node of a suspended C++20 coroutine
+/** Unlike sleep_node, the node does not block a thread: the notification resumes the coroutine
+    as a task. The node is allocated on registration and destroys itself after the resumption. **/
+template <typename Context>
+class async_wait_node : public wait_node<Context> {
+    using base_type = wait_node<Context>;
+public:
+    async_wait_node(Context ctx, d1::suspended_coroutine& sc) : base_type(ctx), my_coroutine(sc) {}
+
+    void wait() override {
+        __TBB_ASSERT(false, "The coroutine does not block the thread");
+    }
+
+    // notify is called (perhaps, concurrently) twice from:
+    //   - concurrent_monitor::notify or concurrent_monitor::abort_all
+    //   - suspend_on_monitor, after the registering thread stops accessing the node
+    // The coroutine is resumed only when both notifications are performed.
+    void notify() override {
+        if (++my_notify_calls == 2) {
+            async_wait_impl::resume(my_coroutine, this->my_aborted);
+            this->~async_wait_node();
+            cache_aligned_deallocate(this);
+        }
+    }
+
+    //! Checks if the node was removed from the wait set by cancel_wait rather than by a notification
+    bool is_cancelled() const {
+        return !this->my_skipped_wakeup;
+    }
+
+private:
+    d1::suspended_coroutine& my_coroutine;
+    std::atomic<int> my_notify_calls{0};
+};
+
+//! Registers the coroutine to be resumed by the monitor notification
+/** is_waiting is checked after the registration as in concurrent_monitor::wait. Returns false
+    if the coroutine does not need to wait, in which case it is not suspended. **/
+template <typename Context, typename Pred>
+bool suspend_on_monitor(concurrent_monitor_base<Context>& monitor, Context ctx, d1::suspended_coroutine& sc,
+                        const Pred& is_waiting)
+{
+    async_wait_impl::suspend(sc);
+    using node_type = async_wait_node<Context>;
+    node_type* node = new (cache_aligned_allocate(sizeof(node_type))) node_type(ctx, sc);
+
+    monitor.prepare_wait(*node);
+    if (!is_waiting()) {
+        monitor.cancel_wait(*node);
+        if (node->is_cancelled()) {
+            // No notification can reach the node
+            node->~node_type();
+            cache_aligned_deallocate(node);
+            async_wait_impl::cancel(sc);
+            return false;
+        }
+        // The node has been notified concurrently, so the coroutine is resumed by the notification
+    }
+    node->notify();
+    return true;
+}
+
+} // namespace r1
+} // namespace detail
+} // namespace tbb
+
+#endif // __TBB_async_wait_H
@@ -17,6 +17,8 @@
 #ifndef _TBB_cgroup_info_H
 #define _TBB_cgroup_info_H
 
+#include <atomic>
+#include <chrono>
 #include <cstdint>
 #include <cstdio>
 #include <climits>
@@ -52,6 +54,51 @@ public:
         return true;
     }
 
+    //! Reads the current CPU limit bypassing the cached value
+    /** Returns false if the limit cannot be determined. Otherwise, num_cpus is set to the number
+        of CPUs the process is limited to or to INT_MAX if there is no limitation. If limit_dir is
+        not null, it receives the directory of the cgroup the limit is read from. **/
+    static bool read_cpu_limit(int& num_cpus, char* limit_dir = nullptr) {
+        const int current_num_cpus = parse_cpu_constraints(cgroup_settings{}, limit_dir);
+        if (current_num_cpus == error_value)
+            return false;
+
+        num_cpus = current_num_cpus;
+        return true;
+    }
+
+    //! CFS bandwidth control statistics of a cgroup
+    struct throttling_stat {
+        long long nr_periods{0};
+        long long nr_throttled{0};
+    };
+
+    //! Reads the statistics from the cpu.stat file of the cgroup directory
+    static bool read_throttling_stat(const char* dir, throttling_stat& stat) {
+        char path[PATH_MAX] = {0};
+        if (std::snprintf(path, PATH_MAX, "%s/cpu.stat", dir) < 0)
+            return false;       // Failed to create path
+
+        unique_file_t fd(std::fopen(path, "r"), &close_file);
+        if (!fd)
+            return false;
+
+        // Both cgroup v1 and v2 report the counters as "<key> <value>" lines
+        int num_found = 0;
+        char key[32] = {0};
+        long long value = 0;
+        while (std::fscanf(fd.get(), "%31s %lld", key, &value) == 2) {
+            if (std::strcmp(key, "nr_periods") == 0) {
+                stat.nr_periods = value;
+                ++num_found;
+            } else if (std::strcmp(key, "nr_throttled") == 0) {
+                stat.nr_throttled = value;
+                ++num_found;
+            }
+        }
+        return num_found == 2;
+    }
+
 private:
     static void close_file(std::FILE *file) { std::fclose(file); };
     using unique_file_t = std::unique_ptr<std::FILE, decltype(&close_file)>;
@@ -220,16 +267,27 @@ private:
         return try_read_cgroup_v1_num_cpus_from(dir, num_cpus);
     }
 
-    static int parse_cgroup_entry(const char* mnt_dir, process_cgroup_data& pcd) {
+    static void store_limit_dir(char* limit_dir, const char* dir) {
+        if (limit_dir) {
+            std::snprintf(limit_dir, PATH_MAX, "%s", dir);
+        }
+    }
+
+    static int parse_cgroup_entry(const char* mnt_dir, process_cgroup_data& pcd, char* limit_dir) {
         int num_cpus = error_value; // Initialize to an impossible value
         char dir[PATH_MAX] = {0};
         if (std::snprintf(dir, PATH_MAX, "%s/%s", mnt_dir, pcd.relative_path) >= 0) {
             if (try_read_cgroup_num_cpus_from(dir, num_cpus, pcd.version)) {
+                store_limit_dir(limit_dir, dir);
                 return num_cpus;
             }
         }
 
-        return try_read_cgroup_num_cpus_from(mnt_dir, num_cpus, pcd.version) ? num_cpus : error_value;
+        if (!try_read_cgroup_num_cpus_from(mnt_dir, num_cpus, pcd.version))
+            return error_value;
+
+        store_limit_dir(limit_dir, mnt_dir);
+        return num_cpus;
     }
 
     static bool is_cpu_restriction_possible(process_cgroup_data& pcd) {
@@ -274,7 +332,7 @@ private:
     }
 
     static int try_common_cgroup_mount_path(const process_cgroup_data& pcd,
-                                            const cgroup_settings& cg_cfg) {
+                                            const cgroup_settings& cg_cfg, char* limit_dir) {
         int num_cpus = error_value;
         char dir[PATH_MAX] = {0};
         __TBB_ASSERT(*pcd.relative_path, nullptr);
@@ -287,10 +345,12 @@ private:
                                    pcd.relative_path))
                 try_read_cgroup_v2_num_cpus_from(dir, num_cpus);
         }
+        if (error_value != num_cpus)
+            store_limit_dir(limit_dir, dir);
         return num_cpus;
     }
 
-    static int parse_cpu_constraints(const cgroup_settings& cg_cfg) {
+    static int parse_cpu_constraints(const cgroup_settings& cg_cfg, char* limit_dir = nullptr) {
         // Reading /proc/self/cgroup anyway, so open it right away
         unique_file_t cgroup_file_ptr(std::fopen(cg_cfg.proc_self_cgroup_path, "r"), &close_file);
         if (!cgroup_file_ptr)
@@ -306,7 +366,7 @@ private:
         __TBB_ASSERT(pcd.version != process_cgroup_data::cgroup_version::unknown, nullptr);
 
         int found_num_cpus = error_value; // Initialize to an impossible value
-        found_num_cpus = try_common_cgroup_mount_path(pcd, cg_cfg);
+        found_num_cpus = try_common_cgroup_mount_path(pcd, cg_cfg, limit_dir);
         if (found_num_cpus != error_value) {
             return found_num_cpus;
         }
@@ -335,7 +395,7 @@ private:
         // Read the mounts file and cgroup file to determine the number of CPUs
         while (getmntent_r(mounts_file_ptr.get(), &mntent, mount_entry_buffer, buffer_size)) {
             if (std::strncmp(mntent.mnt_type, cgroup_mnt_str, cgroup_mnt_strlen) == 0) {
-                found_num_cpus = parse_cgroup_entry(mntent.mnt_dir, pcd);
+                found_num_cpus = parse_cgroup_entry(mntent.mnt_dir, pcd, limit_dir);
                 if (found_num_cpus != error_value)
                     break;
             }
@@ -344,6 +404,107 @@ private:
     }
 };
 
+//! Tracks the changes of the cgroup CPU limit made while the process is running
+/** The limit is re-read on each poll; the owner of the monitor polls it once per interval.
+
+    With the throttling feedback enabled, the monitor also follows the CFS bandwidth statistics of
+    the cgroup. Each interval in which some periods were throttled lowers the number of CPUs
+    reported by the monitor by one, and each interval in which the cgroup ran without throttling
+    raises it back by one until the limit is reached. **/
+template <typename cgroup_settings = default_cgroup_settings>
+class cgroup_cpu_monitor {
+    using info = cgroup_info<cgroup_settings>;
+public:
+    cgroup_cpu_monitor(std::chrono::milliseconds interval, int initial_num_cpus, bool throttling_feedback = false)
+        : my_interval(interval)
+        , my_num_cpus(initial_num_cpus)
+        , my_limit_num_cpus(initial_num_cpus)
+        , my_throttling_feedback(throttling_feedback)
+    {}
+
+    //! Re-reads the limit
+    /** Returns true if the number of CPUs has changed, in which case num_cpus is set to the new
+        value (INT_MAX if the process is not limited anymore). Must not be called concurrently. **/
+    bool poll(int& num_cpus) {
+        int limit_num_cpus = 0;
+        if (!info::read_cpu_limit(limit_num_cpus, my_limit_dir))
+            return false; // Keep the previous limit while the cgroup files cannot be read
+        my_limit_num_cpus = limit_num_cpus;
+
+        int current_num_cpus = limit_num_cpus;
+        if (my_throttling_feedback && limit_num_cpus != INT_MAX) {
+            current_num_cpus = apply_throttling_feedback();
+        }
+
+        if (my_num_cpus.exchange(current_num_cpus, std::memory_order_relaxed) == current_num_cpus)
+            return false;
+
+        num_cpus = current_num_cpus;
+        return true;
+    }
+
+    //! The number of CPUs observed by the last reading
+    int num_cpus() const {
+        return my_num_cpus.load(std::memory_order_relaxed);
+    }
+
+    //! The period of polling the monitor
+    std::chrono::milliseconds interval() const {
+        return my_interval;
+    }
+
+    //! Applies the observed number of CPUs to the soft limit of workers
+    /** The default soft limit follows the number of CPUs both ways, up to max_soft_limit, and
+        returns to the default when the process is not limited anymore. The soft limit requested
+        by the application is only lowered. **/
+    unsigned workers_soft_limit(unsigned requested_soft_limit, unsigned default_soft_limit,
+                                unsigned max_soft_limit) const
+    {
+        const int current_num_cpus = num_cpus();
+        if (current_num_cpus == INT_MAX)
+            return requested_soft_limit;
+
+        // -1 to take external thread into account
+        unsigned cgroup_soft_limit = unsigned(current_num_cpus) - 1;
+        if (cgroup_soft_limit > max_soft_limit)
+            cgroup_soft_limit = max_soft_limit;
+        if (requested_soft_limit != default_soft_limit && requested_soft_limit < cgroup_soft_limit)
+            return requested_soft_limit;
+        return cgroup_soft_limit;
+    }
+
+private:
+    int apply_throttling_feedback() {
+        typename info::throttling_stat stat;
+        int current_num_cpus = min_num_cpus(my_num_cpus.load(std::memory_order_relaxed), my_limit_num_cpus);
+        if (info::read_throttling_stat(my_limit_dir, stat)) {
+            if (my_has_throttling_stat && stat.nr_throttled > my_throttling_stat.nr_throttled) {
+                current_num_cpus = current_num_cpus > 1 ? current_num_cpus - 1 : 1;
+            } else if (my_has_throttling_stat && stat.nr_periods > my_throttling_stat.nr_periods &&
+                       current_num_cpus < my_limit_num_cpus) {
+                // An interval in which the cgroup was idle says nothing about the quota
+                ++current_num_cpus;
+            }
+            my_throttling_stat = stat;
+            my_has_throttling_stat = true;
+        }
+        return current_num_cpus;
+    }
+
+    static int min_num_cpus(int a, int b) { return a < b ? a : b; }
+
+    const std::chrono::milliseconds my_interval;
+    //! Read by the threads that apply the soft limit while the owner polls the monitor
+    std::atomic<int> my_num_cpus;
+
+    // The state below is accessed by the polling thread only
+    int my_limit_num_cpus;
+    const bool my_throttling_feedback;
+    bool my_has_throttling_stat{false};
+    typename info::throttling_stat my_throttling_stat{};
+    char my_limit_dir[PATH_MAX] = {0};
+};
+
 } // namespace r
 } // namespace detail
 } // namespace tbb
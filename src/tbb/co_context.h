@@ -39,6 +39,8 @@
 #elif _WIN32 || _WIN64
 #include <windows.h>
 #else // __TBB_RESUMABLE_TASKS_USE_THREADS
+// The stacks of ucontext based coroutines are mapped by the library and pooled (see co_stack_pool)
+#define __TBB_CO_STACK_POOL_PRESENT 1
 // ucontext.h API is deprecated since macOS 10.6
 #if __APPLE__
     #if __INTEL_COMPILER
@@ -53,8 +55,11 @@
 #include <ucontext.h>
 #include <sys/mman.h> // mprotect
 
+#include "oneapi/tbb/spin_mutex.h"
 #include "governor.h" // default_page_size()
 
+#include <atomic>
+
 #ifndef MAP_STACK
 // macOS* does not define MAP_STACK
 #define MAP_STACK 0
@@ -305,30 +310,146 @@ inline void destroy_coroutine(coroutine_type& c) {
 }
 #else // !__TBB_RESUMABLE_TASKS_USE_THREADS
 
-inline void create_coroutine(coroutine_type& c, std::size_t stack_size, void* arg) {
-    const std::size_t REG_PAGE_SIZE = governor::default_page_size();
-    const std::size_t page_aligned_stack_size = align_to_greater_or_equal(stack_size, REG_PAGE_SIZE);
-    const std::size_t protected_stack_size = page_aligned_stack_size + 2 * REG_PAGE_SIZE;
+//! Process-wide pool of coroutine stacks grouped by size classes
+/** The size of a class is a power of two number of pages. A stack is mapped with a guard page on
+    each side. A returned stack keeps its mapping, but its pages are given back to the OS lazily
+    (MADV_FREE), so the cached stacks do not occupy physical memory until they are reused. **/
+class co_stack_pool {
+public:
+    static constexpr unsigned size_classes_count = 16;
+    //! The maximal number of cached stacks of a size class; the extra stacks are unmapped
+    static constexpr unsigned max_cached_stacks = 64;
+
+    //! Returns a stack of at least stack_size bytes; stack_size is updated with the actual size
+    void* acquire(std::size_t& stack_size) {
+        unsigned size_class = get_size_class(stack_size);
+        if (size_class < size_classes_count) {
+            stack_size = governor::default_page_size() << size_class;
+            size_class_cache& cache = my_caches[size_class];
+            void* stack = nullptr;
+            {
+                spin_mutex::scoped_lock lock(cache.mutex);
+                if (cache.count > 0) {
+                    stack = cache.stacks[--cache.count];
+                }
+            }
+            if (stack) {
+                my_reused_stacks.fetch_add(1, std::memory_order_relaxed);
+                return stack;
+            }
+        } else {
+            stack_size = align_to_greater_or_equal(stack_size, governor::default_page_size());
+        }
+        my_mapped_stacks.fetch_add(1, std::memory_order_relaxed);
+        return map_stack(stack_size);
+    }
+
+    //! Caches the stack returned by acquire or unmaps it if the cache of its size class is full
+    /** After clear(), the stack is always unmapped. **/
+    void release(void* stack, std::size_t stack_size) {
+        unsigned size_class = get_size_class(stack_size);
+        if (size_class < size_classes_count) {
+            __TBB_ASSERT(stack_size == governor::default_page_size() << size_class, "The stack is not acquired from the pool");
+            // The content of the stack is not needed anymore
+            discard_pages(stack, stack_size);
+            size_class_cache& cache = my_caches[size_class];
+            spin_mutex::scoped_lock lock(cache.mutex);
+            // The flag is set before clear() takes the lock, so a stack cached here is unmapped by it
+            if (!my_is_cleared.load(std::memory_order_relaxed) && cache.count < max_cached_stacks) {
+                cache.stacks[cache.count++] = stack;
+                return;
+            }
+        }
+        unmap_stack(stack, stack_size);
+    }
 
-    // Allocate the stack with protection property
+    //! Unmaps the cached stacks; the stacks released later are not cached
+    void clear() {
+        my_is_cleared.store(true, std::memory_order_relaxed);
+        for (unsigned size_class = 0; size_class < size_classes_count; ++size_class) {
+            size_class_cache& cache = my_caches[size_class];
+            spin_mutex::scoped_lock lock(cache.mutex);
+            while (cache.count > 0) {
+                unmap_stack(cache.stacks[--cache.count], governor::default_page_size() << size_class);
+            }
+        }
+    }
+
+    //! The number of stacks mapped since the start of the process
+    std::uint64_t mapped_stacks() const { return my_mapped_stacks.load(std::memory_order_relaxed); }
+    //! The number of stacks taken from the pool instead of being mapped
+    std::uint64_t reused_stacks() const { return my_reused_stacks.load(std::memory_order_relaxed); }
+
+    static co_stack_pool& instance() { return the_pool; }
+
+private:
+    struct size_class_cache {
+        spin_mutex mutex;
+        unsigned count{0};
+        void* stacks[max_cached_stacks];
+    };
+
+    //! Returns the index of the smallest class that fits the stack, or size_classes_count if none does
+    static unsigned get_size_class(std::size_t stack_size) {
+        const std::size_t page_size = governor::default_page_size();
+        unsigned size_class = 0;
+        while (size_class < size_classes_count && (page_size << size_class) < stack_size) {
+            ++size_class;
+        }
+        return size_class;
+    }
+
+    static void* map_stack(std::size_t stack_size) {
+        const std::size_t REG_PAGE_SIZE = governor::default_page_size();
+        const std::size_t protected_stack_size = stack_size + 2 * REG_PAGE_SIZE;
+
+        // Allocate the stack with protection property
 #if __FreeBSD__
     #define MMAP_PROT_ARG PROT_READ | PROT_WRITE
 #else
     #define MMAP_PROT_ARG PROT_NONE
 #endif
 
- std::uintptr_t stack_ptr = (std::uintptr_t)mmap(nullptr, protected_stack_size, MMAP_PROT_ARG, MAP_PRIVATE | MAP_ANONYMOUS | MAP_STACK, -1, 0);
-    __TBB_ASSERT((void*)stack_ptr != MAP_FAILED, nullptr);
+        std::uintptr_t stack_ptr = (std::uintptr_t)mmap(nullptr, protected_stack_size, MMAP_PROT_ARG, MAP_PRIVATE | MAP_ANONYMOUS | MAP_STACK, -1, 0);
+        __TBB_ASSERT((void*)stack_ptr != MAP_FAILED, nullptr);
 
-    // Allow read write on our stack (guarded pages are still protected)
-    int err = mprotect((void*)(stack_ptr + REG_PAGE_SIZE), page_aligned_stack_size, PROT_READ | PROT_WRITE);
-    __TBB_ASSERT_EX(!err, nullptr);
+        // Allow read write on our stack (guarded pages are still protected)
+        int err = mprotect((void*)(stack_ptr + REG_PAGE_SIZE), stack_size, PROT_READ | PROT_WRITE);
+        __TBB_ASSERT_EX(!err, nullptr);
+        return (void*)(stack_ptr + REG_PAGE_SIZE);
+    }
+
+    static void unmap_stack(void* stack, std::size_t stack_size) {
+        const std::size_t REG_PAGE_SIZE = governor::default_page_size();
+        // Free stack memory with guarded pages
+        munmap((void*)((std::uintptr_t)stack - REG_PAGE_SIZE), stack_size + 2 * REG_PAGE_SIZE);
+    }
+
+    static void discard_pages(void* stack, std::size_t stack_size) {
+#ifdef MADV_FREE
+        // MADV_FREE is not supported by old kernels
+        if (madvise(stack, stack_size, MADV_FREE) == 0) {
+            return;
+        }
+#endif
+        madvise(stack, stack_size, MADV_DONTNEED);
+    }
+
+    size_class_cache my_caches[size_classes_count];
+    std::atomic<std::uint64_t> my_mapped_stacks{0};
+    std::atomic<std::uint64_t> my_reused_stacks{0};
+    //! Set by clear(); protected by the mutexes of the size classes
+    std::atomic<bool> my_is_cleared{false};
 
+    static co_stack_pool the_pool;
+};
+
+inline void create_coroutine(coroutine_type& c, std::size_t stack_size, void* arg) {
     // Remember the stack state
-    c.my_stack = (void*)(stack_ptr + REG_PAGE_SIZE);
-    c.my_stack_size = page_aligned_stack_size;
+    c.my_stack_size = stack_size;
+    c.my_stack = co_stack_pool::instance().acquire(c.my_stack_size);
 
-    err = getcontext(&c.my_context);
+    int err = getcontext(&c.my_context);
     __TBB_ASSERT_EX(!err, nullptr);
 
     c.my_context.uc_link = nullptr;
@@ -358,9 +479,7 @@ inline void swap_coroutine(coroutine_type& prev_coroutine, coroutine_type& new_c
 }
 
 inline void destroy_coroutine(coroutine_type& c) {
-    const std::size_t REG_PAGE_SIZE = governor::default_page_size();
-    // Free stack memory with guarded pages
-    munmap((void*)((std::uintptr_t)c.my_stack - REG_PAGE_SIZE), c.my_stack_size + 2 * REG_PAGE_SIZE);
+    co_stack_pool::instance().release(c.my_stack, c.my_stack_size);
     // Clear the stack state afterwards
     c.my_stack = nullptr;
     c.my_stack_size = 0;
@@ -18,6 +18,7 @@
 #include "oneapi/tbb/concurrent_queue.h"
 #include "oneapi/tbb/cache_aligned_allocator.h"
 #include "concurrent_monitor.h"
+#include "async_wait.h"
 
 namespace tbb {
 namespace detail {
@@ -57,6 +58,16 @@ void __TBB_EXPORTED_FUNC wait_bounded_queue_monitor( concurrent_monitor* monitor
     monitor.wait<concurrent_monitor::thread_context>([&] { return !predicate(); }, std::uintptr_t(target));
 }
 
+bool __TBB_EXPORTED_FUNC wait_bounded_queue_monitor_async( concurrent_monitor* monitors, std::size_t monitor_tag,
+                                                           std::ptrdiff_t target, d1::delegate_base& predicate,
+                                                           d1::suspended_coroutine& sc )
+{
+    __TBB_ASSERT(monitor_tag < monitors_number, nullptr);
+    concurrent_monitor& monitor = monitors[monitor_tag];
+
+    return suspend_on_monitor(monitor, std::uintptr_t(target), sc, [&] { return predicate(); });
+}
+
 void __TBB_EXPORTED_FUNC abort_bounded_queue_monitors( concurrent_monitor* monitors ) {
     concurrent_monitor& items_avail = monitors[d2::cbq_items_avail_tag];
     concurrent_monitor& slots_avail = monitors[d2::cbq_slots_avail_tag];
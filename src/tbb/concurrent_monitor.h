@@ -333,7 +333,14 @@ public:
             my_waitset.flush_to(temp);
             end = temp.end();
             for (base_node* n = temp.front(); n != end; n = n->next) {
+#if CONCURRENT_MONITOR_MY_IS_IN_LIST_STORE_BROKEN
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wstringop-overflow"
+#endif
                 to_wait_node(n)->my_is_in_list.store(false, std::memory_order_relaxed);
+#if CONCURRENT_MONITOR_MY_IS_IN_LIST_STORE_BROKEN
+#pragma GCC diagnostic pop
+#endif
             }
         }
 
@@ -23,6 +23,7 @@
 #include "oneapi/tbb/tbb_allocator.h"
 #include "oneapi/tbb/spin_mutex.h"
 
+#include "arena.h"
 #include "governor.h"
 #include "threading_control.h"
 #include "market.h"
@@ -149,7 +150,16 @@ class alignas(max_nfs_size) leave_policy_control : public control_storage {
     }
 };
 
-static control_storage* controls[] = {nullptr, nullptr, nullptr, nullptr, nullptr};
+class alignas(max_nfs_size) worker_retention_limit_control : public control_storage {
+    std::size_t default_value() const override {
+        return work_arrival_predictor::default_retention_limit_us;
+    }
+    bool is_first_arg_preferred(std::size_t a, std::size_t b) const override {
+        return a<b; // prefer the shortest retention
+    }
+};
+
+static control_storage* controls[] = {nullptr, nullptr, nullptr, nullptr, nullptr, nullptr};
 
 void global_control_acquire() {
     controls[0] = new (cache_aligned_allocate(sizeof(allowed_parallelism_control))) allowed_parallelism_control{};
@@ -157,6 +167,7 @@ void global_control_acquire() {
     controls[2] = new (cache_aligned_allocate(sizeof(terminate_on_exception_control))) terminate_on_exception_control{};
     controls[3] = new (cache_aligned_allocate(sizeof(lifetime_control))) lifetime_control{};
     controls[4] = new (cache_aligned_allocate(sizeof(leave_policy_control))) leave_policy_control{};
+    controls[5] = new (cache_aligned_allocate(sizeof(worker_retention_limit_control))) worker_retention_limit_control{};
 }
 
 void global_control_release() {
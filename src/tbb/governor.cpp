@@ -25,6 +25,9 @@
 #include "concurrent_monitor.h"
 #include "thread_dispatcher.h"
 #include "load_tbbbind.h"
+#include "environment.h"
+#include "thread_locality.h"
+#include "scheduler_trace.h"
 
 #include "oneapi/tbb/task_group.h"
 #include "oneapi/tbb/global_control.h"
@@ -99,6 +102,19 @@ void governor::acquire_resources () {
     detect_cpu_features(cpu_features);
 
     is_rethrow_broken = gcc_rethrow_exception_broken();
+    is_locality_aware_stealing_enabled = GetBoolEnvironmentVariable("TBB_LOCALITY_AWARE_STEALING");
+    long batch_size = GetIntegralEnvironmentVariable("TBB_STEAL_BATCH_SIZE");
+    steal_batch_size_limit = batch_size > 0 ? std::size_t(batch_size) : 0;
+    is_enqueue_latency_tracking_enabled = GetBoolEnvironmentVariable("TBB_ENQUEUE_LATENCY");
+    is_numa_task_streams_enabled = GetBoolEnvironmentVariable("TBB_NUMA_TASK_STREAMS");
+    is_scheduler_tracing_enabled = GetBoolEnvironmentVariable("TBB_TRACE");
+    long cache_size = GetIntegralEnvironmentVariable("TBB_SUSPEND_POINT_CACHE_SIZE");
+    suspend_point_cache_size_limit = cache_size > 0 ? std::size_t(cache_size) : 0;
+    long monitor_interval = GetIntegralEnvironmentVariable("TBB_CGROUP_MONITOR_INTERVAL");
+    cgroup_monitor_interval_ms = monitor_interval > 0 ? std::size_t(monitor_interval) : 0;
+    is_cgroup_throttling_feedback_enabled = GetBoolEnvironmentVariable("TBB_CGROUP_THROTTLING_FEEDBACK");
+    is_arena_cpu_time_accounting_enabled = GetBoolEnvironmentVariable("TBB_ARENA_CPU_TIME");
+    is_migration_latency_tracking_enabled = GetBoolEnvironmentVariable("TBB_MIGRATION_LATENCY");
 }
 
 void governor::release_resources () {
@@ -111,6 +127,12 @@ void governor::release_resources () {
     if( status )
         runtime_warning("failed to destroy task scheduler TLS: %s", std::strerror(status));
     clear_address_waiter_table();
+#if __TBB_CO_STACK_POOL_PRESENT
+    co_stack_pool::instance().clear();
+#endif
+    if (is_scheduler_tracing_enabled) {
+        trace_registry::release();
+    }
 
 #if TBB_USE_ASSERT
     if (the_observer_proxy_count != 0) {
@@ -242,7 +264,6 @@ void governor::init_external_thread() {
     td.enter_task_dispatcher(task_disp, calculate_stealing_threshold(stack_base, stack_size));
 
     td.my_arena_slot->occupy();
-    thr_control->register_thread(td);
     set_thread_data(td);
 #if (_WIN32||_WIN64) && !__TBB_DYNAMIC_LOAD_ENABLED
     // The external thread destructor is called from dllMain but it is not available with a static build.
@@ -281,8 +302,6 @@ void governor::auto_terminate(void* tls) {
             // Release an arena
             a->on_thread_leaving(arena::ref_external);
 
-            thr_control->unregister_thread(*td);
-
             // The tls should be cleared before market::release because
             // market can destroy the tls key if we keep the last reference
             clear_tls();
@@ -330,6 +349,10 @@ bool finalize_impl(d1::task_scheduler_handle& handle) {
 
         if (remove_and_check_if_empty(*handle.m_ctl)) {
             ok = threading_control::unregister_lifetime_control(/*blocking_terminate*/ true);
+            if (ok && governor::scheduler_tracing()) {
+                // All workers have finished, so their buffers are complete
+                trace_registry::dump();
+            }
         } else {
             ok = false;
         }
@@ -363,6 +386,8 @@ bool __TBB_EXPORTED_FUNC finalize(d1::task_scheduler_handle& handle, std::intptr
 #pragma weak __TBB_internal_get_affinity_mask
 #pragma weak __TBB_internal_get_default_concurrency
 #pragma weak __TBB_internal_set_tbbbind_assertion_handler
+#pragma weak __TBB_internal_get_thread_locality
+#pragma weak __TBB_internal_set_placement_policy
 
 extern "C" {
 void __TBB_internal_initialize_system_topology(
@@ -383,6 +408,10 @@ tcm_cpu_mask_t __TBB_internal_get_affinity_mask( binding_handler* handler_ptr );
 int __TBB_internal_get_default_concurrency( int numa_id, int core_type_id, int max_threads_per_core );
 
 void __TBB_internal_set_tbbbind_assertion_handler( assertion_handler_type handler );
+
+void __TBB_internal_get_thread_locality( int& numa_id, int& cache_id, int& core_id );
+
+void __TBB_internal_set_placement_policy( binding_handler* handler_ptr, int placement );
 }
 #endif /* __TBB_WEAK_SYMBOLS_PRESENT */
 
@@ -395,6 +424,10 @@ static void dummy_restore_affinity ( binding_handler*, int ) { }
 static tcm_cpu_mask_t dummy_get_affinity_mask( binding_handler* ) { return nullptr; }
 static int dummy_get_default_concurrency( int, int, int ) { return governor::default_num_threads(); }
 static void dummy_set_assertion_handler( assertion_handler_type ) { }
+static void dummy_get_thread_locality( int& numa_id, int& cache_id, int& core_id ) {
+    numa_id = cache_id = core_id = -1;
+}
+static void dummy_set_placement_policy( binding_handler*, int ) { }
 
 // Handlers for communication with TBBbind
 static void (*initialize_system_topology_ptr)(
@@ -418,6 +451,10 @@ int (*get_default_concurrency_ptr)( int numa_id, int core_type_id, int max_threa
     = dummy_get_default_concurrency;
 void (*set_assertion_handler_ptr)( assertion_handler_type handler )
     = dummy_set_assertion_handler;
+static void (*get_thread_locality_ptr)( int& numa_id, int& cache_id, int& core_id )
+    = dummy_get_thread_locality;
+static void (*set_placement_policy_ptr)( binding_handler* handler_ptr, int placement )
+    = dummy_set_placement_policy;
 
 #if _WIN32 || _WIN64 || __unix__ || __APPLE__
 
@@ -495,6 +532,18 @@ void initialization_impl() {
                      DYNAMIC_LINK_LOCAL_BINDING);
         set_assertion_handler_ptr(assertion_failure);
 
+        // The thread locality query is optional as well since it is absent in older TBBbind versions.
+        const dynamic_link_descriptor optional_get_thread_locality[] =
+            {DLD(__TBB_internal_get_thread_locality, get_thread_locality_ptr)};
+        dynamic_link(tbbbind_name, optional_get_thread_locality, 1, nullptr,
+                     DYNAMIC_LINK_LOCAL_BINDING);
+
+        // Older TBBbind versions do not support placement policies, so the threads are pinned only by the constraints.
+        const dynamic_link_descriptor optional_set_placement_policy[] =
+            {DLD(__TBB_internal_set_placement_policy, set_placement_policy_ptr)};
+        dynamic_link(tbbbind_name, optional_set_placement_policy, 1, nullptr,
+                     DYNAMIC_LINK_LOCAL_BINDING);
+
         initialize_system_topology_ptr(
             processor_groups_num(),
             numa_nodes_count, numa_nodes_indexes,
@@ -525,9 +574,15 @@ void destroy() {
 }
 } // namespace system_topology
 
-binding_handler* construct_binding_handler(int slot_num, int numa_id, int core_type_id, int max_threads_per_core) {
+binding_handler* construct_binding_handler(int slot_num, int numa_id, int core_type_id, int max_threads_per_core,
+                                           int placement)
+{
     system_topology::initialize();
-    return allocate_binding_handler_ptr(slot_num, numa_id, core_type_id, max_threads_per_core);
+    binding_handler* handler_ptr = allocate_binding_handler_ptr(slot_num, numa_id, core_type_id, max_threads_per_core);
+    if (handler_ptr && placement != int(d1::placement_policy::none)) {
+        set_placement_policy_ptr(handler_ptr, placement);
+    }
+    return handler_ptr;
 }
 
 void destroy_binding_handler(binding_handler* handler_ptr) {
@@ -552,6 +607,13 @@ tcm_cpu_mask_t get_affinity_mask(binding_handler* handler_ptr) {
     return get_affinity_mask_ptr(handler_ptr);
 }
 
+locality_type current_thread_locality() {
+    system_topology::initialize();
+    int numa_id = -1, cache_id = -1, core_id = -1;
+    get_thread_locality_ptr(numa_id, cache_id, core_id);
+    return make_locality(numa_id, cache_id, core_id);
+}
+
 unsigned __TBB_EXPORTED_FUNC numa_node_count() {
     system_topology::initialize();
     return system_topology::numa_nodes_count;
@@ -585,7 +647,7 @@ void __TBB_EXPORTED_FUNC fill_core_type_indices(int* index_array, intptr_t /*res
     std::memcpy(index_array, system_topology::core_types_indexes, system_topology::core_types_count * sizeof(int));
 }
 
-void constraints_assertion(d1::constraints c) {
+void constraints_assertion(const d1::constraints& c) {
     bool is_topology_initialized = system_topology::initialization_state == do_once_state::initialized;
     __TBB_ASSERT_RELEASE(c.max_threads_per_core == system_topology::automatic || c.max_threads_per_core > 0,
         "Wrong max_threads_per_core constraints field value.");
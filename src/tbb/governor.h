@@ -63,6 +63,36 @@ private:
     static cpu_features_type cpu_features;
     static bool is_rethrow_broken;
 
+    //! Thieves prefer victims close in the hardware topology (TBB_LOCALITY_AWARE_STEALING)
+    static bool is_locality_aware_stealing_enabled;
+
+    //! The number of tasks a thief may move in addition to the stolen one (TBB_STEAL_BATCH_SIZE)
+    static std::size_t steal_batch_size_limit;
+
+    //! Enqueued tasks are timestamped to collect the histogram of queueing delays (TBB_ENQUEUE_LATENCY)
+    static bool is_enqueue_latency_tracking_enabled;
+
+    //! Lanes of the enqueued tasks stream are partitioned by NUMA nodes (TBB_NUMA_TASK_STREAMS)
+    static bool is_numa_task_streams_enabled;
+
+    //! Scheduler events are recorded and written to a trace file (TBB_TRACE)
+    static bool is_scheduler_tracing_enabled;
+
+    //! The number of suspend points cached by an arena (TBB_SUSPEND_POINT_CACHE_SIZE)
+    static std::size_t suspend_point_cache_size_limit;
+
+    //! The period in milliseconds of re-reading the cgroup CPU limit, 0 if it is not tracked (TBB_CGROUP_MONITOR_INTERVAL)
+    static std::size_t cgroup_monitor_interval_ms;
+
+    //! The number of active workers follows the CPU throttling of the cgroup (TBB_CGROUP_THROTTLING_FEEDBACK)
+    static bool is_cgroup_throttling_feedback_enabled;
+
+    //! The CPU time of threads is accounted per arena (TBB_ARENA_CPU_TIME)
+    static bool is_arena_cpu_time_accounting_enabled;
+
+    //! Workers are timestamped on leaving an arena to collect the histogram of migration delays (TBB_MIGRATION_LATENCY)
+    static bool is_migration_latency_tracking_enabled;
+
     //! Create key for thread-local storage and initialize RML.
     static void acquire_resources ();
 
@@ -142,6 +172,26 @@ public:
 
     static bool rethrow_exception_broken() { return is_rethrow_broken; }
 
+    static bool locality_aware_stealing() { return is_locality_aware_stealing_enabled; }
+
+    static std::size_t steal_batch_size() { return steal_batch_size_limit; }
+
+    static bool enqueue_latency_tracking() { return is_enqueue_latency_tracking_enabled; }
+
+    static bool numa_task_streams() { return is_numa_task_streams_enabled; }
+
+    static bool scheduler_tracing() { return is_scheduler_tracing_enabled; }
+
+    static std::size_t suspend_point_cache_size() { return suspend_point_cache_size_limit; }
+
+    static std::size_t cgroup_monitor_interval() { return cgroup_monitor_interval_ms; }
+
+    static bool cgroup_throttling_feedback() { return is_cgroup_throttling_feedback_enabled; }
+
+    static bool arena_cpu_time_accounting() { return is_arena_cpu_time_accounting_enabled; }
+
+    static bool migration_latency_tracking() { return is_migration_latency_tracking_enabled; }
+
     static bool is_itt_present() {
 #if __TBB_USE_ITT_NOTIFY
         return ITT_Present;
@@ -24,6 +24,7 @@
 #include "tcm_adaptor.h"
 #include "misc.h"
 #include "itt_notify.h"
+#include "co_context.h"
 
 namespace tbb {
 namespace detail {
@@ -40,16 +41,27 @@ basic_tls<thread_data*> governor::theTLS;
 rml::tbb_factory governor::theRMLServerFactory;
 bool governor::UsePrivateRML;
 bool governor::is_rethrow_broken;
+bool governor::is_locality_aware_stealing_enabled;
+std::size_t governor::steal_batch_size_limit;
+bool governor::is_enqueue_latency_tracking_enabled;
+bool governor::is_numa_task_streams_enabled;
+bool governor::is_scheduler_tracing_enabled;
+std::size_t governor::suspend_point_cache_size_limit;
+std::size_t governor::cgroup_monitor_interval_ms;
+bool governor::is_cgroup_throttling_feedback_enabled;
+bool governor::is_arena_cpu_time_accounting_enabled;
+bool governor::is_migration_latency_tracking_enabled;
 
 //------------------------------------------------------------------------
 // threading_control data
 threading_control* threading_control::g_threading_control;
 threading_control::global_mutex_type threading_control::g_threading_control_mutex;
 
+#if __TBB_CO_STACK_POOL_PRESENT
 //------------------------------------------------------------------------
-// context propagation data
-context_state_propagation_mutex_type the_context_state_propagation_mutex;
-std::atomic<uintptr_t> the_context_state_propagation_epoch{};
+// coroutine stacks data
+co_stack_pool co_stack_pool::the_pool;
+#endif
 
 //------------------------------------------------------------------------
 // One time initialization data
@@ -18,6 +18,7 @@
 #include "market.h"
 
 #include <algorithm> // std::find
+#include <cstdint>
 
 namespace tbb {
 namespace detail {
@@ -28,6 +29,46 @@ class tbb_permit_manager_client : public pm_client {
 public:
     tbb_permit_manager_client(arena& a) : pm_client(a) {}
 
+    //! Arenas without an explicit weight have the weight of 1
+    int weight() const {
+        return my_weight > 0 ? my_weight : 1;
+    }
+
+    bool is_weighted() const {
+        return my_weight > 0;
+    }
+
+    void set_weight(int w) {
+        my_weight = w;
+    }
+
+    //! The share of the workers computed by the weighted distribution
+    int weighted_allotment() const {
+        return my_weighted_allotment;
+    }
+
+    void set_weighted_allotment(int allotment) {
+        my_weighted_allotment = allotment;
+    }
+
+    int guaranteed_workers() const {
+        return int(my_arena.my_num_guaranteed_workers);
+    }
+
+    //! The workers reserved for the arena before the others are distributed
+    int guaranteed_allotment() const {
+        return my_guaranteed_allotment;
+    }
+
+    void set_guaranteed_allotment(int allotment) {
+        my_guaranteed_allotment = allotment;
+    }
+
+    //! The number of requested workers that are not covered by the guarantee
+    int unreserved_demand() const {
+        return max_workers() - my_guaranteed_allotment;
+    }
+
     void register_thread() override {}
 
     void unregister_thread() override {}
@@ -35,6 +76,11 @@ public:
     void set_allotment(unsigned allotment) {
         my_arena.set_allotment(allotment);
     }
+
+private:
+    int my_weight{d1::task_arena_base::automatic};
+    int my_weighted_allotment{0};
+    int my_guaranteed_allotment{0};
 };
 
 //------------------------------------------------------------------------
@@ -49,9 +95,18 @@ pm_client* market::create_client(arena& a) {
     return new (cache_aligned_allocate(sizeof(tbb_permit_manager_client))) tbb_permit_manager_client(a);
 }
 
-void market::register_client(pm_client* c, d1::constraints&) {
+void market::register_client(pm_client* c, d1::constraints& constraints) {
+    auto client = static_cast<tbb_permit_manager_client*>(c);
+    client->set_weight(constraints.weight);
+
     mutex_type::scoped_lock lock(my_mutex);
     my_clients[c->priority_level()].push_back(c);
+    if (client->is_weighted()) {
+        ++my_num_weighted_clients[c->priority_level()];
+    }
+    if (client->guaranteed_workers() > 0) {
+        ++my_num_guaranteed_clients;
+    }
 }
 
 void market::unregister_and_destroy_client(pm_client& c) {
@@ -61,6 +116,12 @@ void market::unregister_and_destroy_client(pm_client& c) {
         auto it = std::find(clients.begin(), clients.end(), &c);
         __TBB_ASSERT(it != clients.end(), "Destroying of an unregistered client");
         clients.erase(it);
+        if (static_cast<tbb_permit_manager_client&>(c).is_weighted()) {
+            --my_num_weighted_clients[c.priority_level()];
+        }
+        if (static_cast<tbb_permit_manager_client&>(c).guaranteed_workers() > 0) {
+            --my_num_guaranteed_clients;
+        }
     }
 
     auto client = static_cast<tbb_permit_manager_client*>(&c);
@@ -68,18 +129,91 @@ void market::unregister_and_destroy_client(pm_client& c) {
     cache_aligned_deallocate(client);
 }
 
+void market::update_weighted_allotment(unsigned list_idx, int assigned_per_priority) {
+    // The arenas that cannot use their share due to their demand are satisfied first, so the rest
+    // of the workers is divided by the weights of the arenas that still want more.
+    for (pm_client* c : my_clients[list_idx]) {
+        static_cast<tbb_permit_manager_client*>(c)->set_weighted_allotment(0);
+    }
+    int unassigned_workers = assigned_per_priority;
+    std::int64_t total_weight = 0;
+    bool is_settled = false;
+    while (!is_settled) {
+        total_weight = 0;
+        for (pm_client* c : my_clients[list_idx]) {
+            auto client = static_cast<tbb_permit_manager_client*>(c);
+            if (client->weighted_allotment() < client->unreserved_demand()) {
+                total_weight += client->weight();
+            }
+        }
+        is_settled = true;
+        for (pm_client* c : my_clients[list_idx]) {
+            auto client = static_cast<tbb_permit_manager_client*>(c);
+            int demand = client->unreserved_demand();
+            if (client->weighted_allotment() < demand &&
+                std::int64_t(demand) * total_weight <= std::int64_t(client->weight()) * unassigned_workers)
+            {
+                client->set_weighted_allotment(demand);
+                unassigned_workers -= demand;
+                is_settled = false;
+            }
+        }
+    }
+    __TBB_ASSERT(unassigned_workers >= 0, nullptr);
+    __TBB_ASSERT(unassigned_workers == 0 || total_weight > 0, nullptr);
+
+    std::int64_t carry = 0;
+    // We use reverse iterator there to serve last added clients first
+    for (auto it = my_clients[list_idx].rbegin(); it != my_clients[list_idx].rend(); ++it) {
+        auto client = static_cast<tbb_permit_manager_client*>(*it);
+        if (client->weighted_allotment() < client->unreserved_demand()) {
+            std::int64_t tmp = std::int64_t(client->weight()) * unassigned_workers + carry;
+            client->set_weighted_allotment(int(tmp / total_weight));
+            carry = tmp % total_weight;
+            __TBB_ASSERT(client->weighted_allotment() <= client->unreserved_demand(), nullptr);
+        }
+    }
+}
+
+int market::reserve_guaranteed_workers(int available_workers, int (&guaranteed_per_priority)[num_priority_levels]) {
+    int reserved = 0;
+    // The guarantees of the arenas with higher priority are satisfied first
+    for (unsigned list_idx = 0; list_idx < num_priority_levels; ++list_idx) {
+        for (auto it = my_clients[list_idx].rbegin(); it != my_clients[list_idx].rend(); ++it) {
+            tbb_permit_manager_client& client = static_cast<tbb_permit_manager_client&>(**it);
+            int guaranteed = 0;
+            if (my_num_workers_soft_limit > 0) {
+                guaranteed = min(min(client.guaranteed_workers(), client.max_workers()), available_workers - reserved);
+            }
+            client.set_guaranteed_allotment(guaranteed);
+            guaranteed_per_priority[list_idx] += guaranteed;
+            reserved += guaranteed;
+        }
+    }
+    return reserved;
+}
+
 void market::update_allotment() {
     int effective_soft_limit = my_mandatory_num_requested > 0 && my_num_workers_soft_limit == 0 ? 1 : my_num_workers_soft_limit;
     int max_workers = min(my_total_demand, effective_soft_limit);
     __TBB_ASSERT(max_workers >= 0, nullptr);
 
     int unassigned_workers = max_workers;
+    int guaranteed_per_priority[num_priority_levels] = {0};
+    if (my_num_guaranteed_clients > 0) {
+        unassigned_workers -= reserve_guaranteed_workers(unassigned_workers, guaranteed_per_priority);
+    }
     int assigned = 0;
     int carry = 0;
     unsigned max_priority_level = num_priority_levels;
     for (unsigned list_idx = 0; list_idx < num_priority_levels; ++list_idx ) {
-        int assigned_per_priority = min(my_priority_level_demand[list_idx], unassigned_workers);
+        int level_demand = my_priority_level_demand[list_idx] - guaranteed_per_priority[list_idx];
+        int assigned_per_priority = min(level_demand, unassigned_workers);
         unassigned_workers -= assigned_per_priority;
+        bool is_weighted_level = my_num_weighted_clients[list_idx] > 0 && my_num_workers_soft_limit > 0;
+        if (is_weighted_level) {
+            update_weighted_allotment(list_idx, assigned_per_priority);
+        }
         // We use reverse iterator there to serve last added clients first
         for (auto it = my_clients[list_idx].rbegin(); it != my_clients[list_idx].rend(); ++it) {
             tbb_permit_manager_client& client = static_cast<tbb_permit_manager_client&>(**it);
@@ -96,10 +230,15 @@ void market::update_allotment() {
             if (my_num_workers_soft_limit == 0) {
                 __TBB_ASSERT(max_workers == 0 || max_workers == 1, nullptr);
                 allotted = client.min_workers() > 0 && assigned < max_workers ? 1 : 0;
+            } else if (is_weighted_level) {
+                allotted = client.guaranteed_allotment() + client.weighted_allotment();
             } else {
-                int tmp = client.max_workers() * assigned_per_priority + carry;
-                allotted = tmp / my_priority_level_demand[list_idx];
-                carry = tmp % my_priority_level_demand[list_idx];
+                allotted = client.guaranteed_allotment();
+                if (level_demand > 0) {
+                    int tmp = client.unreserved_demand() * assigned_per_priority + carry;
+                    allotted += tmp / level_demand;
+                    carry = tmp % level_demand;
+                }
                 __TBB_ASSERT(allotted <= client.max_workers(), nullptr);
             }
             client.set_allotment(allotted);
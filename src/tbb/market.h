@@ -48,9 +48,15 @@ private:
     //! Recalculates the number of workers assigned to each arena in the list.
     void update_allotment();
 
+    //! Distributes the workers of a priority level between its arenas in proportion to their weights.
+    void update_weighted_allotment(unsigned list_idx, int assigned_per_priority);
+
     //! Keys for the arena map array. The lower the value the higher priority of the arena list.
     static constexpr unsigned num_priority_levels = d1::num_priority_levels;
 
+    //! Reserves the guaranteed workers of the arenas with demand; returns the number of reserved workers.
+    int reserve_guaranteed_workers(int available_workers, int (&guaranteed_per_priority)[num_priority_levels]);
+
     using mutex_type = d1::rw_mutex;
     mutex_type my_mutex;
 
@@ -66,6 +72,12 @@ private:
     //! How many times mandatory concurrency was requested from the market
     int my_mandatory_num_requested{0};
 
+    //! Number of arenas with an explicit weight per priority list item
+    int my_num_weighted_clients[num_priority_levels] = {0};
+
+    //! Number of arenas with guaranteed workers
+    int my_num_guaranteed_clients{0};
+
     //! Per priority list of registered arenas
     using clients_container_type = std::vector<pm_client*, tbb::tbb_allocator<pm_client*>>;
     clients_container_type my_clients[num_priority_levels];
@@ -41,6 +41,7 @@
 
 #if !_WIN32
 #include <unistd.h> // sysconf(_SC_PAGESIZE)
+#include <time.h>   // clock_gettime(CLOCK_THREAD_CPUTIME_ID)
 #endif
 
 namespace tbb {
@@ -70,6 +71,26 @@ size_t DefaultSystemPageSize() {
 #endif
 }
 
+std::uint64_t ThreadCpuTime() {
+#if _WIN32
+    FILETIME creation_time, exit_time, kernel_time, user_time;
+    if (!GetThreadTimes(GetCurrentThread(), &creation_time, &exit_time, &kernel_time, &user_time))
+        return 0;
+    auto to_ticks = [] (const FILETIME& t) {
+        return std::uint64_t(t.dwHighDateTime) << 32 | t.dwLowDateTime;
+    };
+    // FILETIME is measured in 100-nanosecond intervals
+    return (to_ticks(kernel_time) + to_ticks(user_time)) * 100;
+#elif defined(CLOCK_THREAD_CPUTIME_ID)
+    timespec ts;
+    if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts) != 0)
+        return 0;
+    return std::uint64_t(ts.tv_sec) * 1000000000 + std::uint64_t(ts.tv_nsec);
+#else
+    return 0;
+#endif
+}
+
 /** The leading "\0" is here so that applying "strings" to the binary delivers a clean result. */
 static const char VersionString[] = "\0" TBB_VERSION_STRINGS;
 
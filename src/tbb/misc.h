@@ -74,6 +74,9 @@ inline int AvailableHwConcurrency() {
 //! Returns OS regular memory page size
 size_t DefaultSystemPageSize();
 
+//! Returns the CPU time consumed by the calling thread in nanoseconds, or 0 if it is unknown
+std::uint64_t ThreadCpuTime();
+
 //! Returns number of processor groups in the current OS configuration.
 /** AvailableHwConcurrency must be called at least once before calling this method. **/
 int NumberOfProcessorGroups();
@@ -215,7 +218,8 @@ void detect_cpu_features(cpu_features_type& cpu_features);
 
 class binding_handler;
 
-binding_handler* construct_binding_handler(int slot_num, int numa_id, int core_type_id, int max_threads_per_core);
+binding_handler* construct_binding_handler(int slot_num, int numa_id, int core_type_id, int max_threads_per_core,
+                                           int placement);
 void destroy_binding_handler(binding_handler* handler_ptr);
 void apply_affinity_mask(binding_handler* handler_ptr, int slot_num);
 void restore_affinity_mask(binding_handler* handler_ptr, int slot_num);
@@ -0,0 +1,89 @@
+/*
+    Copyright (c) 2025 UXL Foundation Contributors
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#ifndef _TBB_parking_slot_H
+#define _TBB_parking_slot_H
+
+#include "oneapi/tbb/detail/_utils.h"
+#include "oneapi/tbb/detail/_machine.h"
+
+#include "semaphore.h"
+
+#include <atomic>
+#include <chrono>
+
+//! Park retained workers on a futex instead of yielding in a loop
+#ifndef __TBB_WORKER_PARKING
+#define __TBB_WORKER_PARKING __TBB_USE_FUTEX
+#endif
+
+namespace tbb {
+namespace detail {
+namespace r1 {
+
+//! A place where a single thread can block for a limited time until another thread unparks it.
+/** Unlike concurrent_monitor, neither parking nor unparking takes a lock or walks a list of waiters:
+    the state is a single futex word. Without futex support parking degrades to a yield. **/
+class parking_slot {
+public:
+    //! Blocks the calling thread until it is unparked or the timeout expires.
+    /** The predicate is checked after the slot is published as parked, so a thread that makes
+        the predicate true and then calls unpark() cannot be missed. **/
+    template <typename Pred>
+    void park(std::chrono::microseconds timeout, Pred&& wakeup_condition) {
+#if __TBB_WORKER_PARKING
+        __TBB_ASSERT(my_state.load(std::memory_order_relaxed) == running, "The slot is already parked");
+        my_state.store(parked, std::memory_order_seq_cst);
+        if (!wakeup_condition()) {
+            futex_wait_for(&my_state, parked, long(std::chrono::nanoseconds(timeout).count()));
+        }
+        my_state.store(running, std::memory_order_relaxed);
+#else
+        suppress_unused_warning(timeout, wakeup_condition);
+        d0::yield();
+#endif
+    }
+
+    //! Wakes up the parked thread; returns false if no thread is parked in the slot.
+    bool unpark() {
+#if __TBB_WORKER_PARKING
+        int expected = parked;
+        if (my_state.load(std::memory_order_relaxed) == parked &&
+            my_state.compare_exchange_strong(expected, unparked))
+        {
+            futex_wakeup_one(&my_state);
+            return true;
+        }
+#endif
+        return false;
+    }
+
+private:
+    enum state : int {
+        running,
+        parked,
+        unparked
+    };
+
+    //! Zero initialized (running) as a part of arena storage
+    std::atomic<int> my_state;
+};
+
+} // namespace r1
+} // namespace detail
+} // namespace tbb
+
+#endif /* _TBB_parking_slot_H */
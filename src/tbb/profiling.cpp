@@ -20,6 +20,8 @@
 
 #include "main.h"
 #include "itt_notify.h"
+#include "governor.h"
+#include "scheduler_trace.h"
 
 #include "oneapi/tbb/profiling.h"
 
@@ -29,6 +31,13 @@ namespace tbb {
 namespace detail {
 namespace r1 {
 
+//! The flow graph reports the execution of node bodies as ITT tasks in the flow domain
+static inline void trace_flow_task(d1::itt_domain_enum domain, trace_event event, void* object) {
+    if (domain == d1::ITT_DOMAIN_FLOW && governor::scheduler_tracing()) {
+        trace_current_thread(event, object);
+    }
+}
+
 #if __TBB_USE_ITT_NOTIFY
 bool ITT_Present;
 static std::atomic<bool> ITT_InitializationDone;
@@ -192,6 +201,7 @@ void __TBB_EXPORTED_FUNC itt_relation_add(d1::itt_domain_enum domain, void *addr
 
 void __TBB_EXPORTED_FUNC itt_task_begin(d1::itt_domain_enum domain, void* task, unsigned long long task_extra,
                     void* parent, unsigned long long parent_extra, string_resource_index name_index) {
+    trace_flow_task(domain, trace_event::flow_task_begin, task);
     if (__itt_domain* d = get_itt_domain(domain)) {
         __itt_id task_id = itt_null_id;
         __itt_id parent_id = itt_null_id;
@@ -207,6 +217,7 @@ void __TBB_EXPORTED_FUNC itt_task_begin(d1::itt_domain_enum domain, void* task,
 }
 
 void __TBB_EXPORTED_FUNC itt_task_end(d1::itt_domain_enum domain) {
+    trace_flow_task(domain, trace_event::flow_task_end, nullptr);
     if (__itt_domain* d = get_itt_domain(domain)) {
         __itt_task_end(d);
     }
@@ -245,9 +256,13 @@ void itt_metadata_ptr_add(d1::itt_domain_enum /*domain*/, void * /*addr*/, unsig
                           string_resource_index /*key*/, void * /*value*/ ) {}
 void itt_relation_add(d1::itt_domain_enum /*domain*/, void* /*addr0*/, unsigned long long /*addr0_extra*/,
                       itt_relation /*relation*/, void* /*addr1*/, unsigned long long /*addr1_extra*/ ) { }
-void itt_task_begin(d1::itt_domain_enum /*domain*/, void* /*task*/, unsigned long long /*task_extra*/,
-                        void* /*parent*/, unsigned long long /*parent_extra*/, string_resource_index /*name_index*/ ) { }
-void itt_task_end(d1::itt_domain_enum /*domain*/ ) { }
+void itt_task_begin(d1::itt_domain_enum domain, void* task, unsigned long long /*task_extra*/,
+                        void* /*parent*/, unsigned long long /*parent_extra*/, string_resource_index /*name_index*/ ) {
+    trace_flow_task(domain, trace_event::flow_task_begin, task);
+}
+void itt_task_end(d1::itt_domain_enum domain) {
+    trace_flow_task(domain, trace_event::flow_task_end, nullptr);
+}
 void itt_region_begin(d1::itt_domain_enum /*domain*/, void* /*region*/, unsigned long long /*region_extra*/,
                           void* /*parent*/, unsigned long long /*parent_extra*/, string_resource_index /*name_index*/ ) { }
 void itt_region_end(d1::itt_domain_enum /*domain*/, void* /*region*/, unsigned long long /*region_extra*/ ) { }
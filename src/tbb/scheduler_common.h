@@ -29,10 +29,17 @@
 #include "co_context.h"
 #include "misc.h"
 #include "governor.h"
+#include "thread_locality.h"
 
 #ifndef __TBB_SCHEDULER_MUTEX_TYPE
 #define __TBB_SCHEDULER_MUTEX_TYPE tbb::spin_mutex
 #endif
+
+//! Use the lock-free (Chase-Lev) work-stealing deque for arena slot task pools
+#ifndef __TBB_LOCK_FREE_TASK_POOL
+#define __TBB_LOCK_FREE_TASK_POOL 0
+#endif
+
 // TODO: add conditional inclusion based on specified type
 #include "oneapi/tbb/spin_mutex.h"
 #include "oneapi/tbb/mutex.h"
@@ -115,6 +122,10 @@ struct task_accessor {
         isolation_type* tag = reinterpret_cast<isolation_type*>(&t.m_reserved[2]);
         return *tag;
     }
+    //! The time the task was put into the queue of the arena; zero if not tracked
+    static std::uint64_t& enqueue_time(d1::task& t) {
+        return t.m_reserved[3];
+    }
     static void set_proxy_trait(d1::task& t) {
         // TODO: refactor proxy tasks not to work on uninitialized memory.
         //__TBB_ASSERT((t.m_version_and_traits & proxy_task_trait) == 0, nullptr);
@@ -310,23 +321,6 @@ public:
 //------------------------------------------------------------------------
 // Exception support
 //------------------------------------------------------------------------
-//! Task group state change propagation global epoch
-/** Together with generic_scheduler::my_context_state_propagation_epoch forms
-    cross-thread signaling mechanism that allows to avoid locking at the hot path
-    of normal execution flow.
-
-    When a descendant task group context is registered or unregistered, the global
-    and local epochs are compared. If they differ, a state change is being propagated,
-    and thus registration/deregistration routines take slower branch that may block
-    (at most one thread of the pool can be blocked at any moment). Otherwise the
-    control path is lock-free and fast. **/
-extern std::atomic<std::uintptr_t> the_context_state_propagation_epoch;
-
-//! Mutex guarding state change propagation across task groups forest.
-/** Also protects modification of related data structures. **/
-typedef scheduler_mutex_type context_state_propagation_mutex_type;
-extern context_state_propagation_mutex_type the_context_state_propagation_mutex;
-
 class tbb_exception_ptr {
     std::exception_ptr my_ptr;
 public:
@@ -652,9 +646,10 @@ public:
     d1::task* get_inbox_or_critical_task(execution_data_ext&, mail_inbox&, isolation_type, bool);
     d1::task* get_stream_or_critical_task(execution_data_ext&, arena&, task_stream<front_accessor>&,
                                       unsigned& /*hint_for_stream*/, isolation_type,
-                                      bool /*critical_allowed*/);
+                                      bool /*critical_allowed*/, int /*numa_node*/ = unknown_numa_node);
+    d1::task* get_deadline_or_critical_task(execution_data_ext&, arena&, isolation_type, bool /*critical_allowed*/);
     d1::task* steal_or_get_critical(execution_data_ext&, arena&, unsigned /*arena_index*/, FastRandom&,
-                                isolation_type, bool /*critical_allowed*/);
+                                steal_locality_state&, isolation_type, bool /*critical_allowed*/);
 
 #if __TBB_RESUMABLE_TASKS
     /* [[noreturn]] */ void co_local_wait_for_all() noexcept;
@@ -683,10 +678,10 @@ inline std::uintptr_t calculate_stealing_threshold(std::uintptr_t base, std::siz
 struct task_group_context_impl {
     static void destroy(d1::task_group_context&);
     static void initialize(d1::task_group_context&);
-    static void register_with(d1::task_group_context&, thread_data*);
+    static void register_with(d1::task_group_context&, d1::task_group_context&);
     static void bind_to_impl(d1::task_group_context&, thread_data*);
     static void bind_to(d1::task_group_context&, thread_data*);
-    static void propagate_task_group_state(d1::task_group_context&, std::atomic<uint32_t> d1::task_group_context::*, d1::task_group_context&, uint32_t);
+    static void propagate_task_group_state(d1::task_group_context&, std::atomic<uint32_t> d1::task_group_context::*, uint32_t);
     static bool cancel_group_execution(d1::task_group_context&);
     static bool is_group_execution_cancelled(const d1::task_group_context&);
     static void reset(d1::task_group_context&);
@@ -0,0 +1,121 @@
+/*
+    Copyright (c) 2025 UXL Foundation Contributors
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#ifndef _TBB_scheduler_counters_H
+#define _TBB_scheduler_counters_H
+
+#include "oneapi/tbb/detail/_utils.h"
+#include "oneapi/tbb/task_arena.h"
+
+#include <atomic>
+#include <cstdint>
+
+//! Collect the scheduler event counters reported by task_arena statistics
+#ifndef __TBB_SCHEDULER_COUNTERS
+#define __TBB_SCHEDULER_COUNTERS 1
+#endif
+
+namespace tbb {
+namespace detail {
+namespace r1 {
+
+//! Scheduler events counted for arena statistics
+enum scheduler_event : unsigned {
+    //! A task is put into the task pool of the thread
+    task_spawned_event,
+    //! A task is executed
+    task_executed_event,
+    //! A steal attempt did not bring a task
+    steal_failed_event,
+    //! A task is taken from the mailbox of the thread (task-to-thread affinity)
+    mailbox_task_event,
+    //! A task is put into the starvation-resistant queue of the arena
+    task_enqueued_event,
+    //! A worker thread joined the arena
+    worker_join_event,
+    //! A worker thread left the arena
+    worker_leave_event,
+    //! A worker thread joined the arena directly after leaving another one
+    worker_handoff_event,
+    //! A thread blocked in the arena waiting for work
+    thread_sleep_event,
+    //! New work in the arena caused a request for threads and a wakeup of the sleeping ones
+    thread_wakeup_event,
+    //! A suspend point is taken from the cache of the arena
+    suspend_point_reused_event,
+    //! A suspend point is created since the cache of the arena is empty
+    suspend_point_created_event,
+    scheduler_events_count
+};
+
+//! Set of event counters
+/** The counters are cheap to update since each set is modified by a single thread in most cases;
+    other sets are only read when statistics are collected, so the result is approximate. **/
+class scheduler_counters {
+public:
+    //! Increments the counter of the event; the caller must be the only thread that modifies the set
+    void count(scheduler_event e) {
+#if __TBB_SCHEDULER_COUNTERS
+        std::atomic<std::uint64_t>& counter = my_counters[e];
+        counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+#else
+        suppress_unused_warning(e);
+#endif
+    }
+
+    //! Increments the counter of the event that can be modified by several threads concurrently
+    void count_concurrently(scheduler_event e) {
+#if __TBB_SCHEDULER_COUNTERS
+        my_counters[e].fetch_add(1, std::memory_order_relaxed);
+#else
+        suppress_unused_warning(e);
+#endif
+    }
+
+    std::uint64_t value(scheduler_event e) const {
+        return my_counters[e].load(std::memory_order_relaxed);
+    }
+
+private:
+    //! Zero initialized as a part of arena storage
+    std::atomic<std::uint64_t> my_counters[scheduler_events_count];
+};
+
+//! Histogram of the time enqueued tasks spend in the queue of an arena
+/** Recorded concurrently by the threads that take the tasks from the queue. **/
+class latency_recorder {
+public:
+    using histogram_type = d1::task_arena_statistics::latency_histogram;
+
+    void record(std::uint64_t nanoseconds) {
+        my_counts[histogram_type::bucket_index(nanoseconds)].fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void add_to(histogram_type& histogram) const {
+        for (unsigned i = 0; i < histogram_type::buckets_count; ++i) {
+            histogram.counts[i] += my_counts[i].load(std::memory_order_relaxed);
+        }
+    }
+
+private:
+    std::atomic<std::uint64_t> my_counts[histogram_type::buckets_count];
+};
+
+} // namespace r1
+} // namespace detail
+} // namespace tbb
+
+#endif /* _TBB_scheduler_counters_H */
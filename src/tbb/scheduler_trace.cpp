@@ -0,0 +1,251 @@
+/*
+    Copyright (c) 2025 UXL Foundation Contributors
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#include "oneapi/tbb/cache_aligned_allocator.h"
+#include "oneapi/tbb/spin_mutex.h"
+
+#include "scheduler_trace.h"
+#include "governor.h"
+#include "thread_data.h"
+#include "misc.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+namespace tbb {
+namespace detail {
+namespace r1 {
+
+static spin_mutex trace_registry_mutex;
+//! The list of the buffers of all threads that have ever existed; protected by trace_registry_mutex
+static trace_buffer* trace_buffers_head = nullptr;
+//! The buffers of the exited threads; protected by trace_registry_mutex
+static trace_buffer* trace_free_buffers_head = nullptr;
+static unsigned trace_thread_count = 0;
+//! Set by release(); the buffers are not kept for the dump anymore. Protected by trace_registry_mutex.
+static bool trace_registry_released = false;
+
+static trace_buffer* allocate_trace_buffer(bool is_worker) {
+    return new (cache_aligned_allocate(sizeof(trace_buffer))) trace_buffer(trace_thread_count++, is_worker);
+}
+
+static void free_trace_buffer(trace_buffer* buffer) {
+    buffer->~trace_buffer();
+    cache_aligned_deallocate(buffer);
+}
+
+trace_buffer* trace_registry::register_thread(bool is_worker) {
+    spin_mutex::scoped_lock lock(trace_registry_mutex);
+    if (trace_registry_released) {
+        // The buffer is not dumped anymore, so it is only a sink for the records of the thread
+        return allocate_trace_buffer(is_worker);
+    }
+    if (trace_buffer* buffer = trace_free_buffers_head) {
+        trace_free_buffers_head = buffer->my_next_free;
+        buffer->my_next_free = nullptr;
+        buffer->my_is_attached = true;
+        // Nobody writes into the buffer, so the count is stable. The owners whose records have been
+        // overwritten or who have not written any records are forgotten, so the list stays short.
+        std::vector<trace_buffer_owner>& owners = buffer->my_owners;
+        const std::uint64_t count = buffer->my_count.load(std::memory_order_relaxed);
+        const std::uint64_t oldest = count > trace_buffer::capacity ? count - trace_buffer::capacity : 0;
+        std::size_t kept = 0;
+        for (std::size_t i = 0; i < owners.size(); ++i) {
+            const std::uint64_t end = i + 1 < owners.size() ? owners[i + 1].first_record : count;
+            if (end > oldest && end > owners[i].first_record) {
+                owners[kept++] = owners[i];
+            }
+        }
+        owners.resize(kept);
+        // The new thread gets its own row, while the records of the exited ones keep theirs
+        owners.push_back(trace_buffer_owner{ count, trace_thread_count++, is_worker });
+        return buffer;
+    }
+    trace_buffer* buffer = allocate_trace_buffer(is_worker);
+    buffer->my_next = trace_buffers_head;
+    trace_buffers_head = buffer;
+    return buffer;
+}
+
+void trace_registry::unregister_thread(trace_buffer* buffer) {
+    __TBB_ASSERT(buffer, nullptr);
+    spin_mutex::scoped_lock lock(trace_registry_mutex);
+    __TBB_ASSERT(buffer->my_is_attached, nullptr);
+    if (trace_registry_released) {
+        // The buffer has been detached from the list by release()
+        free_trace_buffer(buffer);
+        return;
+    }
+    buffer->my_is_attached = false;
+    buffer->my_next_free = trace_free_buffers_head;
+    trace_free_buffers_head = buffer;
+}
+
+namespace {
+
+//! The pairs of begin and end events shown as duration slices
+enum trace_slice_kind : unsigned {
+    execute_slice,
+    sleep_slice,
+    arena_slice,
+    flow_slice,
+    trace_slice_kinds_count,
+    no_slice = trace_slice_kinds_count
+};
+
+struct trace_event_format {
+    const char* name;
+    //! Chrome trace event phase: 'B' (begin), 'E' (end) or 'i' (instant)
+    char phase;
+    trace_slice_kind slice;
+};
+
+//! Indexed by trace_event
+const trace_event_format trace_formats[] = {
+    { "spawn",   'i', no_slice },
+    { "steal",   'i', no_slice },
+    { "execute", 'B', execute_slice },
+    { "execute", 'E', execute_slice },
+    { "sleep",   'B', sleep_slice },
+    { "sleep",   'E', sleep_slice },
+    { "arena",   'B', arena_slice },
+    { "arena",   'E', arena_slice },
+    { "flow",    'B', flow_slice },
+    { "flow",    'E', flow_slice }
+};
+
+//! Copies the records that are still in the buffer.
+/** The owning thread may keep writing, so the records overwritten during the copy are dropped.
+    The number of the first copied record is stored into first. **/
+std::vector<trace_record> snapshot(const trace_record* records, const std::atomic<std::uint64_t>& count,
+                                   std::uint64_t& first) {
+    constexpr std::size_t capacity = trace_buffer::capacity;
+    // Acquiring the count makes the records published by the owning thread visible
+    std::uint64_t end = count.load(std::memory_order_acquire);
+    std::uint64_t begin = end > capacity ? end - capacity : 0;
+    std::vector<trace_record> result;
+    result.reserve(std::size_t(end - begin));
+    for (std::uint64_t i = begin; i < end; ++i) {
+        result.push_back(records[i & (capacity - 1)]);
+    }
+    // The fence keeps the copying above the second load of the count. The record with the index of
+    // the count may be in progress, so it overwrites one more record than the count tells.
+    std::atomic_thread_fence(std::memory_order_acquire);
+    std::uint64_t overwritten_end = count.load(std::memory_order_relaxed) + 1;
+    overwritten_end = overwritten_end > capacity ? overwritten_end - capacity : 0;
+    first = begin;
+    if (overwritten_end > begin) {
+        std::uint64_t num_dropped = min(overwritten_end - begin, end - begin);
+        result.erase(result.begin(), result.begin() + std::ptrdiff_t(num_dropped));
+        first += num_dropped;
+    }
+    return result;
+}
+
+} // namespace
+
+void trace_registry::dump() {
+    spin_mutex::scoped_lock lock(trace_registry_mutex);
+    const char* file_name = std::getenv("TBB_TRACE_FILE");
+    if (!file_name || !*file_name) {
+        file_name = "tbb_trace.json";
+    }
+    std::FILE* file = std::fopen(file_name, "w");
+    if (!file) {
+        runtime_warning("cannot open the trace file %s", file_name);
+        return;
+    }
+
+    std::vector<std::vector<trace_record>> snapshots;
+    std::vector<std::uint64_t> snapshot_firsts;
+    std::uint64_t origin = UINT64_MAX;
+    for (trace_buffer* b = trace_buffers_head; b; b = b->my_next) {
+        snapshot_firsts.push_back(0);
+        snapshots.push_back(snapshot(b->my_records, b->my_count, snapshot_firsts.back()));
+        if (!snapshots.back().empty()) {
+            origin = min(origin, snapshots.back().front().timestamp);
+        }
+    }
+
+    std::fprintf(file, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[");
+    const char* separator = "\n";
+    std::size_t idx = 0;
+    for (trace_buffer* b = trace_buffers_head; b; b = b->my_next, ++idx) {
+        const std::vector<trace_record>& records = snapshots[idx];
+        const std::uint64_t first = snapshot_firsts[idx];
+        const std::vector<trace_buffer_owner>& owners = b->my_owners;
+        for (std::size_t o = 0; o < owners.size(); ++o) {
+            const unsigned tid = owners[o].thread_index;
+            std::fprintf(file, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":\"%s %u\"}}",
+                separator, tid, owners[o].is_worker ? "worker" : "thread", tid);
+            separator = ",\n";
+
+            // The records of the owner that are still in the snapshot
+            const std::uint64_t owner_end = o + 1 < owners.size() ? owners[o + 1].first_record : UINT64_MAX;
+            std::uint64_t i = max(owners[o].first_record, first);
+            // The begin events of the oldest records may be overwritten, so the unmatched end events are skipped
+            unsigned depth[trace_slice_kinds_count] = {};
+            for (; i < owner_end && i - first < records.size(); ++i) {
+                const trace_record& r = records[std::size_t(i - first)];
+                const trace_event_format& format = trace_formats[unsigned(r.event)];
+                if (format.phase == 'E') {
+                    if (depth[format.slice] == 0) {
+                        continue;
+                    }
+                    --depth[format.slice];
+                } else if (format.phase == 'B') {
+                    ++depth[format.slice];
+                }
+                std::fprintf(file, "%s{\"name\":\"%s\",\"ph\":\"%c\",%s\"ts\":%.3f,\"pid\":1,\"tid\":%u,\"args\":{\"object\":\"%p\"}}",
+                    separator, format.name, format.phase, format.phase == 'i' ? "\"s\":\"t\"," : "",
+                    double(r.timestamp - origin) / 1000.0, tid, r.object);
+            }
+        }
+    }
+    std::fprintf(file, "\n]}\n");
+    std::fclose(file);
+}
+
+void trace_registry::release() {
+    dump();
+    spin_mutex::scoped_lock lock(trace_registry_mutex);
+    // The threads that still exist may keep recording into their buffers and free them on exit
+    while (trace_buffer* b = trace_buffers_head) {
+        trace_buffers_head = b->my_next;
+        b->my_next = nullptr;
+        if (!b->my_is_attached) {
+            free_trace_buffer(b);
+        }
+    }
+    trace_free_buffers_head = nullptr;
+    trace_registry_released = true;
+}
+
+void trace_current_thread(trace_event event, const void* object) {
+    trace_current_thread(event, object, trace_buffer::now());
+}
+
+void trace_current_thread(trace_event event, const void* object, std::uint64_t timestamp) {
+    thread_data* td = governor::get_thread_data_if_initialized();
+    if (td && td->my_trace_buffer) {
+        td->my_trace_buffer->record(event, object, timestamp);
+    }
+}
+
+} // namespace r1
+} // namespace detail
+} // namespace tbb
@@ -0,0 +1,140 @@
+/*
+    Copyright (c) 2025 UXL Foundation Contributors
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#ifndef _TBB_scheduler_trace_H
+#define _TBB_scheduler_trace_H
+
+#include "oneapi/tbb/detail/_utils.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace tbb {
+namespace detail {
+namespace r1 {
+
+//! Scheduler events collected by the trace recorder (TBB_TRACE)
+/** Each *_begin event must be followed by the matching *_end event on the same thread. **/
+enum class trace_event : std::uint8_t {
+    task_spawn,
+    task_steal,
+    task_execute_begin,
+    task_execute_end,
+    thread_sleep_begin,
+    thread_sleep_end,
+    arena_join,
+    arena_leave,
+    flow_task_begin,
+    flow_task_end
+};
+
+struct trace_record {
+    //! Nanoseconds of the steady clock
+    std::uint64_t timestamp;
+    //! The task, arena or flow graph body the event is related to
+    const void* object;
+    trace_event event;
+};
+
+//! A thread that has written into a trace buffer
+struct trace_buffer_owner {
+    //! The number of records in the buffer when the thread got it
+    std::uint64_t first_record;
+    //! The row of the thread in the trace
+    unsigned thread_index;
+    bool is_worker;
+};
+
+//! Ring buffer of the scheduler events of a single thread.
+/** Only the owning thread writes into the buffer, so recording takes neither locks nor
+    read-modify-write operations. When the buffer is full, the oldest records are overwritten. **/
+class trace_buffer : no_copy {
+public:
+    static constexpr std::size_t capacity = std::size_t(1) << 15;
+
+    trace_buffer(unsigned thread_index, bool is_worker)
+        : my_owners{ trace_buffer_owner{ 0, thread_index, is_worker } } {}
+
+    void record(trace_event event, const void* object) {
+        record(event, object, now());
+    }
+
+    void record(trace_event event, const void* object, std::uint64_t timestamp) {
+        std::uint64_t n = my_count.load(std::memory_order_relaxed);
+        my_records[n & (capacity - 1)] = trace_record{ timestamp, object, event };
+        my_count.store(n + 1, std::memory_order_release);
+    }
+
+    static std::uint64_t now() {
+        return std::uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+
+private:
+    friend class trace_registry;
+
+    //! Next buffer in the list of all buffers
+    trace_buffer* my_next{nullptr};
+    //! Next buffer in the list of the buffers released by their threads
+    trace_buffer* my_next_free{nullptr};
+    //! The threads whose records may be in the buffer, the current owner is the last one.
+    /** Protected by the mutex of the registry. **/
+    std::vector<trace_buffer_owner> my_owners;
+    //! Set while the buffer is owned by a thread, which may still write into it
+    bool my_is_attached{true};
+    //! The number of records ever written; the record n is stored at n % capacity.
+    /** The release store after each record publishes it to the thread that dumps the trace. **/
+    std::atomic<std::uint64_t> my_count{0};
+    trace_record my_records[capacity];
+};
+
+//! Owns the trace buffers of all threads.
+/** The buffers outlive their threads, so the whole history can be written out at any time.
+    The buffer of an exited thread is reused by the next new thread, so the number of buffers is
+    bounded by the largest number of threads that exist at the same time. **/
+class trace_registry {
+public:
+    //! Provides a buffer for the calling thread; the buffer released by an exited thread is preferred.
+    /** A reused buffer keeps the records of the exited threads; each thread has its own row in
+        the trace. **/
+    static trace_buffer* register_thread(bool is_worker);
+
+    //! Makes the buffer of the exiting thread available to the threads created later.
+    /** After release(), the buffer is freed instead. **/
+    static void unregister_thread(trace_buffer* buffer);
+
+    //! Writes the records of all threads in the Chrome trace event format to the file named
+    //! by TBB_TRACE_FILE (tbb_trace.json by default). The format is also understood by Perfetto.
+    static void dump();
+
+    //! Dumps the records and frees the buffers of the exited threads.
+    /** The buffers of the threads that still exist are freed when the threads exit. **/
+    static void release();
+};
+
+//! Records the event into the buffer of the calling thread, if the thread has one.
+/** For the places that do not have thread_data at hand. **/
+void trace_current_thread(trace_event event, const void* object);
+void trace_current_thread(trace_event event, const void* object, std::uint64_t timestamp);
+
+} // namespace r1
+} // namespace detail
+} // namespace tbb
+
+#endif /* _TBB_scheduler_trace_H */
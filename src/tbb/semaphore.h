@@ -63,6 +63,7 @@ are known to provide such headers, other systems might have them as well.
 
 #include <climits>
 #include <cerrno>
+#include <ctime>
 
 /*
 Some systems might not define the macros or use different names. In such case we expect
@@ -110,6 +111,21 @@ static inline int futex_wait( void *futex, int comparand ) {
     return r;
 }
 
+//! Waits until woken up, the value differs from the comparand, or the relative timeout expires
+static inline int futex_wait_for( void *futex, int comparand, long timeout_ns ) {
+    struct timespec timeout = { time_t(timeout_ns / 1000000000L), timeout_ns % 1000000000L };
+#ifdef __OpenBSD__
+    int r = ::futex((volatile uint32_t *)futex, __TBB_FUTEX_WAIT, comparand, &timeout, nullptr);
+#else
+    int r = ::syscall(SYS_futex, futex, __TBB_FUTEX_WAIT, comparand, &timeout, nullptr, 0);
+#endif
+#if TBB_USE_ASSERT
+    int e = errno;
+    __TBB_ASSERT(r == 0 || r == EWOULDBLOCK || (r == -1 && (e == EAGAIN || e == EINTR || e == ETIMEDOUT)), "futex_wait_for failed.");
+#endif /* TBB_USE_ASSERT */
+    return r;
+}
+
 static inline int futex_wakeup_one( void *futex ) {
 #ifdef __OpenBSD__
     int r = ::futex((volatile uint32_t *)futex, __TBB_FUTEX_WAKE, 1 , nullptr, nullptr);
@@ -23,6 +23,7 @@
 #include "task_dispatcher.h"
 #include "waiters.h"
 #include "itt_notify.h"
+#include "async_wait.h"
 
 #include "oneapi/tbb/detail/_task.h"
 #include "oneapi/tbb/partitioner.h"
@@ -81,10 +82,13 @@ suspend_point_type* current_suspend_point() {
 task_dispatcher& create_coroutine(thread_data& td) {
     // We may have some task dispatchers cached
     task_dispatcher* task_disp = td.my_arena->my_co_cache.pop();
-    if (!task_disp) {
+    if (task_disp) {
+        td.my_arena_slot->count(suspend_point_reused_event);
+    } else {
         void* ptr = cache_aligned_allocate(sizeof(task_dispatcher));
         task_disp = new(ptr) task_dispatcher(td.my_arena);
         task_disp->init_suspend_point(td.my_arena, td.my_arena->my_threading_control->worker_stack_size());
+        td.my_arena_slot->count(suspend_point_created_event);
     }
     // Prolong the arena's lifetime until all coroutines is alive
     // (otherwise the arena can be destroyed while some tasks are suspended).
@@ -130,6 +134,8 @@ bool task_dispatcher::resume(task_dispatcher& target) {
         __TBB_ASSERT(td != nullptr, "This task dispatcher must be attach to a thread data");
         __TBB_ASSERT(td->my_task_dispatcher == this, "Thread data must be attached to this task dispatcher");
 
+        // The isolation segments of the slot belong to the regions of this task dispatcher
+        td->my_arena_slot->reset_isolation_segment();
         // Change the task dispatcher
         td->detach_task_dispatcher();
         td->attach_task_dispatcher(target);
@@ -223,6 +229,50 @@ void notify_waiters(std::uintptr_t wait_ctx_addr) {
     governor::get_thread_data()->my_arena->get_waiting_threads_monitor().notify(is_related_wait_ctx);
 }
 
+//------------------------------------------------------------------------
+// C++20 coroutines
+//------------------------------------------------------------------------
+void async_wait_impl::suspend(d1::suspended_coroutine& sc) {
+    thread_data& td = *governor::get_thread_data();
+    __TBB_ASSERT(sc.m_arena == nullptr, "The coroutine is suspended already");
+    sc.m_arena = td.my_arena;
+    sc.m_arena->on_coroutine_suspended();
+}
+
+void async_wait_impl::resume(d1::suspended_coroutine& sc, bool aborted) {
+    arena* a = sc.m_arena;
+    assert_pointer_valid(a, "The coroutine is not suspended");
+    // The task might suspend the coroutine again
+    sc.m_arena = nullptr;
+    sc.m_aborted = aborted;
+    // Thread data is only needed for FastRandom instance
+    a->enqueue_task(sc, *a->my_default_ctx, *governor::get_thread_data());
+    // Do not access sc after that point, it might be resumed already
+    a->on_coroutine_resumed();
+}
+
+void async_wait_impl::cancel(d1::suspended_coroutine& sc) {
+    arena* a = sc.m_arena;
+    assert_pointer_valid(a, "The coroutine is not suspended");
+    sc.m_arena = nullptr;
+    a->on_coroutine_resumed();
+}
+
+void __TBB_EXPORTED_FUNC suspend_in_current_arena(d1::suspended_coroutine& sc) {
+    async_wait_impl::suspend(sc);
+}
+
+void __TBB_EXPORTED_FUNC resume_in_arena(d1::suspended_coroutine& sc) {
+    async_wait_impl::resume(sc, /*aborted = */ false);
+}
+
+bool __TBB_EXPORTED_FUNC wait_async(d1::wait_context& wc, d1::suspended_coroutine& sc) {
+    // The arena is not specified in the context, so the node is not notified about new work in arenas
+    market_context ctx{std::uintptr_t(&wc), nullptr};
+    thread_control_monitor& monitor = governor::get_thread_data()->my_arena->get_waiting_threads_monitor();
+    return suspend_on_monitor(monitor, ctx, sc, [&wc] { return async_wait_impl::continue_execution(wc); });
+}
+
 d1::wait_tree_vertex_interface* get_thread_reference_vertex(d1::wait_tree_vertex_interface* top_wait_context) {
     __TBB_ASSERT(top_wait_context, nullptr);
     auto& dispatcher = *governor::get_thread_data()->my_task_dispatcher;
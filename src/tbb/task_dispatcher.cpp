@@ -22,8 +22,10 @@ namespace tbb {
 namespace detail {
 namespace r1 {
 
-static inline void spawn_and_notify(d1::task& t, arena_slot* slot, arena* a) {
+static inline void spawn_and_notify(d1::task& t, arena_slot* slot, arena* a, thread_data& tls) {
     slot->spawn(t);
+    slot->count(task_spawned_event);
+    tls.trace(trace_event::task_spawn, &t);
     a->advertise_new_work<arena::work_spawned>();
     // TODO: TBB_REVAMP_TODO slot->assert_task_pool_valid();
 }
@@ -37,7 +39,7 @@ void __TBB_EXPORTED_FUNC spawn(d1::task& t, d1::task_group_context& ctx) {
     task_accessor::context(t) = &ctx;
     // Mark isolation
     task_accessor::isolation(t) = tls->my_task_dispatcher->m_execute_data_ext.isolation;
-    spawn_and_notify(t, slot, a);
+    spawn_and_notify(t, slot, a, *tls);
 }
 
 void __TBB_EXPORTED_FUNC spawn(d1::task& t, d1::task_group_context& ctx, d1::slot_id id) {
@@ -69,9 +71,9 @@ void __TBB_EXPORTED_FUNC spawn(d1::task& t, d1::task_group_context& ctx, d1::slo
         // Mail the proxy - after this point t may be destroyed by another thread at any moment.
         proxy->outbox->push(proxy);
         // Spawn proxy to the local task pool
-        spawn_and_notify(*proxy, slot, a);
+        spawn_and_notify(*proxy, slot, a, *tls);
     } else {
-        spawn_and_notify(t, slot, a);
+        spawn_and_notify(t, slot, a, *tls);
     }
 }
 
@@ -97,6 +99,8 @@ void __TBB_EXPORTED_FUNC submit(d1::task& t, d1::task_group_context& ctx, arena*
 #endif
         {
             slot->spawn(t);
+            slot->count(task_spawned_event);
+            tls.trace(trace_event::task_spawn, &t);
         }
     } else {
         random_lane_selector lane_selector{tls.my_random};
@@ -109,7 +113,9 @@ void __TBB_EXPORTED_FUNC submit(d1::task& t, d1::task_group_context& ctx, arena*
 #endif
         {
             // Avoid joining the arena the thread is not currently in.
-            a->my_fifo_task_stream.push( &t, lane_selector );
+            a->mark_enqueue_time(t);
+            a->push_to_fifo_stream( t, tls );
+            a->my_shared_counters.count_concurrently(task_enqueued_event);
         }
     }
     // It is assumed that some thread will explicitly wait in the arena the task is submitted
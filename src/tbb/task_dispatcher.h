@@ -153,21 +153,32 @@ inline d1::task* task_dispatcher::get_inbox_or_critical_task(
 
 inline d1::task* task_dispatcher::get_stream_or_critical_task(
     execution_data_ext& ed, arena& a, task_stream<front_accessor>& stream, unsigned& hint,
-    isolation_type isolation, bool critical_allowed)
+    isolation_type isolation, bool critical_allowed, int numa_node)
 {
     if (stream.empty())
         return nullptr;
     d1::task* result = get_critical_task(nullptr, ed, isolation, critical_allowed);
     if (result)
         return result;
-    return a.get_stream_task(stream, hint);
+    return a.get_stream_task(stream, hint, numa_node);
+}
+
+inline d1::task* task_dispatcher::get_deadline_or_critical_task(
+    execution_data_ext& ed, arena& a, isolation_type isolation, bool critical_allowed)
+{
+    if (a.my_deadline_task_stream.empty())
+        return nullptr;
+    d1::task* result = get_critical_task(nullptr, ed, isolation, critical_allowed);
+    if (result)
+        return result;
+    return a.my_deadline_task_stream.pop();
 }
 
 inline d1::task* task_dispatcher::steal_or_get_critical(
     execution_data_ext& ed, arena& a, unsigned arena_index, FastRandom& random,
-    isolation_type isolation, bool critical_allowed)
+    steal_locality_state& locality_state, isolation_type isolation, bool critical_allowed)
 {
-    if (d1::task* t = a.steal_task(arena_index, random, ed, isolation)) {
+    if (d1::task* t = a.steal_task(arena_index, random, locality_state, ed, isolation)) {
         ed.context = task_accessor::context(*t);
         ed.isolation = task_accessor::isolation(*t);
         return get_critical_task(t, ed, isolation, critical_allowed);
@@ -192,6 +203,7 @@ d1::task* task_dispatcher::receive_or_steal_task(
     unsigned& resume_hint = slot.hint_for_resume_stream;
     task_stream<front_accessor>& fifo_stream = a.my_fifo_task_stream;
     unsigned& fifo_hint = slot.hint_for_fifo_stream;
+    int fifo_numa_node = fifo_stream.is_partitioned() ? tls.numa_node() : unknown_numa_node;
 
     waiter.reset_wait();
     // Thread is in idle state now
@@ -222,12 +234,19 @@ d1::task* task_dispatcher::receive_or_steal_task(
             // Successfully got the resume or critical task
         }
         else if (fifo_allowed && isolation == no_isolation
-                 && (t = get_stream_or_critical_task(ed, a, fifo_stream, fifo_hint, isolation, critical_allowed))) {
+                 && (t = get_deadline_or_critical_task(ed, a, isolation, critical_allowed))) {
+            // The enqueued tasks with deadlines go first; the earliest deadline is taken.
+            a.record_enqueue_latency(*t);
+        }
+        else if (fifo_allowed && isolation == no_isolation
+                 && (t = get_stream_or_critical_task(ed, a, fifo_stream, fifo_hint, isolation, critical_allowed, fifo_numa_node))) {
             // Checked if there are tasks in starvation-resistant stream. Only allowed at the outermost dispatch level without isolation.
+            a.record_enqueue_latency(*t);
         }
         else if (stealing_is_allowed
-                 && (t = steal_or_get_critical(ed, a, arena_index, tls.my_random, isolation, critical_allowed))) {
+                 && (t = steal_or_get_critical(ed, a, arena_index, tls.my_random, tls.my_steal_locality, isolation, critical_allowed))) {
             // Stole a task from a random arena slot
+            tls.trace(trace_event::task_steal, t);
         }
         else {
             t = get_critical_task(t, ed, isolation, critical_allowed);
@@ -343,13 +362,18 @@ d1::task* task_dispatcher::local_wait_for_all(d1::task* t, Waiter& waiter ) {
                     m_innermost_running_task = t;
 
                     ITT_CALLEE_ENTER(ITTPossible, t, itt_caller);
+                    d1::task* executed_task = t;
+                    m_thread_data->trace(trace_event::task_execute_begin, executed_task);
 
                     if (ed.context->is_group_execution_cancelled()) {
                         t = t->cancel(ed);
                     } else {
+                        m_thread_data->my_arena_slot->count(task_executed_event);
                         t = t->execute(ed);
                     }
 
+                    // The task is not accessed, it may be already destroyed
+                    m_thread_data->trace(trace_event::task_execute_end, executed_task);
                     ITT_CALLEE_LEAVE(ITTPossible, itt_caller);
 
                     // The task affinity in execution data is set for affinitized tasks.
@@ -477,6 +501,7 @@ inline d1::task* task_dispatcher::get_mailbox_task(mail_inbox& my_inbox, executi
         if (d1::task* result = tp->extract_task<task_proxy::mailbox_bit>()) {
             ed.original_slot = (unsigned short)(-2);
             ed.affinity_slot = ed.task_disp->m_thread_data->my_arena_index;
+            ed.task_disp->m_thread_data->my_arena_slot->count(mailbox_task_event);
             return result;
         }
         // We have exclusive access to the proxy, and can destroy it.
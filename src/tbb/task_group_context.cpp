@@ -59,9 +59,15 @@ void task_group_context_impl::destroy(d1::task_group_context& ctx) {
 
     if (ctx.my_context_list != nullptr) {
         __TBB_ASSERT(ctx.my_state.load(std::memory_order_relaxed) == d1::task_group_context::state::bound, nullptr);
-        // The owner can be destroyed at any moment. Access the associate data with caution.
+        // The parent can be destroyed at any moment. Access the associate data with caution.
         ctx.my_context_list->remove(ctx.my_node);
     }
+    // Unlinking from the parent first guarantees that no propagation reaches the children
+    // through this context, so the list of children is not locked in a nested manner.
+    if (context_list* children = ctx.my_children.load(std::memory_order_relaxed)) {
+        // The children still alive keep the list until the last of them is destroyed.
+        children->orphan();
+    }
     d1::cpu_ctl_env* ctl = reinterpret_cast<d1::cpu_ctl_env*>(&ctx.my_cpu_ctl_env);
 #if _MSC_VER && _MSC_VER <= 1900 && !__INTEL_COMPILER
     suppress_unused_warning(ctl);
@@ -73,6 +79,7 @@ void task_group_context_impl::destroy(d1::task_group_context& ctx) {
 
     poison_pointer(ctx.my_parent);
     poison_pointer(ctx.my_context_list);
+    poison_pointer(ctx.my_children);
     poison_pointer(ctx.my_node.my_next_node);
     poison_pointer(ctx.my_node.my_prev_node);
     poison_pointer(ctx.my_exception);
@@ -93,6 +100,7 @@ void task_group_context_impl::initialize(d1::task_group_context& ctx) {
     ctx.my_state.store(d1::task_group_context::state::created, std::memory_order_relaxed);
     ctx.my_parent = nullptr;
     ctx.my_context_list = nullptr;
+    ctx.my_children.store(nullptr, std::memory_order_relaxed);
     ctx.my_exception.store(nullptr, std::memory_order_relaxed);
     ctx.my_itt_caller = nullptr;
 
@@ -102,12 +110,38 @@ void task_group_context_impl::initialize(d1::task_group_context& ctx) {
         ctl->get_env();
 }
 
-void task_group_context_impl::register_with(d1::task_group_context& ctx, thread_data* td) {
-    __TBB_ASSERT(!is_poisoned(ctx.my_context_list), nullptr);
-    __TBB_ASSERT(td, nullptr);
-    ctx.my_context_list = td->my_context_list;
+void task_group_context_impl::register_with(d1::task_group_context& ctx, d1::task_group_context& parent) {
+    __TBB_ASSERT(!is_poisoned(parent.my_children), nullptr);
+    context_list* children = parent.my_children.load(std::memory_order_acquire);
+    if (children == nullptr) {
+        // The first children of the parent may be bound concurrently in several threads.
+        // The sequentially consistent exchange pairs with the loads of the list in the propagation
+        // (see the comment 2 at the end of the file).
+        context_list* new_list = new (cache_aligned_allocate(sizeof(context_list))) context_list{};
+        if (parent.my_children.compare_exchange_strong(children, new_list, std::memory_order_seq_cst)) {
+            ITT_SYNC_CREATE(&new_list->m_mutex, SyncType_Scheduler, SyncObj_ContextsList);
+            children = new_list;
+        } else {
+            new_list->destroy();
+        }
+    }
 
-    ctx.my_context_list->push_front(ctx.my_node);
+    // The propagation marks the parent before it locks the list of its children. So, the state
+    // inherited under the lock is either the new one, or the propagation has not reached the list
+    // yet and will find the context in it.
+    children->push_front_if(ctx.my_node, [&ctx, &parent, children] {
+        __TBB_ASSERT(!is_poisoned(ctx.my_context_list), nullptr);
+        // The first children of a scoped context can register it concurrently in several threads
+        if (ctx.my_context_list != nullptr) {
+            __TBB_ASSERT(ctx.my_context_list == children, nullptr);
+            return false;
+        }
+        ctx.my_context_list = children;
+        if (parent.my_cancellation_requested.load(std::memory_order_seq_cst)) {
+            ctx.my_cancellation_requested.store(1, std::memory_order_relaxed);
+        }
+        return true;
+    });
 }
 
 void task_group_context_impl::bind_to_impl(d1::task_group_context& ctx, thread_data* td) {
@@ -122,43 +156,21 @@ void task_group_context_impl::bind_to_impl(d1::task_group_context& ctx, thread_d
     if (!ctx.my_traits.fp_settings)
         copy_fp_settings(ctx, *ctx.my_parent);
 
+    d1::task_group_context& parent = *ctx.my_parent;
     // Condition below prevents unnecessary thrashing parent context's cache line
-    if (ctx.my_parent->my_may_have_children.load(std::memory_order_relaxed) != d1::task_group_context::may_have_children) {
-        ctx.my_parent->my_may_have_children.store(d1::task_group_context::may_have_children, std::memory_order_relaxed); // full fence is below
-    }
-    if (ctx.my_parent->my_parent) {
-        // Even if this context were made accessible for state change propagation
-        // (by placing store_with_release(td->my_context_list_state.head.my_next, &ctx.my_node)
-        // above), it still could be missed if state propagation from a grand-ancestor
-        // was underway concurrently with binding.
-        // Speculative propagation from the parent together with epoch counters
-        // detecting possibility of such a race allow to avoid taking locks when
-        // there is no contention.
-
-        // Acquire fence is necessary to prevent reordering subsequent speculative
-        // loads of parent state data out of the scope where epoch counters comparison
-        // can reliably validate it.
-        uintptr_t local_count_snapshot = ctx.my_parent->my_context_list->epoch.load(std::memory_order_acquire);
-        // Speculative propagation of parent's state. The speculation will be
-        // validated by the epoch counters check further on.
-        ctx.my_cancellation_requested.store(ctx.my_parent->my_cancellation_requested.load(std::memory_order_relaxed), std::memory_order_relaxed);
-        register_with(ctx, td); // Issues full fence
-
-        // If no state propagation was detected by the following condition, the above
-        // full fence guarantees that the parent had correct state during speculative
-        // propagation before the fence. Otherwise the propagation from parent is
-        // repeated under the lock.
-        if (local_count_snapshot != the_context_state_propagation_epoch.load(std::memory_order_relaxed)) {
-            // Another thread may be propagating state change right now. So resort to lock.
-            context_state_propagation_mutex_type::scoped_lock lock(the_context_state_propagation_mutex);
-            ctx.my_cancellation_requested.store(ctx.my_parent->my_cancellation_requested.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    if (parent.my_may_have_children.load(std::memory_order_acquire) != d1::task_group_context::may_have_children) {
+        // A scoped parent gets its first child, so the cancellation of its own parent has to be
+        // propagated into it from now on. The parent of a bound context already has children,
+        // so it is registered itself, and the contexts are registered from the root downwards.
+        if (parent.my_traits.scoped && parent.my_state.load(std::memory_order_relaxed) == d1::task_group_context::state::bound) {
+            register_with(parent, *parent.my_parent);
         }
-    } else {
-        register_with(ctx, td); // Issues full fence
-        // As we do not have grand-ancestors, concurrent state propagation (if any)
-        // may originate only from the parent context, and thus it is safe to directly
-        // copy the state from it.
-        ctx.my_cancellation_requested.store(ctx.my_parent->my_cancellation_requested.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        parent.my_may_have_children.store(d1::task_group_context::may_have_children, std::memory_order_release);
+    }
+    // A scoped context is registered when it gets the first child. Until then, its cancellation
+    // state is combined with the one of its parent, which outlives it.
+    if (!ctx.my_traits.scoped) {
+        register_with(ctx, parent);
     }
 }
 
@@ -197,47 +209,78 @@ void task_group_context_impl::bind_to(d1::task_group_context& ctx, thread_data*
     __TBB_ASSERT(ctx.my_state.load(std::memory_order_relaxed) != d1::task_group_context::state::locked, nullptr);
 }
 
-void task_group_context_impl::propagate_task_group_state(d1::task_group_context& ctx, std::atomic<std::uint32_t> d1::task_group_context::* mptr_state, d1::task_group_context& src, std::uint32_t new_state) {
-    __TBB_ASSERT(!is_poisoned(ctx.my_context_list), nullptr);
-    /*  1. if ((ctx.*mptr_state).load(std::memory_order_relaxed) == new_state):
-            Nothing to do, whether descending from "src" or not, so no need to scan.
-            Hopefully this happens often thanks to earlier invocations.
-            This optimization is enabled by LIFO order in the context lists:
-                - new contexts are bound to the beginning of lists;
-                - descendants are newer than ancestors;
-                - earlier invocations are therefore likely to "paint" long chains.
-        2. if (&ctx != &src):
-            This clause is disjunct from the traversal below, which skips src entirely.
-            Note that src.*mptr_state is not necessarily still equal to new_state (another thread may have changed it again).
-            Such interference is probably not frequent enough to aim for optimisation by writing new_state again (to make the other thread back down).
-            Letting the other thread prevail may also be fairer.
-    */
-    if ((ctx.*mptr_state).load(std::memory_order_relaxed) != new_state && &ctx != &src) {
-        for (d1::task_group_context* ancestor = ctx.my_parent; ancestor != nullptr; ancestor = ancestor->my_parent) {
-            if (ancestor == &src) {
-                for (d1::task_group_context* c = &ctx; c != ancestor; c = c->my_parent)
-                    (c->*mptr_state).store(new_state, std::memory_order_relaxed);
-                break;
+void task_group_context_impl::propagate_task_group_state(d1::task_group_context& ctx, std::atomic<std::uint32_t> d1::task_group_context::* mptr_state, std::uint32_t new_state) {
+    __TBB_ASSERT(!is_poisoned(ctx.my_children), nullptr);
+    // The lists are visited one at a time, so at most the list being visited and the list of one of
+    // its children are locked at once. The children are marked under the lock of the list, and the lists
+    // of their own children are collected to be visited after the lock is released. A collected list
+    // is kept alive by the pending flag even if its owner is destroyed in the meantime.
+    context_list* pending_lists = nullptr;
+    // The state of a context is stored before its list is loaded, and both are sequentially
+    // consistent, so the first child bound concurrently either is found in the list or inherits
+    // the new state (see the comment 2 at the end of the file).
+    context_list* children = ctx.my_children.load(std::memory_order_seq_cst);
+    // The list of the context itself is alive while the context is
+    bool is_collected = false;
+    while (children != nullptr) {
+        {
+            // The lock keeps the children alive and orders the propagation with their binding
+            mutex::scoped_lock lock(children->m_mutex);
+            for (auto it = children->begin(); it != children->end(); ++it) {
+                d1::task_group_context& child = __TBB_get_object_ref(d1::task_group_context, my_node, &(*it));
+                // A child that already has the new state is either propagating it or has propagated it
+                // to its own descendants.
+                if ((child.*mptr_state).load(std::memory_order_relaxed) == new_state) {
+                    continue;
+                }
+                (child.*mptr_state).store(new_state, std::memory_order_seq_cst);
+                __TBB_ASSERT(!is_poisoned(child.my_children), nullptr);
+                if (context_list* grandchildren = child.my_children.load(std::memory_order_seq_cst)) {
+                    // The child is alive, so its list is not orphaned yet
+                    mutex::scoped_lock grandchildren_lock(grandchildren->m_mutex);
+                    // A list pending for another propagation is visited by it
+                    if (!grandchildren->pending) {
+                        grandchildren->pending = true;
+                        grandchildren->next_pending = pending_lists;
+                        pending_lists = grandchildren;
+                    }
+                }
             }
         }
+        if (is_collected) {
+            children->finish_pending();
+        }
+        children = pending_lists;
+        if (children != nullptr) {
+            pending_lists = children->next_pending;
+            is_collected = true;
+        }
     }
 }
 
 bool task_group_context_impl::cancel_group_execution(d1::task_group_context& ctx) {
-    __TBB_ASSERT(!is_poisoned(ctx.my_context_list), nullptr);
+    // The context list is not checked for poisoning, since a child may be registering the context concurrently
+    __TBB_ASSERT(ctx.my_state.load(std::memory_order_relaxed) != d1::task_group_context::state::dead, nullptr);
     __TBB_ASSERT(ctx.my_cancellation_requested.load(std::memory_order_relaxed) <= 1, "The cancellation state can be either 0 or 1");
-    if (ctx.my_cancellation_requested.load(std::memory_order_relaxed) || ctx.my_cancellation_requested.exchange(1)) {
+    if (is_group_execution_cancelled(ctx) || ctx.my_cancellation_requested.exchange(1)) {
         // This task group and any descendants have already been canceled.
         // (A newly added descendant would inherit its parent's ctx.my_cancellation_requested,
         // not missing out on any cancellation still being propagated, and a context cannot be uncanceled.)
         return false;
     }
-    governor::get_thread_data()->my_arena->my_threading_control->propagate_task_group_state(&d1::task_group_context::my_cancellation_requested, ctx, uint32_t(1));
+    propagate_task_group_state(ctx, &d1::task_group_context::my_cancellation_requested, uint32_t(1));
     return true;
 }
 
 bool task_group_context_impl::is_group_execution_cancelled(const d1::task_group_context& ctx) {
-    return ctx.my_cancellation_requested.load(std::memory_order_relaxed) != 0;
+    if (ctx.my_cancellation_requested.load(std::memory_order_relaxed) != 0) {
+        return true;
+    }
+    // The cancellations of the parent are not propagated into a scoped context without children
+    return ctx.my_traits.scoped
+        && ctx.my_may_have_children.load(std::memory_order_acquire) != d1::task_group_context::may_have_children
+        && ctx.my_state.load(std::memory_order_acquire) == d1::task_group_context::state::bound
+        && ctx.my_parent->my_cancellation_requested.load(std::memory_order_relaxed) != 0;
 }
 
 // IMPORTANT: If used while tasks are in the context, the cancellation signal can be lost
@@ -282,50 +325,50 @@ void task_group_context_impl::copy_fp_settings(d1::task_group_context& ctx, cons
     implementation in order to reduce the overhead of the cancellation control flow
     should be done only in ways that do not increase overhead of the normal execution.
 
-    In general, contexts are used by all threads and their descendants are created in
-    different threads as well. In order to minimize impact of the cross-thread tree
-    maintenance (first of all because of the synchronization), the tree of contexts
-    is split into pieces, each of which is handled by a single thread. Such pieces
-    are represented as lists of contexts, members of which are contexts that were
-    bound to their parents in the given thread.
-
-    The context tree maintenance and cancellation propagation algorithms are designed
-    in such a manner that cross-thread access to a context list will take place only
-    when cancellation signal is sent (by user or when an exception happens), and
-    synchronization is necessary only then. Thus the normal execution flow (without
-    exceptions and cancellation) remains free from any synchronization done on
-    behalf of exception handling and cancellation support.
-
-2.  Consider parallel cancellations at the different levels of the context tree:
-
-        Ctx1 <- Cancelled by Thread1            |- Thread2 started processing
-         |                                      |
-        Ctx2                                    |- Thread1 started processing
-         |                                   T1 |- Thread2 finishes and syncs up local counters
-        Ctx3 <- Cancelled by Thread2            |
-         |                                      |- Ctx5 is bound to Ctx2
-        Ctx4                                    |
-                                             T2 |- Thread1 reaches Ctx2
-
-    Thread-propagator of each cancellation increments global counter. However the thread
-    propagating the cancellation from the outermost context (Thread1) may be the last
-    to finish. Which means that the local counters may be synchronized earlier (by Thread2,
-    at Time1) than it propagated cancellation into Ctx2 (at time Time2). If a new context
-    (Ctx5) is created and bound to Ctx2 between Time1 and Time2, checking its parent only
-    (Ctx2) may result in cancellation request being lost.
-
-    This issue is solved by doing the whole propagation under the lock.
-
-    If we need more concurrency while processing parallel cancellations, we could try
-    the following modification of the propagation algorithm:
-
-    advance global counter and remember it
-    for each thread:
-        scan thread's list of contexts
-    for each thread:
-        sync up its local counter only if the global counter has not been changed
-
-    However this version of the algorithm requires more analysis and verification.
+    Each context keeps the list of the contexts bound to it. The list is allocated when the
+    first child is bound, so contexts without children (the most common case) do not pay
+    for it. A cancellation walks the subtree of the cancelled context only, so its cost
+    depends on the number of affected contexts rather than on the number of all contexts
+    in the process, and it never blocks the binding of contexts in unrelated trees.
+
+2.  The binding of a child and the propagation into its parent are ordered by the lock of
+    the list of children of the parent:
+
+        Propagation                             Binding
+        mark Ctx2                               lock the list of Ctx2
+        lock the list of Ctx2                   link Ctx5, inherit the state of Ctx2
+        mark and descend into Ctx5 (if linked)  unlock the list of Ctx2
+
+    If the binding takes the lock first, the propagation finds Ctx5 in the list. Otherwise,
+    Ctx5 inherits the new state of Ctx2. Parallel cancellations at different levels of the
+    tree do not need a global lock either: a context is marked before the list of its
+    children is scanned, so a propagation that finds a marked context can skip its subtree,
+    which is (or is being) processed by the propagation that marked it.
+
+    When Ctx2 has no list yet, no lock is shared: the propagation marks Ctx2 and loads its
+    list, while the binding publishes the new list with an exchange and then loads the state
+    of Ctx2. All four accesses are sequentially consistent, so at least one side observes
+    the other: either the propagation finds the list, or Ctx5 inherits the new state. With
+    weaker orderings, the store of each side could be reordered after its load, and both
+    sides could miss each other.
+
+3.  The lists are always locked from the ancestors to the descendants. A context being
+    destroyed first unlinks itself from the list of its parent and only then orphans its
+    own list, so these locks are never nested in the opposite order. The unlinking waits for
+    a propagation that scans the list of the parent, which keeps the context and its list
+    of children alive while the propagation flags the list as pending. A pending list is
+    not deallocated, so it can be visited after the lock of the parent is released. A list
+    of children orphaned by its owner is deallocated by the last child that leaves it or by
+    the propagation that has visited it, whichever is the last.
+
+4.  The contexts of oneTBB algorithms are scoped: they are destroyed before the algorithm
+    returns, so they never outlive the context of the task that runs the algorithm, which
+    is their parent. A scoped context is not linked to its parent when it is bound, so the
+    innermost algorithms, which create most of the contexts, do not lock the list of their
+    parent. Instead, the cancellation state of such a context is combined with the one of
+    its parent when it is checked. The parent is always registered itself, because it has a
+    child. A scoped context is linked to its parent when it gets the first child, before the
+    child is linked to it, so every context with children is reached by the propagation.
 */
 
 void __TBB_EXPORTED_FUNC initialize(d1::task_group_context& ctx) {
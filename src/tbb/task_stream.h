@@ -31,9 +31,12 @@
 #include "scheduler_common.h"
 #include "misc.h" // for FastRandom
 
+#include <algorithm>
 #include <deque>
 #include <climits>
 #include <atomic>
+#include <cstdint>
+#include <vector>
 
 namespace tbb {
 namespace detail {
@@ -144,22 +147,30 @@ protected:
 };
 
 //! The container for "fairness-oriented" aka "enqueued" tasks.
+/** The lanes can be partitioned into equal groups bound to NUMA nodes. Then a thread pushes
+    into the lanes of its node and drains them before it looks at the lanes of other nodes. **/
 template<task_stream_accessor_type accessor>
 class task_stream : public task_stream_accessor< accessor > {
     using lane_t = typename task_stream_accessor<accessor>::lane_t;
     std::atomic<population_t> population{};
     lane_t* lanes{nullptr};
     unsigned N{};
+    //! The number of lane groups, a power of two
+    unsigned groups{1};
 
 public:
     task_stream() = default;
 
-    void initialize( unsigned n_lanes ) {
+    void initialize( unsigned n_lanes, unsigned n_groups = 1 ) {
         const unsigned max_lanes = sizeof(population_t) * CHAR_BIT;
 
+        // Each group gets at least two lanes
+        groups = n_groups > 1 ? 1 << tbb::detail::log2(min(n_groups, max_lanes / 2)) : 1;
+        n_lanes = max(n_lanes, 2 * groups);
         N = n_lanes >= max_lanes ? max_lanes : n_lanes > 2 ? 1 << (tbb::detail::log2(n_lanes - 1) + 1) : 2;
         __TBB_ASSERT( N == max_lanes || (N >= n_lanes && ((N - 1) & N) == 0), "number of lanes miscalculated" );
         __TBB_ASSERT( N <= sizeof(population_t) * CHAR_BIT, nullptr);
+        __TBB_ASSERT( N % groups == 0 && N / groups >= 2, "lanes are not evenly distributed over groups" );
         lanes = static_cast<lane_t*>(cache_aligned_allocate(sizeof(lane_t) * N));
         for (unsigned i = 0; i < N; ++i) {
             new (lanes + i) lane_t;
@@ -201,6 +212,38 @@ public:
         return popped;
     }
 
+    //! Checks if the lanes are partitioned into NUMA groups.
+    bool is_partitioned() const {
+        return groups > 1;
+    }
+
+    //! Push a task into a lane of the group bound to the NUMA node.
+    template<typename lane_selector_t>
+    void push_local( d1::task* source, unsigned numa_node, const lane_selector_t& next_lane ) {
+        const unsigned width = N / groups;
+        const unsigned base = group_of( numa_node ) * width;
+        unsigned lane = 0;
+        do {
+            lane = base + next_lane( /*out_of=*/width );
+            __TBB_ASSERT( lane < base + width, "Incorrect lane index." );
+        } while( !try_push( source, lane ) );
+    }
+
+    //! Try popping a task from the lanes of the group bound to the NUMA node while any of them is populated.
+    template<typename lane_selector_t>
+    d1::task* pop_local( unsigned numa_node, const lane_selector_t& next_lane ) {
+        const unsigned width = N / groups;
+        const unsigned base = group_of( numa_node ) * width;
+        const population_t group_mask = groups > 1 ? ((one << width) - 1) << base : ~population_t(0);
+        d1::task* popped = nullptr;
+        for (atomic_backoff b; (population.load(std::memory_order_relaxed) & group_mask) && !popped; b.pause()) {
+            unsigned lane = base + next_lane( /*out_of=*/width );
+            __TBB_ASSERT( lane < base + width, "Incorrect lane index." );
+            popped = try_pop( lane );
+        }
+        return popped;
+    }
+
     //! Try finding and popping a related task.
     d1::task* pop_specific( unsigned& last_used_lane, isolation_type isolation ) {
         d1::task* result = nullptr;
@@ -230,6 +273,11 @@ public:
     }
 
 private:
+    //! Nodes are mapped to groups by their indices, so several nodes may share a group.
+    unsigned group_of( unsigned numa_node ) const {
+        return numa_node & (groups - 1);
+    }
+
     //! Returns true on successful push, otherwise - false.
     bool try_push(d1::task* source, unsigned lane_idx ) {
         mutex::scoped_lock lock;
@@ -279,6 +327,138 @@ private:
 
 }; // task_stream
 
+//! The container for enqueued tasks that are taken in the order of their deadlines.
+/** Similarly to task_stream, the tasks are spread over lanes protected by their own mutexes.
+    Each lane is a binary heap that publishes its earliest deadline, so a thread looking for
+    the most urgent task locks only the lane that holds it. **/
+class deadline_task_stream : no_copy {
+    struct deadline_task {
+        std::int64_t deadline;
+        d1::task* task;
+
+        //! Makes the standard heap algorithms keep the earliest deadline on top
+        bool operator<(const deadline_task& other) const {
+            return deadline > other.deadline;
+        }
+    };
+
+    struct alignas(max_nfs_size) lane_t {
+        using heap_t = std::vector<deadline_task, cache_aligned_allocator<deadline_task>>;
+
+        heap_t my_heap{};
+        mutex my_mutex{};
+        //! The deadline of the top task of the heap; meaningful only if the population bit is set
+        std::atomic<std::int64_t> my_earliest_deadline{0};
+    };
+
+    std::atomic<population_t> population{};
+    lane_t* lanes{nullptr};
+    unsigned N{};
+
+public:
+    deadline_task_stream() = default;
+
+    void initialize( unsigned n_lanes ) {
+        const unsigned max_lanes = sizeof(population_t) * CHAR_BIT;
+
+        N = n_lanes >= max_lanes ? max_lanes : n_lanes > 2 ? 1 << (tbb::detail::log2(n_lanes - 1) + 1) : 2;
+        __TBB_ASSERT( N == max_lanes || (N >= n_lanes && ((N - 1) & N) == 0), "number of lanes miscalculated" );
+        lanes = static_cast<lane_t*>(cache_aligned_allocate(sizeof(lane_t) * N));
+        for (unsigned i = 0; i < N; ++i) {
+            new (lanes + i) lane_t;
+        }
+        __TBB_ASSERT( !population.load(std::memory_order_relaxed), nullptr);
+    }
+
+    ~deadline_task_stream() {
+        if (lanes) {
+            for (unsigned i = 0; i < N; ++i) {
+                lanes[i].~lane_t();
+            }
+            cache_aligned_deallocate(lanes);
+        }
+    }
+
+    //! Push a task with the deadline into a lane. Lane selection is performed by passed functor.
+    template<typename lane_selector_t>
+    void push( d1::task* source, std::int64_t deadline, const lane_selector_t& next_lane ) {
+        unsigned lane = 0;
+        do {
+            lane = next_lane( /*out_of=*/N );
+            __TBB_ASSERT( lane < N, "Incorrect lane index." );
+        } while( !try_push( source, deadline, lane ) );
+    }
+
+    //! Pops the task with the earliest deadline among the tops of the lanes.
+    /** The lane is chosen by the published deadlines without locking, so concurrent operations
+        may make the choice slightly outdated. **/
+    d1::task* pop() {
+        d1::task* popped = nullptr;
+        for (atomic_backoff b; !empty() && !popped; b.pause()) {
+            unsigned lane = earliest_lane();
+            if (lane < N) {
+                popped = try_pop(lane);
+            }
+        }
+        return popped;
+    }
+
+    //! Checks existence of a task.
+    bool empty() {
+        return !population.load(std::memory_order_relaxed);
+    }
+
+private:
+    //! Returns the index of the populated lane with the earliest deadline, or N if all lanes are empty.
+    unsigned earliest_lane() {
+        unsigned result = N;
+        std::int64_t earliest = 0;
+        population_t p = population.load(std::memory_order_acquire);
+        for (unsigned idx = 0; p; ++idx, p >>= 1) {
+            if (p & one) {
+                std::int64_t deadline = lanes[idx].my_earliest_deadline.load(std::memory_order_relaxed);
+                if (result == N || deadline < earliest) {
+                    result = idx;
+                    earliest = deadline;
+                }
+            }
+        }
+        return result;
+    }
+
+    //! Returns true on successful push, otherwise - false.
+    bool try_push( d1::task* source, std::int64_t deadline, unsigned lane_idx ) {
+        lane_t& lane = lanes[lane_idx];
+        mutex::scoped_lock lock;
+        if( lock.try_acquire( lane.my_mutex ) ) {
+            lane.my_heap.push_back( deadline_task{ deadline, source } );
+            std::push_heap( lane.my_heap.begin(), lane.my_heap.end() );
+            lane.my_earliest_deadline.store( lane.my_heap.front().deadline, std::memory_order_relaxed );
+            set_one_bit( population, lane_idx );
+            return true;
+        }
+        return false;
+    }
+
+    //! Returns pointer to task on successful pop, otherwise - nullptr.
+    d1::task* try_pop( unsigned lane_idx ) {
+        d1::task* result = nullptr;
+        lane_t& lane = lanes[lane_idx];
+        mutex::scoped_lock lock;
+        if( lock.try_acquire( lane.my_mutex ) && !lane.my_heap.empty() ) {
+            std::pop_heap( lane.my_heap.begin(), lane.my_heap.end() );
+            result = lane.my_heap.back().task;
+            lane.my_heap.pop_back();
+            if( lane.my_heap.empty() ) {
+                clear_one_bit( population, lane_idx );
+            } else {
+                lane.my_earliest_deadline.store( lane.my_heap.front().deadline, std::memory_order_relaxed );
+            }
+        }
+        return result;
+    }
+}; // deadline_task_stream
+
 } // namespace r1
 } // namespace detail
 } // namespace tbb
@@ -30,6 +30,7 @@
 #include "misc.h" // FastRandom
 #include "small_object_pool_impl.h"
 #include "intrusive_list.h"
+#include "scheduler_trace.h"
 
 #include <atomic>
 
@@ -47,14 +48,10 @@ class context_list : public intrusive_list<d1::intrusive_list_node> {
 public:
     bool orphaned{false};
 
-    //! Last state propagation epoch known to this thread
-    /** Together with the_context_state_propagation_epoch constitute synchronization protocol
-    that keeps hot path of task group context construction destruction mostly
-    lock-free.
-    When local epoch equals the global one, the state of task group contexts
-    registered with this thread is consistent with that of the task group trees
-    they belong to. **/
-    std::atomic<std::uintptr_t> epoch{};
+    //! Set while a state propagation is going to visit the list, which keeps the list alive
+    bool pending{false};
+    //! The next list to be visited by the same propagation
+    context_list* next_pending{nullptr};
 
     //! Mutex protecting access to the list of task group contexts.
     d1::mutex m_mutex{};
@@ -69,23 +66,38 @@ public:
 
         intrusive_list<d1::intrusive_list_node>::remove(val);
 
+        if (orphaned && empty() && !pending) {
+            lock.release();
+            destroy();
+        }
+    }
+
+    //! Called by the propagation that has visited the list
+    void finish_pending() {
+        mutex::scoped_lock lock(m_mutex);
+
+        pending = false;
         if (orphaned && empty()) {
             lock.release();
             destroy();
         }
     }
 
-    void push_front(d1::intrusive_list_node& val) {
+    //! Inserts the node if try_insert, called while the list is locked, returns true
+    template <typename F>
+    void push_front_if(d1::intrusive_list_node& val, F try_insert) {
         mutex::scoped_lock lock(m_mutex);
 
-        intrusive_list<d1::intrusive_list_node>::push_front(val);
+        if (try_insert()) {
+            intrusive_list<d1::intrusive_list_node>::push_front(val);
+        }
     }
 
     void orphan() {
         mutex::scoped_lock lock(m_mutex);
 
         orphaned = true;
-        if (empty()) {
+        if (empty() && !pending) {
             lock.release();
             destroy();
         }
@@ -96,7 +108,6 @@ public:
 // Thread Data
 //------------------------------------------------------------------------
 class thread_data : public ::rml::job
-                  , public d1::intrusive_list_node
                   , no_copy {
 public:
     thread_data(unsigned short index, bool is_worker)
@@ -108,38 +119,43 @@ public:
         , my_last_client{ nullptr }
         , my_arena_slot{}
         , my_random{ this }
+        , my_numa_node{ numa_node_not_queried }
+        , my_trace_buffer{ governor::scheduler_tracing() ? trace_registry::register_thread(is_worker) : nullptr }
         , my_last_observer{ nullptr }
         , my_small_object_pool{new (cache_aligned_allocate(sizeof(small_object_pool_impl))) small_object_pool_impl{}}
-        , my_context_list(new (cache_aligned_allocate(sizeof(context_list))) context_list{})
 #if __TBB_RESUMABLE_TASKS
         , my_post_resume_action{ task_dispatcher::post_resume_action::none }
         , my_post_resume_arg{nullptr}
 #endif /* __TBB_RESUMABLE_TASKS */
-    {
-        ITT_SYNC_CREATE(&my_context_list->m_mutex, SyncType_Scheduler, SyncObj_ContextsList);
-    }
+    {}
 
     ~thread_data() {
-        my_context_list->orphan();
+        if (my_trace_buffer) {
+            trace_registry::unregister_thread(my_trace_buffer);
+        }
         my_small_object_pool->destroy();
         poison_pointer(my_task_dispatcher);
         poison_pointer(my_arena);
         poison_pointer(my_arena_slot);
         poison_pointer(my_last_observer);
         poison_pointer(my_small_object_pool);
-        poison_pointer(my_context_list);
 #if __TBB_RESUMABLE_TASKS
         poison_pointer(my_post_resume_arg);
 #endif /* __TBB_RESUMABLE_TASKS */
     }
 
     void attach_arena(arena& a, std::size_t index);
+    //! Starts accounting the CPU time of the thread to the arena it is attached to
+    void start_arena_cpu_time();
+    //! Charges the CPU time the thread has spent since the previous mark to its arena
+    void account_arena_cpu_time();
+    //! Charges the CPU time to the arena and stops accounting; returns false if it was not accounted
+    bool stop_arena_cpu_time();
     bool is_attached_to(arena*);
     void attach_task_dispatcher(task_dispatcher&);
     void detach_task_dispatcher();
     void enter_task_dispatcher(task_dispatcher& task_disp, std::uintptr_t stealing_threshold);
     void leave_task_dispatcher();
-    void propagate_task_group_state(std::atomic<uint32_t> d1::task_group_context::* mptr_state, d1::task_group_context& src, uint32_t new_state);
     d1::task* get_innermost_running_task();
 
     //! Index of the arena slot the scheduler occupies now, or occupied last time
@@ -167,13 +183,52 @@ public:
     //! The random generator
     FastRandom my_random;
 
+    //! State of the locality aware victim selection
+    steal_locality_state my_steal_locality;
+
+    //! Returns the NUMA node the thread runs on, or unknown_numa_node.
+    /** The node is looked up on the first call and refreshed each time the thread joins an arena
+        with NUMA partitioned streams, so it may be outdated if the thread is not pinned. **/
+    int numa_node() {
+        if (my_numa_node == numa_node_not_queried) {
+            my_numa_node = locality_numa_node(current_thread_locality());
+        }
+        return my_numa_node;
+    }
+
+    //! The NUMA node of the thread; see numa_node()
+    int my_numa_node;
+    static constexpr int numa_node_not_queried = unknown_numa_node - 1;
+
+    //! The CPU time of the thread when it was last charged to its arena; see account_arena_cpu_time()
+    /** Zero if the time is not accounted, e.g., for an external thread outside task_arena::execute. **/
+    std::uint64_t my_arena_cpu_time_mark{0};
+
+    //! The time in nanoseconds when the worker left its last arena; zero if the migration latency is not tracked
+    std::uint64_t my_arena_leave_time{0};
+
+    //! Set if the worker moved to the current arena directly from another one, without returning to RML
+    bool my_is_handed_off{false};
+
+    //! The client the worker joined while it was retained in its arena, to be processed next
+    thread_dispatcher_client* my_handoff_client{nullptr};
+
+    //! Records the scheduler event if tracing is enabled
+    void trace(trace_event event, const void* object) {
+        if (my_trace_buffer) {
+            my_trace_buffer->record(event, object);
+        }
+    }
+
+    //! The events of the thread; owned by trace_registry, null if tracing is disabled
+    trace_buffer* my_trace_buffer;
+
     //! Last observer in the observers list processed on this slot
     observer_proxy* my_last_observer;
 
     //! Pool of small object for fast task allocation
     small_object_pool_impl* my_small_object_pool;
 
-    context_list* my_context_list;
 #if __TBB_RESUMABLE_TASKS
     //! Suspends the current coroutine (task_dispatcher).
     void suspend(void* suspend_callback, void* user_callback);
@@ -211,10 +266,41 @@ inline void thread_data::attach_arena(arena& a, std::size_t index) {
     my_arena = &a;
     my_arena_index = static_cast<unsigned short>(index);
     my_arena_slot = a.my_slots + index;
+    if (a.my_locality_aware_stealing || a.my_fifo_task_stream.is_partitioned()) {
+        // Threads are not necessarily pinned, so the location is refreshed each time the slot is taken.
+        locality_type locality = current_thread_locality();
+        my_numa_node = locality_numa_node(locality);
+        if (a.my_locality_aware_stealing) {
+            my_arena_slot->set_locality(locality);
+            my_steal_locality.on_success();
+        }
+    }
     // Read the current slot mail_outbox and attach it to the mail_inbox (remove inbox later maybe)
     my_inbox.attach(my_arena->mailbox(index));
 }
 
+inline void thread_data::start_arena_cpu_time() {
+    if (my_arena->my_cpu_time_accounting) {
+        my_arena_cpu_time_mark = ThreadCpuTime();
+    }
+}
+
+inline void thread_data::account_arena_cpu_time() {
+    if (my_arena_cpu_time_mark) {
+        __TBB_ASSERT(my_arena->my_cpu_time_accounting, nullptr);
+        std::uint64_t now = ThreadCpuTime();
+        my_arena->my_cpu_time.fetch_add(now - my_arena_cpu_time_mark, std::memory_order_relaxed);
+        my_arena_cpu_time_mark = now;
+    }
+}
+
+inline bool thread_data::stop_arena_cpu_time() {
+    account_arena_cpu_time();
+    bool accounted = my_arena_cpu_time_mark != 0;
+    my_arena_cpu_time_mark = 0;
+    return accounted;
+}
+
 inline bool thread_data::is_attached_to(arena* a) { return my_arena == a; }
 
 inline void thread_data::attach_task_dispatcher(task_dispatcher& task_disp) {
@@ -241,21 +327,6 @@ inline void thread_data::leave_task_dispatcher() {
     detach_task_dispatcher();
 }
 
-inline void thread_data::propagate_task_group_state(std::atomic<std::uint32_t> d1::task_group_context::* mptr_state, d1::task_group_context& src, std::uint32_t new_state) {
-    mutex::scoped_lock lock(my_context_list->m_mutex);
-    // Acquire fence is necessary to ensure that the subsequent node->my_next load
-    // returned the correct value in case it was just inserted in another thread.
-    // The fence also ensures visibility of the correct ctx.my_parent value.
-    for (context_list::iterator it = my_context_list->begin(); it != my_context_list->end(); ++it) {
-        d1::task_group_context& ctx = __TBB_get_object_ref(d1::task_group_context, my_node, &(*it));
-        if ((ctx.*mptr_state).load(std::memory_order_relaxed) != new_state)
-            task_group_context_impl::propagate_task_group_state(ctx, mptr_state, src, new_state);
-    }
-    // Sync up local propagation epoch with the global one. Release fence prevents
-    // reordering of possible store to *mptr_state after the sync point.
-    my_context_list->epoch.store(the_context_state_propagation_epoch.load(std::memory_order_relaxed), std::memory_order_release);
-}
-
 inline d1::task* thread_data::get_innermost_running_task() {
     return my_task_dispatcher->m_innermost_running_task;
 }
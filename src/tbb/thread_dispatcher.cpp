@@ -131,7 +131,9 @@ bool thread_dispatcher::is_client_alive(thread_dispatcher_client* client) {
     return false;
 }
 
-thread_dispatcher_client* thread_dispatcher::client_in_need(client_list_type* clients, thread_dispatcher_client* hint) {
+thread_dispatcher_client* thread_dispatcher::client_in_need(client_list_type* clients, thread_dispatcher_client* hint,
+                                                             thread_dispatcher_client* excluded)
+{
     // TODO: make sure client with higher priority returned only if there are available slots in it.
     hint = select_next_client(hint);
     if (!hint) {
@@ -149,7 +151,7 @@ thread_dispatcher_client* thread_dispatcher::client_in_need(client_list_type* cl
             } while (clients[curr_priority_level].empty());
             it = clients[curr_priority_level].begin();
         }
-        if (t.try_join()) {
+        if (&t != excluded && t.try_join()) {
             return &t;
         }
     } while (it != hint);
@@ -164,16 +166,13 @@ thread_dispatcher_client* thread_dispatcher::client_in_need(thread_dispatcher_cl
     return client_in_need(my_client_list, my_next_client);
 }
 
-bool thread_dispatcher::is_any_client_in_need() {
+bool thread_dispatcher::try_hand_off(thread_data& td) {
+    __TBB_ASSERT(td.my_handoff_client == nullptr, nullptr);
     client_list_mutex_type::scoped_lock lock(my_list_mutex, /*is_writer=*/false);
-    for (auto& priority_list : my_client_list) {
-        for (auto& client : priority_list) {
-            if (client.is_joinable()) {
-                return true;
-            }
-        }
-    }
-    return false;
+    // The worker is retained in its last client, so the client is alive. The worker takes its place
+    // in the client in need before it leaves, so no other thread can take the place meanwhile.
+    td.my_handoff_client = client_in_need(my_client_list, td.my_last_client, /* excluded = */ td.my_last_client);
+    return td.my_handoff_client != nullptr;
 }
 
 void thread_dispatcher::adjust_job_count_estimate(int delta) {
@@ -189,10 +188,20 @@ void thread_dispatcher::process(job& j) {
     thread_data& td = static_cast<thread_data&>(j);
     // td.my_last_client can be dead. Don't access it until client_in_need is called
     thread_dispatcher_client* client = td.my_last_client;
+    // The worker comes from RML, where it might sleep
+    td.my_is_handed_off = false;
     for (int i = 0; i < 2; ++i) {
         while ((client = client_in_need(client)) ) {
-            td.my_last_client = client;
-            client->process(td);
+            do {
+                td.my_last_client = client;
+                client->process(td);
+                // The next client is joined directly, without going through RML
+                td.my_is_handed_off = true;
+                // A worker handed off while it was retained has already joined the next client
+                client = td.my_handoff_client;
+                td.my_handoff_client = nullptr;
+            } while (client);
+            client = td.my_last_client;
         }
         // Workers leave thread_dispatcher because there is no client in need. It can happen earlier than
         // adjust_job_count_estimate() decreases my_slack and RML can put this thread to sleep.
@@ -222,12 +231,10 @@ void thread_dispatcher::acknowledge_close_connection() {
     // index serves as a hint decreasing conflicts between workers when they migrate between arenas
     thread_data* td = new (cache_aligned_allocate(sizeof(thread_data))) thread_data{ index, true };
     __TBB_ASSERT(index <= my_num_workers_hard_limit, nullptr);
-    my_threading_control.register_thread(*td);
     return td;
 }
 
 void thread_dispatcher::cleanup(job& j) {
-    my_threading_control.unregister_thread(static_cast<thread_data&>(j));
     governor::auto_terminate(&j);
 }
 
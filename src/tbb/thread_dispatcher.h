@@ -44,7 +44,8 @@ public:
     thread_dispatcher_client* create_client(arena& a);
     void register_client(thread_dispatcher_client* client);
     bool try_unregister_client(thread_dispatcher_client* client, std::uint64_t aba_epoch, unsigned priority);
-    bool is_any_client_in_need();
+    //! Joins the worker to a client in need other than the one it is retained in
+    bool try_hand_off(thread_data& td);
 
     void adjust_job_count_estimate(int delta);
     void release(bool blocking_terminate);
@@ -67,7 +68,8 @@ private:
     void insert_client(thread_dispatcher_client& client);
     void remove_client(thread_dispatcher_client& client);
     bool is_client_alive(thread_dispatcher_client* client);
-    thread_dispatcher_client* client_in_need(client_list_type* clients, thread_dispatcher_client* hint);
+    thread_dispatcher_client* client_in_need(client_list_type* clients, thread_dispatcher_client* hint,
+                                             thread_dispatcher_client* excluded = nullptr);
     thread_dispatcher_client* client_in_need(thread_dispatcher_client* prev);
 
     friend class threading_control_impl;
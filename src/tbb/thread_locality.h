@@ -0,0 +1,106 @@
+/*
+    Copyright (c) 2025 UXL Foundation Contributors
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#ifndef _TBB_thread_locality_H
+#define _TBB_thread_locality_H
+
+#include <cstdint>
+
+namespace tbb {
+namespace detail {
+namespace r1 {
+
+//! Packed location of a thread in the hardware topology: NUMA node, last level cache and core.
+/** Each component is stored incremented by one, so zero denotes an unknown component. **/
+using locality_type = std::uint64_t;
+
+//! Locality of a thread whose location is not known
+static constexpr locality_type unknown_locality = 0;
+
+//! Distance between two threads in the hardware topology
+/** Must be kept in sync with d1::task_arena_statistics::locality_level. **/
+enum locality_level : unsigned {
+    same_core_level,
+    same_cache_level,
+    same_numa_level,
+    system_level,
+    locality_levels_count
+};
+
+static constexpr unsigned locality_field_bits = 21;
+static constexpr locality_type locality_field_mask = (locality_type(1) << locality_field_bits) - 1;
+
+inline locality_type make_locality(int numa_id, int cache_id, int core_id) {
+    auto field = [] (int id) { return id < 0 ? 0 : (locality_type(id) + 1) & locality_field_mask; };
+    return field(numa_id) << 2 * locality_field_bits | field(cache_id) << locality_field_bits | field(core_id);
+}
+
+//! NUMA node of the thread whose NUMA node is not known
+static constexpr int unknown_numa_node = -1;
+
+inline int locality_numa_node(locality_type l) {
+    return int((l >> 2 * locality_field_bits) & locality_field_mask) - 1;
+}
+
+inline locality_level locality_distance(locality_type lhs, locality_type rhs) {
+    auto same = [lhs, rhs] (unsigned shift) {
+        locality_type field = (lhs >> shift) & locality_field_mask;
+        return field != 0 && field == ((rhs >> shift) & locality_field_mask);
+    };
+    if (same(0)) {
+        return same_core_level;
+    }
+    if (same(locality_field_bits)) {
+        return same_cache_level;
+    }
+    if (same(2 * locality_field_bits)) {
+        return same_numa_level;
+    }
+    return system_level;
+}
+
+//! Returns the location of the CPU the calling thread runs on (defined in governor.cpp)
+/** Loads the TBBbind library if it is not loaded yet. **/
+locality_type current_thread_locality();
+
+//! Per-thread state of the locality aware victim selection
+struct steal_locality_state {
+    //! The most distant level where victims are searched at the moment
+    unsigned level{same_core_level};
+    //! The number of failed steal attempts at the current level
+    unsigned failures{0};
+
+    //! The number of failed attempts after which the search moves one level outward
+    static constexpr unsigned failures_per_level = 4;
+
+    void on_success() {
+        level = same_core_level;
+        failures = 0;
+    }
+
+    void on_failure() {
+        if (level < system_level && ++failures == failures_per_level) {
+            ++level;
+            failures = 0;
+        }
+    }
+};
+
+} // namespace r1
+} // namespace detail
+} // namespace tbb
+
+#endif /* _TBB_thread_locality_H */
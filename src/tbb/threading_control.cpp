@@ -30,6 +30,11 @@ namespace r1 {
 
 std::size_t global_control_active_value_unsafe(d1::global_control::parameter);
 
+#if __linux__
+//! The period of re-reading the cgroup statistics if only the throttling feedback is requested
+static constexpr std::size_t default_cgroup_monitor_interval_ms = 100;
+#endif
+
 std::pair<unsigned, unsigned> threading_control_impl::calculate_workers_limits() {
     // Expecting that 4P is suitable for most applications.
     // Limit to 2P for large thread number.
@@ -97,17 +102,70 @@ threading_control_impl::threading_control_impl(threading_control* tc) {
     my_thread_request_serializer =
         make_cache_aligned_unique<thread_request_serializer_proxy>(*my_thread_dispatcher, workers_soft_limit);
     my_permit_manager->set_thread_request_observer(*my_thread_request_serializer);
+    my_requested_soft_limit = workers_soft_limit;
 
-    my_cancellation_disseminator = make_cache_aligned_unique<cancellation_disseminator>();
     my_waiting_threads_monitor = make_cache_aligned_unique<thread_control_monitor>();
+#if __linux__
+    std::size_t interval = governor::cgroup_monitor_interval();
+    bool throttling_feedback = governor::cgroup_throttling_feedback();
+    if (interval || throttling_feedback) {
+        // The default number of threads already respects the limit observed at startup
+        int num_cpus = INT_MAX;
+        cgroup_info<>::is_cpu_constrained(num_cpus);
+        std::chrono::milliseconds period(interval ? interval : default_cgroup_monitor_interval_ms);
+        my_cgroup_monitor = make_cache_aligned_unique<cgroup_cpu_monitor<>>(period, num_cpus, throttling_feedback);
+        my_default_soft_limit = min(governor::default_num_threads(), workers_hard_limit) - 1;
+        // The limit may grow beyond the default number of threads but not beyond the machine
+        unsigned num_hw_threads = max(std::thread::hardware_concurrency(), governor::default_num_threads());
+        my_max_soft_limit = min(num_hw_threads, workers_hard_limit) - 1;
+        my_cgroup_monitor_thread = std::thread([this] { cgroup_monitor_routine(); });
+    }
+#endif
 }
 
 void threading_control_impl::release(bool blocking_terminate) {
+#if __linux__
+    if (my_cgroup_monitor_thread.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(my_cgroup_monitor_mutex);
+            my_is_cgroup_monitor_stopped = true;
+        }
+        my_cgroup_monitor_cv.notify_one();
+        my_cgroup_monitor_thread.join();
+    }
+#endif
     my_thread_dispatcher->release(blocking_terminate);
 }
 
 void threading_control_impl::set_active_num_workers(unsigned soft_limit) {
     __TBB_ASSERT(soft_limit <= my_thread_dispatcher->my_num_workers_hard_limit, nullptr);
+    d1::mutex::scoped_lock lock(my_soft_limit_mutex);
+    my_requested_soft_limit = soft_limit;
+    apply_workers_soft_limit(soft_limit);
+}
+
+#if __linux__
+void threading_control_impl::cgroup_monitor_routine() {
+    std::unique_lock<std::mutex> lock(my_cgroup_monitor_mutex);
+    while (!my_cgroup_monitor_cv.wait_for(lock, my_cgroup_monitor->interval(), [this] { return my_is_cgroup_monitor_stopped; })) {
+        // The cgroup files are read without blocking release
+        lock.unlock();
+        int num_cpus = 0;
+        if (my_cgroup_monitor->poll(num_cpus)) {
+            d1::mutex::scoped_lock soft_limit_lock(my_soft_limit_mutex);
+            apply_workers_soft_limit(my_requested_soft_limit);
+        }
+        lock.lock();
+    }
+}
+#endif
+
+void threading_control_impl::apply_workers_soft_limit(unsigned soft_limit) {
+#if __linux__
+    if (my_cgroup_monitor) {
+        soft_limit = my_cgroup_monitor->workers_soft_limit(soft_limit, my_default_soft_limit, my_max_soft_limit);
+    }
+#endif
     my_thread_request_serializer->set_active_num_workers(soft_limit);
     my_permit_manager->set_active_num_workers(soft_limit);
 }
@@ -137,19 +195,6 @@ void threading_control_impl::publish_client(threading_control_client tc_client,
     my_thread_dispatcher->register_client(tc_client.get_thread_dispatcher_client());
 }
 
-void threading_control_impl::register_thread(thread_data& td) {
-    my_cancellation_disseminator->register_thread(td);
-}
-void threading_control_impl::unregister_thread(thread_data& td) {
-    my_cancellation_disseminator->unregister_thread(td);
-}
-
-void threading_control_impl::propagate_task_group_state(std::atomic<uint32_t> d1::task_group_context::*mptr_state,
-                                                        d1::task_group_context& src, uint32_t new_state)
-{
-    my_cancellation_disseminator->propagate_task_group_state(mptr_state, src, new_state);
-}
-
 std::size_t threading_control_impl::worker_stack_size() {
     return my_thread_dispatcher->worker_stack_size();
 }
@@ -164,8 +209,8 @@ void threading_control_impl::adjust_demand(threading_control_client tc_client, i
     my_permit_manager->adjust_demand(c, mandatory_delta, workers_delta);
 }
 
-bool threading_control_impl::is_any_other_client_active() {
-    return my_thread_request_serializer->num_workers_requested() > 0 ? my_thread_dispatcher->is_any_client_in_need() : false;
+bool threading_control_impl::try_hand_off(thread_data& td) {
+    return my_thread_request_serializer->num_workers_requested() > 0 ? my_thread_dispatcher->try_hand_off(td) : false;
 }
 
 thread_control_monitor& threading_control_impl::get_waiting_threads_monitor() {
@@ -371,20 +416,6 @@ bool threading_control::unregister_lifetime_control(bool blocking_terminate) {
     return released;
 }
 
-void threading_control::register_thread(thread_data& td) {
-    my_pimpl->register_thread(td);
-}
-
-void threading_control::unregister_thread(thread_data& td) {
-    my_pimpl->unregister_thread(td);
-}
-
-void threading_control::propagate_task_group_state(std::atomic<uint32_t> d1::task_group_context::*mptr_state,
-                                                   d1::task_group_context& src, uint32_t new_state)
-{
-    my_pimpl->propagate_task_group_state(mptr_state, src, new_state);
-}
-
 std::size_t threading_control::worker_stack_size() {
     return my_pimpl->worker_stack_size();
 }
@@ -398,8 +429,8 @@ void threading_control::adjust_demand(threading_control_client client, int manda
     my_pimpl->adjust_demand(client, mandatory_delta, workers_delta);
 }
 
-bool threading_control::is_any_other_client_active() {
-    return my_pimpl->is_any_other_client_active();
+bool threading_control::try_hand_off(thread_data& td) {
+    return my_pimpl->try_hand_off(td);
 }
 
 thread_control_monitor& threading_control::get_waiting_threads_monitor() {
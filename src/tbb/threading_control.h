@@ -26,10 +26,17 @@
 #include "permit_manager.h"
 #include "pm_client.h"
 #include "thread_dispatcher.h"
-#include "cancellation_disseminator.h"
 #include "thread_request_serializer.h"
 #include "scheduler_common.h"
 
+#if __linux__
+#include "cgroup_info.h"
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#endif
+
 namespace tbb {
 namespace detail {
 namespace r1 {
@@ -59,17 +66,12 @@ public:
     client_snapshot prepare_client_destruction(threading_control_client client);
     bool try_destroy_client(client_snapshot deleter);
 
-    void register_thread(thread_data& td);
-    void unregister_thread(thread_data& td);
-    void propagate_task_group_state(std::atomic<uint32_t> d1::task_group_context::*mptr_state,
-                                    d1::task_group_context& src, uint32_t new_state);
-
     void set_active_num_workers(unsigned soft_limit);
     std::size_t worker_stack_size();
     unsigned max_num_workers();
 
     void adjust_demand(threading_control_client, int mandatory_delta, int workers_delta);
-    bool is_any_other_client_active();
+    bool try_hand_off(thread_data& td);
 
     thread_control_monitor& get_waiting_threads_monitor();
 
@@ -80,13 +82,35 @@ private:
     static cache_aligned_unique_ptr<thread_dispatcher> make_thread_dispatcher(threading_control& control,
                                                                               unsigned workers_soft_limit,
                                                                               unsigned workers_hard_limit);
+    void apply_workers_soft_limit(unsigned soft_limit);
+#if __linux__
+    //! Polls the cgroup monitor once per its interval until release
+    void cgroup_monitor_routine();
+#endif
 
     // TODO: Consider allocation one chunk of memory and construct objects on it
     cache_aligned_unique_ptr<permit_manager> my_permit_manager{nullptr};
     cache_aligned_unique_ptr<thread_dispatcher> my_thread_dispatcher{nullptr};
     cache_aligned_unique_ptr<thread_request_serializer_proxy> my_thread_request_serializer{nullptr};
-    cache_aligned_unique_ptr<cancellation_disseminator> my_cancellation_disseminator{nullptr};
     cache_aligned_unique_ptr<thread_control_monitor> my_waiting_threads_monitor{nullptr};
+
+    //! Serializes the changes of the soft limit requested by global_control and by the cgroup monitor
+    d1::mutex my_soft_limit_mutex;
+    //! The soft limit requested by global_control or the default one
+    unsigned my_requested_soft_limit{0};
+#if __linux__
+    //! Tracks the cgroup CPU limit if TBB_CGROUP_MONITOR_INTERVAL or TBB_CGROUP_THROTTLING_FEEDBACK is set
+    cache_aligned_unique_ptr<cgroup_cpu_monitor<>> my_cgroup_monitor{nullptr};
+    //! The soft limit that follows the cgroup limit up and down unless global_control requests another one
+    unsigned my_default_soft_limit{0};
+    //! The soft limit that a raised cgroup limit cannot exceed
+    unsigned my_max_soft_limit{0};
+    //! Polls the monitor, so the limit is followed even if no thread enters an arena
+    std::thread my_cgroup_monitor_thread;
+    std::mutex my_cgroup_monitor_mutex;
+    std::condition_variable my_cgroup_monitor_cv;
+    bool my_is_cgroup_monitor_stopped{false};
+#endif
 };
 
 
@@ -108,16 +132,12 @@ public:
     client_snapshot prepare_client_destruction(threading_control_client client);
     bool try_destroy_client(client_snapshot deleter);
 
-    void register_thread(thread_data& td);
-    void unregister_thread(thread_data& td);
-    void propagate_task_group_state(std::atomic<uint32_t> d1::task_group_context::*mptr_state,
-                                    d1::task_group_context& src, uint32_t new_state);
-
     std::size_t worker_stack_size();
     static unsigned max_num_workers();
 
     void adjust_demand(threading_control_client client, int mandatory_delta, int workers_delta);
-    bool is_any_other_client_active();
+    //! Joins the worker to another client in need; on success, the worker is to leave its arena
+    bool try_hand_off(thread_data& td);
 
     thread_control_monitor& get_waiting_threads_monitor();
 
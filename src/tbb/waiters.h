@@ -22,6 +22,7 @@
 #include "scheduler_common.h"
 #include "arena.h"
 #include "threading_control.h"
+#include "scheduler_trace.h"
 
 namespace tbb {
 namespace detail {
@@ -64,9 +65,10 @@ public:
 
         if (is_worker_should_leave(slot)) {
             if (is_delayed_leave_enabled()) {
-                static constexpr std::chrono::microseconds worker_wait_leave_duration(1000);
-                static_assert(worker_wait_leave_duration > std::chrono::steady_clock::duration(1),
+                static_assert(std::chrono::microseconds(work_arrival_predictor::min_retention_us) > std::chrono::steady_clock::duration(1),
                               "Clock resolution is not enough for measured interval.");
+                // The wait is shortened or skipped if new work is not expected soon
+                const std::chrono::microseconds worker_wait_leave_duration = my_arena.my_arrival_predictor.retention_duration();
 
                 for (auto t1 = std::chrono::steady_clock::now(), t2 = t1;
                     std::chrono::duration_cast<std::chrono::microseconds>(t2 - t1) < worker_wait_leave_duration;
@@ -76,12 +78,19 @@ public:
                         return true;
                     }
 
-                    if (!my_arena.my_thread_leave.is_retention_allowed() ||
-                        my_arena.my_threading_control->is_any_other_client_active())
+                    if (!my_arena.my_thread_leave.is_retention_allowed()) {
+                        break;
+                    }
+                    // A worker that is not guaranteed to the arena leaves it for another arena in need,
+                    // which it joins before leaving
+                    if (!is_guaranteed_worker() &&
+                        my_arena.my_threading_control->try_hand_off(*governor::get_thread_data()))
                     {
                         break;
                     }
-                    d0::yield();
+                    // Block instead of spinning; the thread that advertises new work unparks the worker
+                    my_arena.park_worker(slot, worker_wait_leave_duration -
+                        std::chrono::duration_cast<std::chrono::microseconds>(t2 - t1));
                 }
             }
             // Leave dispatch loop
@@ -112,6 +121,11 @@ private:
        return my_arena.my_thread_leave.is_retention_allowed();
     }
 
+    //! The guaranteed workers are retained even if other arenas have work, so they are at hand when work arrives
+    bool is_guaranteed_worker() const {
+        return my_arena.num_workers_active() <= my_arena.my_num_guaranteed_workers;
+    }
+
     bool is_worker_should_leave(arena_slot& slot) const {
         bool is_top_priority_arena = my_arena.is_top_priority();
         bool is_task_pool_empty = slot.task_pool.load(std::memory_order_relaxed) == EmptyTaskPool;
@@ -141,9 +155,19 @@ protected:
     using waiter_base::waiter_base;
 
     template <typename Pred>
-    void sleep(std::uintptr_t uniq_tag, Pred wakeup_condition) {
-        my_arena.get_waiting_threads_monitor().wait<thread_control_monitor::thread_context>(wakeup_condition,
-            market_context{uniq_tag, &my_arena});
+    void sleep(arena_slot& slot, std::uintptr_t uniq_tag, Pred wakeup_condition) {
+        const bool tracing = governor::scheduler_tracing();
+        const std::uint64_t sleep_start = tracing ? trace_buffer::now() : 0;
+        if (my_arena.get_waiting_threads_monitor().wait<thread_control_monitor::thread_context>(wakeup_condition,
+            market_context{uniq_tag, &my_arena}))
+        {
+            // The thread was blocked, not just checked the condition
+            slot.count(thread_sleep_event);
+            if (tracing) {
+                trace_current_thread(trace_event::thread_sleep_begin, &my_arena, sleep_start);
+                trace_current_thread(trace_event::thread_sleep_end, &my_arena);
+            }
+        }
         reset_wait();
     }
 };
@@ -162,14 +186,14 @@ public:
         return true;
     }
 
-    void pause(arena_slot&) {
+    void pause(arena_slot& slot) {
         if (!sleep_waiter::pause()) {
             return;
         }
 
         auto wakeup_condition = [&] { return !my_arena.is_empty() || !my_wait_ctx.continue_execution(); };
 
-        sleep(std::uintptr_t(&my_wait_ctx), wakeup_condition);
+        sleep(slot, std::uintptr_t(&my_wait_ctx), wakeup_condition);
     }
 
     d1::wait_context* wait_ctx() {
@@ -205,7 +229,7 @@ public:
 
         auto wakeup_condition = [&] { return !my_arena.is_empty() || sp->m_is_owner_recalled.load(std::memory_order_relaxed); };
 
-        sleep(std::uintptr_t(sp), wakeup_condition);
+        sleep(slot, std::uintptr_t(sp), wakeup_condition);
     }
 
     d1::wait_context* wait_ctx() {
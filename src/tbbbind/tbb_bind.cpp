@@ -297,6 +297,9 @@ public:
     typedef hwloc_cpuset_t             affinity_mask;
     typedef hwloc_const_cpuset_t const_affinity_mask;
 
+    // Values of tbb::task_arena::placement_policy
+    enum placement_policy { placement_none, placement_compact, placement_scatter, placement_per_core };
+
     bool is_topology_parsed() { return initialization_state == topology_parsed; }
 
     static void construct( std::size_t groups_num ) {
@@ -449,6 +452,150 @@ public:
         }
     }
 
+    //! Returns the processing units inside the set that are allowed by the constraints, in the logical order
+    std::vector<hwloc_obj_t> allowed_units_inside(hwloc_const_cpuset_t set, const_affinity_mask constraints_mask) {
+        std::vector<hwloc_obj_t> units;
+        hwloc_obj_t pu = nullptr;
+        while ((pu = hwloc_get_next_obj_inside_cpuset_by_type(topology, set, HWLOC_OBJ_PU, pu)) != nullptr) {
+            if (hwloc_bitmap_intersects(pu->cpuset, constraints_mask)) {
+                units.push_back(pu);
+            }
+        }
+        return units;
+    }
+
+    //! Returns the allowed processing units inside the set so that each core gives one unit before any core gives the next one
+    std::vector<hwloc_obj_t> spread_units_inside(hwloc_const_cpuset_t set, const_affinity_mask constraints_mask) {
+        std::vector<std::vector<hwloc_obj_t>> core_units;
+        hwloc_obj_t core = nullptr;
+        while ((core = hwloc_get_next_obj_inside_cpuset_by_type(topology, set, HWLOC_OBJ_CORE, core)) != nullptr) {
+            std::vector<hwloc_obj_t> units = allowed_units_inside(core->cpuset, constraints_mask);
+            if (!units.empty()) {
+                core_units.push_back(units);
+            }
+        }
+        if (core_units.empty()) {
+            // The topology does not describe cores
+            return allowed_units_inside(set, constraints_mask);
+        }
+        std::vector<hwloc_obj_t> units;
+        for (std::size_t thread = 0, added = 1; added > 0; ++thread) {
+            added = 0;
+            for (auto& units_of_core : core_units) {
+                if (thread < units_of_core.size()) {
+                    units.push_back(units_of_core[thread]);
+                    ++added;
+                }
+            }
+        }
+        return units;
+    }
+
+    /**
+     * Fills the affinity mask of each slot according to the placement policy. The units of placement
+     * (processing units or cores) are ordered by the policy, and the slot with index i is pinned to the
+     * unit with index i modulo the number of units. So the same slot always gets the same unit.
+     */
+    void fill_placement_affinity_masks(std::vector<affinity_mask>& slot_masks, const_affinity_mask constraints_mask,
+                                       int placement)
+    {
+        __TBB_ASSERT(is_topology_parsed(), "Trying to get access to uninitialized system_topology");
+        hwloc_const_cpuset_t complete_set = hwloc_topology_get_complete_cpuset(topology);
+        std::vector<hwloc_obj_t> units;
+        switch (placement) {
+        case placement_compact:
+            units = allowed_units_inside(complete_set, constraints_mask);
+            break;
+        case placement_scatter: {
+            std::vector<std::vector<hwloc_obj_t>> package_units;
+            hwloc_obj_t package = nullptr;
+            while ((package = hwloc_get_next_obj_by_type(topology, HWLOC_OBJ_PACKAGE, package)) != nullptr) {
+                std::vector<hwloc_obj_t> units_of_package = spread_units_inside(package->cpuset, constraints_mask);
+                if (!units_of_package.empty()) {
+                    package_units.push_back(units_of_package);
+                }
+            }
+            if (package_units.empty()) {
+                package_units.push_back(spread_units_inside(complete_set, constraints_mask));
+            }
+            // Consecutive slots go to different packages
+            for (std::size_t index = 0, added = 1; added > 0; ++index) {
+                added = 0;
+                for (auto& units_of_package : package_units) {
+                    if (index < units_of_package.size()) {
+                        units.push_back(units_of_package[index]);
+                        ++added;
+                    }
+                }
+            }
+            break;
+        }
+        case placement_per_core: {
+            hwloc_obj_t core = nullptr;
+            while ((core = hwloc_get_next_obj_by_type(topology, HWLOC_OBJ_CORE, core)) != nullptr) {
+                if (hwloc_bitmap_intersects(core->cpuset, constraints_mask)) {
+                    units.push_back(core);
+                }
+            }
+            if (units.empty()) {
+                units = allowed_units_inside(complete_set, constraints_mask);
+            }
+            break;
+        }
+        default:
+            __TBB_ASSERT(false, "Unknown placement policy");
+        }
+
+        if (units.empty()) {
+            return;
+        }
+        for (std::size_t slot = 0; slot < slot_masks.size(); ++slot) {
+            hwloc_bitmap_and(slot_masks[slot], units[slot % units.size()]->cpuset, constraints_mask);
+        }
+    }
+
+    void get_thread_locality(int& numa_id, int& cache_id, int& core_id) {
+        numa_id = cache_id = core_id = -1;
+        if (!is_topology_parsed()) {
+            return;
+        }
+
+        hwloc_cpuset_t location = hwloc_bitmap_alloc();
+        int pu_index = -1;
+        if (hwloc_get_last_cpu_location(topology, location, HWLOC_CPUBIND_THREAD) == 0) {
+            pu_index = hwloc_bitmap_first(location);
+        }
+        hwloc_bitmap_free(location);
+
+        hwloc_obj_t pu = pu_index >= 0 ? hwloc_get_pu_obj_by_os_index(topology, unsigned(pu_index)) : nullptr;
+        if (pu == nullptr) {
+            return;
+        }
+
+        if (hwloc_obj_t core = hwloc_get_ancestor_obj_by_type(topology, HWLOC_OBJ_CORE, pu)) {
+            core_id = static_cast<int>(core->logical_index);
+        }
+#if HWLOC_API_VERSION >= 0x20000
+        if (hwloc_obj_t cache = hwloc_get_ancestor_obj_by_type(topology, HWLOC_OBJ_L3CACHE, pu)) {
+            cache_id = static_cast<int>(cache->logical_index);
+        }
+#else
+        for (hwloc_obj_t obj = pu->parent; obj != nullptr; obj = obj->parent) {
+            if (obj->type == HWLOC_OBJ_CACHE && obj->attr->cache.depth == 3) {
+                cache_id = static_cast<int>(obj->logical_index);
+                break;
+            }
+        }
+#endif
+        // NUMA nodes are not ancestors of processing units in HWLOC 2.x, so use the parsed masks
+        for (std::size_t i = 0; i < numa_affinity_masks_list.size(); ++i) {
+            if (numa_affinity_masks_list[i] && hwloc_bitmap_isset(numa_affinity_masks_list[i], unsigned(pu_index))) {
+                numa_id = static_cast<int>(i);
+                break;
+            }
+        }
+    }
+
     int get_default_concurrency(int numa_node_index, int core_type_index, int max_threads_per_core) {
         __TBB_ASSERT(is_topology_parsed(), "Trying to get access to uninitialized system_topology");
 
@@ -493,6 +640,9 @@ class binding_handler {
     affinity_masks_container affinity_backup;
     system_topology::affinity_mask handler_affinity_mask;
 
+    // Masks of the slots that are pinned according to a placement policy; empty if there is no policy
+    affinity_masks_container placement_masks;
+
 #ifdef _WIN32
     affinity_masks_container affinity_buffer;
     int my_numa_node_id;
@@ -528,9 +678,24 @@ public:
             system_topology::instance().free_affinity_mask(affinity_buffer[i]);
 #endif
         }
+        for (auto& placement_mask : placement_masks) {
+            system_topology::instance().free_affinity_mask(placement_mask);
+        }
         system_topology::instance().free_affinity_mask(handler_affinity_mask);
     }
 
+    void set_placement_policy( int placement ) {
+        auto& topology = system_topology::instance();
+        if (placement == system_topology::placement_none || !topology.is_topology_parsed()) {
+            return;
+        }
+        placement_masks.resize(affinity_backup.size());
+        for (auto& placement_mask : placement_masks) {
+            placement_mask = topology.allocate_process_affinity_mask();
+        }
+        topology.fill_placement_affinity_masks(placement_masks, handler_affinity_mask, placement);
+    }
+
     void apply_affinity( unsigned slot_num ) {
         auto& topology = system_topology::instance();
         __TBB_ASSERT(slot_num < affinity_backup.size(),
@@ -540,6 +705,11 @@ public:
 
         topology.store_current_affinity_mask(affinity_backup[slot_num]);
         system_topology::affinity_mask thread_affinity = handler_affinity_mask;
+        if (!placement_masks.empty()) {
+            // The mask of the slot does not cross processor groups
+            topology.set_affinity_mask(placement_masks[slot_num]);
+            return;
+        }
 #ifdef _WIN32
         // If we have a constraint based only on the max_threads_per_core setting, then the
         // constraints affinity mask may cross the border between several processor groups
@@ -599,6 +769,11 @@ TBBBIND_EXPORT void __TBB_internal_deallocate_binding_handler(binding_handler* h
     delete handler_ptr;
 }
 
+TBBBIND_EXPORT void __TBB_internal_set_placement_policy(binding_handler* handler_ptr, int placement) {
+    __TBB_ASSERT(handler_ptr != nullptr, "Trying to get access to uninitialized metadata.");
+    handler_ptr->set_placement_policy(placement);
+}
+
 TBBBIND_EXPORT void __TBB_internal_apply_affinity(binding_handler* handler_ptr, int slot_num) {
     __TBB_ASSERT(handler_ptr != nullptr, "Trying to get access to uninitialized metadata.");
     handler_ptr->apply_affinity(slot_num);
@@ -626,6 +801,10 @@ TBBBIND_EXPORT void __TBB_internal_set_tbbbind_assertion_handler(assertion_handl
     assertion_handler::set(handler);
 }
 
+TBBBIND_EXPORT void __TBB_internal_get_thread_locality(int& numa_id, int& cache_id, int& core_id) {
+    system_topology::instance().get_thread_locality(numa_id, cache_id, core_id);
+}
+
 } // extern "C"
 
 } // namespace r1
@@ -368,6 +368,12 @@ public:
         return result;
     }
 
+    //! Frees the mask before the end of the test; the mask must not be used concurrently
+    static void free_affinity_mask(affinity_mask mask) {
+        instance().memory_handler.unsafe_erase(mask);
+        hwloc_bitmap_free(mask);
+    }
+
     static std::vector<index_info> get_cpu_kinds_info() {
         return instance().cpu_kind_infos;
     }
@@ -20,6 +20,7 @@
 
 // TODO: find criteria to automatically define this in utils_assert.h
 #define TEST_CUSTOM_ASSERTION_HANDLER_ENABLED 1
+#define TBB_PREVIEW_TASK_ARENA_PLACEMENT 1
 
 #include "common/common_arena_constraints.h"
 
@@ -174,6 +175,84 @@ TEST_CASE("Test constrained nested arena of smaller size") {
         barrier.wait();
     }, tbb::simple_partitioner{});
 }
+
+#if TBB_HAS_TASK_ARENA_PLACEMENT
+//! Returns the affinity mask of each slot of the arena, occupying all the slots at once
+std::vector<system_info::affinity_mask> get_slot_affinities(tbb::task_arena& ta) {
+    const int num_slots = ta.max_concurrency();
+    std::vector<system_info::affinity_mask> slot_affinities(num_slots, nullptr);
+    tbb::spin_mutex affinity_mutex{};
+    auto record_affinity = [&] {
+        tbb::spin_mutex::scoped_lock lock(affinity_mutex);
+        slot_affinities[tbb::this_task_arena::current_thread_index()] = system_info::allocate_current_affinity_mask();
+    };
+
+    ta.execute(record_affinity);
+    utils::SpinBarrier exit_barrier(num_slots);
+    for (int i = 0; i < num_slots - 1; ++i) {
+        ta.enqueue([&] {
+            record_affinity();
+            exit_barrier.wait();
+        });
+    }
+    exit_barrier.wait();
+    return slot_affinities;
+}
+
+void free_slot_affinities(std::vector<system_info::affinity_mask>& slot_affinities) {
+    for (system_info::affinity_mask mask : slot_affinities) {
+        if (mask != nullptr) {
+            system_info::free_affinity_mask(mask);
+        }
+    }
+    slot_affinities.clear();
+}
+
+int count_intersecting_cores(system_info::affinity_mask mask) {
+    int count = 0;
+    for (const auto& core : system_info::get_cores_info()) {
+        count += hwloc_bitmap_intersects(mask, core.cpuset) ? 1 : 0;
+    }
+    return count;
+}
+
+//! Testing that the placement policies pin each slot to the same distinct processing unit or core
+//! \brief \ref interface \ref requirement
+TEST_CASE("Test placement policies") {
+    system_info::initialize();
+    using placement_policy = tbb::task_arena::placement_policy;
+    for (placement_policy policy : { placement_policy::compact, placement_policy::scatter, placement_policy::per_core }) {
+        tbb::task_arena::constraints constraints = tbb::task_arena::constraints{}.set_placement(policy);
+        const int concurrency = tbb::info::default_concurrency(constraints);
+        if (policy == placement_policy::per_core) {
+            CHECK_MESSAGE(concurrency == int(system_info::get_cores_info().size()),
+                "The default concurrency of the per-core placement is the number of cores.");
+        }
+        tbb::global_control parallelism(tbb::global_control::max_allowed_parallelism, concurrency);
+        tbb::task_arena ta{constraints};
+        CHECK(ta.placement() == policy);
+        CHECK(ta.max_concurrency() == concurrency);
+
+        std::vector<system_info::affinity_mask> first = get_slot_affinities(ta);
+        std::vector<system_info::affinity_mask> second = get_slot_affinities(ta);
+        for (int slot = 0; slot < concurrency; ++slot) {
+            REQUIRE(first[slot] != nullptr);
+            REQUIRE(second[slot] != nullptr);
+            if (policy == placement_policy::per_core) {
+                CHECK_MESSAGE(count_intersecting_cores(first[slot]) == 1, "The slot must be pinned to a single core.");
+            } else {
+                CHECK_MESSAGE(hwloc_bitmap_weight(first[slot]) == 1, "The slot must be pinned to a single processing unit.");
+            }
+            CHECK_MESSAGE(hwloc_bitmap_isequal(first[slot], second[slot]), "The slot must be pinned to the same units each time.");
+            for (int other = 0; other < slot; ++other) {
+                CHECK_MESSAGE(!hwloc_bitmap_intersects(first[slot], first[other]), "Different slots must be pinned to different units.");
+            }
+        }
+        free_slot_affinities(first);
+        free_slot_affinities(second);
+    }
+}
+#endif
 #endif /*__TBB_HWLOC_VALID_ENVIRONMENT && __HWLOC_CPUBIND_PRESENT */
 
 // The test cannot be stabilized with TBB malloc under Thread Sanitizer
@@ -262,6 +341,17 @@ TEST_CASE("Test arena constraints setters") {
 
         constraints_comparison(setter_c, assignment_c);
     }
+
+#if TBB_HAS_TASK_ARENA_PLACEMENT
+    // Placement policy setter testing
+    {
+        constraints setter_c = constraints{}.set_placement(tbb::task_arena::placement_policy::scatter);
+        REQUIRE(setter_c.placement == tbb::task_arena::placement_policy::scatter);
+        REQUIRE(constraints{}.placement == tbb::task_arena::placement_policy::none);
+        REQUIRE(tbb::task_arena{setter_c}.placement() == tbb::task_arena::placement_policy::scatter);
+        REQUIRE(tbb::task_arena{}.placement() == tbb::task_arena::placement_policy::none);
+    }
+#endif
 }
 
 const int custom_concurrency_value = 42;
@@ -27,6 +27,8 @@
 
 #include <sys/stat.h>
 
+#include <chrono>
+#include <climits>
 #include <fstream>
 #include <cstdio>
 
@@ -89,6 +91,15 @@ void prepare_cgroup_v1_cpu_period_file(const char* dir_path, const char* cpu_per
 
 }
 
+void prepare_cpu_stat_file(const char* dir_path, long long nr_periods, long long nr_throttled) {
+    std::string cpu_stat_file_path = std::string(dir_path) + "/cpu.stat";
+    std::ofstream cpu_stat_file(cpu_stat_file_path);
+    cpu_stat_file << "usage_usec 1000000" << std::endl
+                  << "nr_periods " << nr_periods << std::endl
+                  << "nr_throttled " << nr_throttled << std::endl
+                  << "throttled_usec " << nr_throttled * 10000 << std::endl;
+}
+
 void prepare_cgroup_v1_files(const char* dir_path, const char* cpu_quota, const char* cpu_period) {
     prepare_cgroup_v1_cpu_quota_file(dir_path, cpu_quota);
     prepare_cgroup_v1_cpu_period_file(dir_path, cpu_period);
@@ -268,6 +279,143 @@ TEST_CASE("cgroup v1 path finds correct CPU limitation") {
     check_cpu_constraints<test_data>(/*expected_result*/true, /*expected_num_cpus*/2);
 }
 
+template <typename TestData>
+using cgroup_cpu_monitor = tbb::detail::r1::cgroup_cpu_monitor<TestData>;
+
+//! \brief \ref requirement
+TEST_CASE("CPU limit changes are observed by cgroup monitor") {
+    struct test_data : cgroup_test_data {} data;
+
+    prepare_proc_self_cgroup_file(data.proc_self_cgroup_path, /*lines*/{"0::./."});
+    mkdir(data.sys_fs_cgroup_dir_path, 0777);
+    prepare_cpu_max_file(data.sys_fs_cgroup_dir_path, /*cpu_quota*/"400000", /*cpu_period*/"100000");
+
+    cgroup_cpu_monitor<test_data> monitor(/*interval*/std::chrono::milliseconds(1), /*initial_num_cpus*/4);
+    int num_cpus = -1;
+    CHECK_MESSAGE(!monitor.poll(num_cpus), "The limit has not changed");
+    CHECK(num_cpus == -1);
+
+    // The quota is decreased, e.g., by a vertical autoscaler
+    prepare_cpu_max_file(data.sys_fs_cgroup_dir_path, /*cpu_quota*/"150000", /*cpu_period*/"100000");
+    CHECK(monitor.poll(num_cpus));
+    CHECK(num_cpus == 2);
+    CHECK(monitor.num_cpus() == 2);
+    CHECK_MESSAGE(!monitor.poll(num_cpus), "The change is reported once");
+
+    // The limit is lifted
+    prepare_cpu_max_file(data.sys_fs_cgroup_dir_path, /*cpu_quota*/"max", /*cpu_period*/"100000");
+    CHECK(monitor.poll(num_cpus));
+    CHECK(num_cpus == INT_MAX);
+
+    // The limit that cannot be read does not change the observed one
+    prepare_cpu_max_file(data.sys_fs_cgroup_dir_path, /*cpu_quota*/"abracadabra", /*cpu_period*/"100000");
+    CHECK(!monitor.poll(num_cpus));
+    CHECK(monitor.num_cpus() == INT_MAX);
+}
+
+//! \brief \ref requirement
+TEST_CASE("Soft limit of workers follows CPU limit observed by cgroup monitor") {
+    struct test_data : cgroup_test_data {} data;
+
+    prepare_proc_self_cgroup_file(data.proc_self_cgroup_path,
+        /*lines*/ {/*cgroup v1 indicator*/"3:cputset,cpu:./."});
+    mkdir(data.sys_fs_cgroup_dir_path, 0777);
+    prepare_cgroup_v1_files(data.sys_fs_cgroup_dir_path, /*cpu_quota*/"400000", /*cpu_period*/"100000");
+
+    // The default soft limit was chosen for 4 CPUs at startup; the machine has 16 CPUs
+    const unsigned default_soft_limit = 3, max_soft_limit = 15, requested_soft_limit = 1;
+    cgroup_cpu_monitor<test_data> monitor(/*interval*/std::chrono::milliseconds(1), /*initial_num_cpus*/4);
+    CHECK(monitor.workers_soft_limit(default_soft_limit, default_soft_limit, max_soft_limit) == 3);
+
+    int num_cpus = -1;
+    prepare_cgroup_v1_files(data.sys_fs_cgroup_dir_path, /*cpu_quota*/"200000", /*cpu_period*/"100000");
+    CHECK(monitor.poll(num_cpus));
+    CHECK(monitor.workers_soft_limit(default_soft_limit, default_soft_limit, max_soft_limit) == 1);
+    CHECK(monitor.workers_soft_limit(requested_soft_limit, default_soft_limit, max_soft_limit) == 1);
+
+    // The default soft limit grows beyond the startup one together with the CPU limit
+    prepare_cgroup_v1_files(data.sys_fs_cgroup_dir_path, /*cpu_quota*/"800000", /*cpu_period*/"100000");
+    CHECK(monitor.poll(num_cpus));
+    CHECK(monitor.workers_soft_limit(default_soft_limit, default_soft_limit, max_soft_limit) == 7);
+    CHECK_MESSAGE(monitor.workers_soft_limit(requested_soft_limit, default_soft_limit, max_soft_limit) == 1,
+                  "The soft limit requested by the application is not raised");
+
+    prepare_cgroup_v1_files(data.sys_fs_cgroup_dir_path, /*cpu_quota*/"3200000", /*cpu_period*/"100000");
+    CHECK(monitor.poll(num_cpus));
+    CHECK(monitor.workers_soft_limit(default_soft_limit, default_soft_limit, max_soft_limit) == max_soft_limit);
+
+    // Without the limit, the default number of threads is used again
+    prepare_cgroup_v1_files(data.sys_fs_cgroup_dir_path, /*cpu_quota*/"-1", /*cpu_period*/"100000");
+    CHECK(monitor.poll(num_cpus));
+    CHECK(num_cpus == INT_MAX);
+    CHECK(monitor.workers_soft_limit(default_soft_limit, default_soft_limit, max_soft_limit) == default_soft_limit);
+    CHECK(monitor.workers_soft_limit(requested_soft_limit, default_soft_limit, max_soft_limit) == requested_soft_limit);
+}
+
+//! \brief \ref requirement
+TEST_CASE("Throttling feedback lowers and restores the number of CPUs") {
+    struct test_data : cgroup_test_data {} data;
+
+    prepare_proc_self_cgroup_file(data.proc_self_cgroup_path, /*lines*/{"0::./."});
+    mkdir(data.sys_fs_cgroup_dir_path, 0777);
+    prepare_cpu_max_file(data.sys_fs_cgroup_dir_path, /*cpu_quota*/"400000", /*cpu_period*/"100000");
+    prepare_cpu_stat_file(data.sys_fs_cgroup_dir_path, /*nr_periods*/100, /*nr_throttled*/0);
+
+    cgroup_cpu_monitor<test_data> monitor(/*interval*/std::chrono::milliseconds(1), /*initial_num_cpus*/4,
+                                          /*throttling_feedback*/true);
+    int num_cpus = -1;
+    CHECK_MESSAGE(!monitor.poll(num_cpus), "No throttling is observed yet");
+
+    // Each interval with throttled periods takes one CPU away
+    prepare_cpu_stat_file(data.sys_fs_cgroup_dir_path, /*nr_periods*/110, /*nr_throttled*/3);
+    CHECK(monitor.poll(num_cpus));
+    CHECK(num_cpus == 3);
+    prepare_cpu_stat_file(data.sys_fs_cgroup_dir_path, /*nr_periods*/120, /*nr_throttled*/5);
+    CHECK(monitor.poll(num_cpus));
+    CHECK(num_cpus == 2);
+    CHECK(monitor.workers_soft_limit(/*requested*/3, /*default*/3, /*max*/15) == 1);
+
+    // An interval in which the cgroup was idle keeps the number of CPUs
+    CHECK(!monitor.poll(num_cpus));
+    CHECK(monitor.num_cpus() == 2);
+
+    // Each interval without throttling gives one CPU back up to the limit
+    prepare_cpu_stat_file(data.sys_fs_cgroup_dir_path, /*nr_periods*/130, /*nr_throttled*/5);
+    CHECK(monitor.poll(num_cpus));
+    CHECK(num_cpus == 3);
+    prepare_cpu_stat_file(data.sys_fs_cgroup_dir_path, /*nr_periods*/140, /*nr_throttled*/5);
+    CHECK(monitor.poll(num_cpus));
+    CHECK(num_cpus == 4);
+    prepare_cpu_stat_file(data.sys_fs_cgroup_dir_path, /*nr_periods*/150, /*nr_throttled*/5);
+    CHECK(!monitor.poll(num_cpus));
+    CHECK(monitor.num_cpus() == 4);
+
+    // The number of CPUs does not go below one
+    prepare_cpu_max_file(data.sys_fs_cgroup_dir_path, /*cpu_quota*/"100000", /*cpu_period*/"100000");
+    CHECK(monitor.poll(num_cpus));
+    CHECK(num_cpus == 1);
+    prepare_cpu_stat_file(data.sys_fs_cgroup_dir_path, /*nr_periods*/160, /*nr_throttled*/9);
+    CHECK(!monitor.poll(num_cpus));
+    CHECK(monitor.num_cpus() == 1);
+}
+
+//! \brief \ref negative
+TEST_CASE("Throttling feedback without cpu.stat file follows the limit only") {
+    struct test_data : cgroup_test_data {} data;
+
+    prepare_proc_self_cgroup_file(data.proc_self_cgroup_path, /*lines*/{"0::./."});
+    mkdir(data.sys_fs_cgroup_dir_path, 0777);
+    prepare_cpu_max_file(data.sys_fs_cgroup_dir_path, /*cpu_quota*/"200000", /*cpu_period*/"100000");
+    std::remove((std::string(data.sys_fs_cgroup_dir_path) + "/cpu.stat").c_str());
+
+    cgroup_cpu_monitor<test_data> monitor(/*interval*/std::chrono::milliseconds(1), /*initial_num_cpus*/4,
+                                          /*throttling_feedback*/true);
+    int num_cpus = -1;
+    CHECK(monitor.poll(num_cpus));
+    CHECK(num_cpus == 2);
+    CHECK(!monitor.poll(num_cpus));
+}
+
 #else
 
 int main() {
@@ -0,0 +1,257 @@
+/*
+    Copyright (c) 2025 UXL Foundation Contributors
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#define TBB_PREVIEW_COROUTINES 1
+
+#include "common/test.h"
+#include "common/utils.h"
+#include "common/spin_barrier.h"
+
+#include "tbb/task_group.h"
+#include "tbb/task_arena.h"
+#include "tbb/concurrent_queue.h"
+#include "tbb/flow_graph.h"
+
+#include <atomic>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+//! \file test_coroutines.cpp
+//! \brief Test for [preview] C++20 coroutines support
+
+#if TBB_HAS_COROUTINES
+
+//! The coroutine that starts eagerly and destroys itself on completion
+struct detached_coroutine {
+    struct promise_type {
+        detached_coroutine get_return_object() { return {}; }
+        std::suspend_never initial_suspend() noexcept { return {}; }
+        std::suspend_never final_suspend() noexcept { return {}; }
+        void return_void() {}
+        void unhandled_exception() { std::terminate(); }
+    };
+};
+
+detached_coroutine wait_for_group(tbb::task_group& tg, tbb::task_group_status& status, std::atomic<bool>& done) {
+    status = co_await tg.async_wait();
+    done = true;
+}
+
+//! \brief \ref interface \ref requirement
+TEST_CASE("task_group::async_wait") {
+    constexpr int num_tasks = 100;
+    tbb::task_arena arena(2, 0);
+    for (int repeat = 0; repeat < 10; ++repeat) {
+        tbb::task_group tg;
+        std::atomic<int> counter{0};
+        std::atomic<bool> release{false};
+        for (int i = 0; i < num_tasks; ++i) {
+            arena.enqueue([&] {
+                utils::SpinWaitUntilEq(release, true);
+                ++counter;
+            }, tg);
+        }
+
+        tbb::task_group_status status = tbb::not_complete;
+        std::atomic<bool> done{false};
+        wait_for_group(tg, status, done);
+        CHECK_MESSAGE(!done, "The coroutine must be suspended while the tasks are running");
+
+        release = true;
+        utils::SpinWaitUntilEq(done, true);
+        CHECK(counter == num_tasks);
+        CHECK(status == tbb::complete);
+    }
+
+    // The coroutine is not suspended if there is nothing to wait for
+    tbb::task_group tg;
+    tbb::task_group_status status = tbb::not_complete;
+    std::atomic<bool> done{false};
+    wait_for_group(tg, status, done);
+    CHECK(done);
+    CHECK(status == tbb::complete);
+}
+
+//! \brief \ref interface \ref requirement
+TEST_CASE("task_group::async_wait reports cancellation") {
+    tbb::task_arena arena(2, 0);
+    tbb::task_group tg;
+    std::atomic<bool> release{false};
+    arena.enqueue([&] { utils::SpinWaitUntilEq(release, true); }, tg);
+
+    tbb::task_group_status status = tbb::not_complete;
+    std::atomic<bool> done{false};
+    wait_for_group(tg, status, done);
+    tg.cancel();
+    release = true;
+    utils::SpinWaitUntilEq(done, true);
+    CHECK(status == tbb::canceled);
+}
+
+detached_coroutine execute_in_arena(tbb::task_arena& arena, int& result, std::atomic<bool>& done) {
+    result = co_await arena.async_execute([] { return tbb::this_task_arena::max_concurrency(); });
+    co_await arena.async_execute([] {});
+    done = true;
+}
+
+//! \brief \ref interface \ref requirement
+TEST_CASE("task_arena::async_execute") {
+    tbb::task_arena arena(2, 0);
+    for (int repeat = 0; repeat < 10; ++repeat) {
+        int result = 0;
+        std::atomic<bool> done{false};
+        execute_in_arena(arena, result, done);
+        utils::SpinWaitUntilEq(done, true);
+        CHECK(result == 2);
+    }
+}
+
+#if TBB_USE_EXCEPTIONS
+detached_coroutine throw_in_arena(tbb::task_arena& arena, tbb::task_group& tg, std::atomic<int>& caught) {
+    try {
+        co_await arena.async_execute([] { throw std::runtime_error("test"); });
+    } catch (const std::runtime_error&) {
+        ++caught;
+    }
+    arena.enqueue([] { throw std::logic_error("test"); }, tg);
+    try {
+        co_await tg.async_wait();
+    } catch (const std::logic_error&) {
+        ++caught;
+    }
+}
+
+//! \brief \ref interface \ref requirement
+TEST_CASE("Exceptions are rethrown into the awaiting coroutine") {
+    tbb::task_arena arena(2, 0);
+    tbb::task_group tg;
+    std::atomic<int> caught{0};
+    throw_in_arena(arena, tg, caught);
+    utils::SpinWaitUntilEq(caught, 2);
+}
+#endif
+
+detached_coroutine pop_from_queue(tbb::concurrent_bounded_queue<int>& queue, std::atomic<int>& sum, std::atomic<int>& count) {
+    int value = 0;
+    co_await queue.async_pop(value);
+    sum += value;
+    ++count;
+}
+
+//! \brief \ref interface \ref requirement
+TEST_CASE("concurrent_bounded_queue::async_pop") {
+    constexpr int num_coroutines = 200;
+    tbb::concurrent_bounded_queue<int> queue;
+    std::atomic<int> sum{0};
+    std::atomic<int> count{0};
+
+    // Some of the values are in the queue before the coroutines wait for them
+    for (int i = 0; i < num_coroutines / 4; ++i) {
+        queue.push(i);
+    }
+    for (int i = 0; i < num_coroutines; ++i) {
+        pop_from_queue(queue, sum, count);
+    }
+    CHECK(count >= num_coroutines / 4);
+
+    std::vector<std::thread> producers;
+    for (int p = 0; p < 3; ++p) {
+        producers.emplace_back([&queue, p] {
+            for (int i = num_coroutines / 4 + p; i < num_coroutines; i += 3) {
+                queue.push(i);
+            }
+        });
+    }
+    for (auto& producer : producers) {
+        producer.join();
+    }
+    utils::SpinWaitUntilEq(count, num_coroutines);
+    CHECK(sum == num_coroutines * (num_coroutines - 1) / 2);
+    CHECK(queue.empty());
+}
+
+#if TBB_USE_EXCEPTIONS
+detached_coroutine pop_aborted(tbb::concurrent_bounded_queue<int>& queue, std::atomic<int>& aborted) {
+    int value = 0;
+    try {
+        co_await queue.async_pop(value);
+    } catch (const tbb::user_abort&) {
+        ++aborted;
+    }
+}
+
+//! \brief \ref interface \ref requirement
+TEST_CASE("concurrent_bounded_queue::async_pop is aborted") {
+    constexpr int num_coroutines = 10;
+    tbb::concurrent_bounded_queue<int> queue;
+    std::atomic<int> aborted{0};
+    for (int i = 0; i < num_coroutines; ++i) {
+        pop_aborted(queue, aborted);
+    }
+    CHECK(aborted == 0);
+    queue.abort();
+    utils::SpinWaitUntilEq(aborted, num_coroutines);
+
+    // The queue stays usable after the abort
+    queue.push(42);
+    int value = 0;
+    queue.pop(value);
+    CHECK(value == 42);
+}
+#endif
+
+using async_node_type = tbb::flow::async_node<int, int>;
+
+detached_coroutine async_activity(int value, async_node_type::gateway_type& gateway, tbb::concurrent_bounded_queue<int>& input) {
+    int offset = 0;
+    co_await input.async_pop(offset);
+    co_await gateway.resume_in_graph();
+    gateway.try_put(value + offset);
+    gateway.release_wait();
+}
+
+//! \brief \ref interface \ref requirement
+TEST_CASE("async_node gateway resumes the coroutine in the graph") {
+    constexpr int num_messages = 50;
+    tbb::flow::graph g;
+    tbb::concurrent_bounded_queue<int> input;
+    async_node_type node(g, tbb::flow::unlimited, [&input](int value, async_node_type::gateway_type& gateway) {
+        gateway.reserve_wait();
+        async_activity(value, gateway, input);
+    });
+    std::atomic<int> sum{0};
+    tbb::flow::function_node<int> sink(g, tbb::flow::unlimited, [&sum](int value) { sum += value; });
+    tbb::flow::make_edge(node, sink);
+
+    for (int i = 0; i < num_messages; ++i) {
+        node.try_put(i);
+    }
+    for (int i = 0; i < num_messages; ++i) {
+        input.push(1);
+    }
+    g.wait_for_all();
+    CHECK(sum == num_messages * (num_messages - 1) / 2 + num_messages);
+}
+
+#else
+
+//! \brief \ref interface
+TEST_CASE("C++20 coroutines are not available") {
+    CHECK(true);
+}
+
+#endif // TBB_HAS_COROUTINES
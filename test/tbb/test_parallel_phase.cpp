@@ -18,11 +18,17 @@
 //! \file test_parallel_phase.cpp
 //! \brief Test for [scheduler.task_arena scheduler.parallel_phase] functionality
 //!
+
+// The internal headers of the scheduler refer to the arena statistics
+#define TBB_PREVIEW_TASK_ARENA_STATISTICS 1
 #if defined(_MSC_VER) && !defined(__INTEL_COMPILER)
 #pragma warning(push)
 #pragma warning(disable: 4324) // warning C4324: structure was padded due to alignment specifier
 #endif
 
+#include <atomic>
+#include <chrono>
+#include <thread>
 #include <utility>
 
 #include "common/test.h"
@@ -32,6 +38,7 @@
 #include "oneapi/tbb/detail/_parallel_phase.h"
 #include "tbb/global_control.h"
 #include "tbb/task_arena.h"
+#include "tbb/parallel_for.h"
 
 // For thread_leave_manager
 #include "../src/tbb/misc.cpp"
@@ -44,6 +51,8 @@
 using end_flag_fast_leave = tbb::task_arena::parallel_phase::end_flag_fast_leave;
 
 using tbb::detail::r1::thread_leave_manager;
+using tbb::detail::r1::work_arrival_predictor;
+using tbb::detail::r1::parking_slot;
 
 //! \brief \ref error_guessing
 TEST_CASE("Test thread_leave_manager state machine") {
@@ -97,6 +106,76 @@ TEST_CASE("Test thread_leave_manager under contention") {
     REQUIRE(!tlm.is_retention_allowed());
 }
 
+//! \brief \ref error_guessing
+TEST_CASE("Test work_arrival_predictor adapts to idle periods") {
+    using std::chrono::microseconds;
+    const microseconds limit{1000};
+    work_arrival_predictor predictor;
+    predictor.set_retention_limit(limit);
+    // Without history, idle workers wait as long as allowed
+    REQUIRE(predictor.retention_duration() == limit);
+
+    // Work arrival without an idle period brings no information
+    work_arrival_predictor::clock::time_point now = work_arrival_predictor::clock::now();
+    predictor.on_work_arrival(now);
+    REQUIRE(predictor.retention_duration() == limit);
+
+    // Short idle periods: wait a bit longer than the expected period
+    for (int i = 0; i < 10; ++i) {
+        predictor.on_out_of_work(now);
+        now += microseconds(100);
+        predictor.on_work_arrival(now);
+    }
+    REQUIRE(predictor.retention_duration() == microseconds(200));
+
+    // Immediate arrivals still leave time for a wakeup
+    for (int i = 0; i < 100; ++i) {
+        predictor.on_out_of_work(now);
+        predictor.on_work_arrival(now);
+    }
+    const std::int64_t min_retention = work_arrival_predictor::min_retention_us;
+    REQUIRE(predictor.retention_duration() == microseconds(min_retention));
+
+    // Long idle periods: leave at once
+    for (int i = 0; i < 100; ++i) {
+        predictor.on_out_of_work(now);
+        now += microseconds(10000);
+        predictor.on_work_arrival(now);
+    }
+    REQUIRE(predictor.retention_duration() == microseconds(0));
+
+    // The limit resets the history
+    predictor.set_retention_limit(microseconds(0));
+    REQUIRE(predictor.retention_duration() == microseconds(0));
+}
+
+//! \brief \ref error_guessing
+TEST_CASE("Test parking_slot of retained workers") {
+    using std::chrono::seconds;
+    parking_slot slot{};
+    // Nobody is parked yet
+    REQUIRE(!slot.unpark());
+    // The satisfied wakeup condition does not let the thread block
+    auto start = std::chrono::steady_clock::now();
+    slot.park(seconds(10), [] { return true; });
+    REQUIRE(std::chrono::steady_clock::now() - start < seconds(5));
+    REQUIRE(!slot.unpark());
+
+#if __TBB_WORKER_PARKING
+    // The parked thread is woken up long before the timeout
+    start = std::chrono::steady_clock::now();
+    std::thread parked_thread([&slot] {
+        slot.park(seconds(10), [] { return false; });
+    });
+    while (!slot.unpark()) {
+        std::this_thread::yield();
+    }
+    parked_thread.join();
+    REQUIRE(std::chrono::steady_clock::now() - start < seconds(5));
+    REQUIRE(!slot.unpark());
+#endif
+}
+
 struct arena_with_leave_manager : public tbb::task_arena {
     using tbb::task_arena::task_arena;
     using tbb::task_arena::get_leave_policy;
@@ -107,8 +186,49 @@ struct arena_with_leave_manager : public tbb::task_arena {
         REQUIRE_MESSAGE(a, "arena must be initialized to inspect its thread_leave_manager");
         return a->my_thread_leave;
     }
+
+    work_arrival_predictor& get_arrival_predictor() {
+        initialize();
+        auto* a = my_arena.load(std::memory_order_relaxed);
+        REQUIRE_MESSAGE(a, "arena must be initialized to inspect its work_arrival_predictor");
+        return a->my_arrival_predictor;
+    }
 };
 
+//! \brief \ref interface \ref requirement
+TEST_CASE("Test worker retention limit set by global_control") {
+    using std::chrono::microseconds;
+    using tbb::global_control;
+    const std::size_t default_limit = work_arrival_predictor::default_retention_limit_us;
+    REQUIRE(global_control::active_value(global_control::worker_retention_limit) == default_limit);
+    {
+        arena_with_leave_manager ta{};
+        REQUIRE(ta.get_arrival_predictor().retention_duration() == microseconds(default_limit));
+    }
+    {
+        global_control gc1(global_control::worker_retention_limit, 500);
+        global_control gc2(global_control::worker_retention_limit, 100);
+        // The shortest limit is preferred
+        REQUIRE(global_control::active_value(global_control::worker_retention_limit) == 100);
+
+        arena_with_leave_manager ta{};
+        REQUIRE(ta.get_arrival_predictor().retention_duration() == microseconds(100));
+    }
+    {
+        // Workers leave at once but the work is still done
+        global_control gc(global_control::worker_retention_limit, 0);
+        arena_with_leave_manager ta{};
+        for (int i = 0; i < 10; ++i) {
+            std::atomic<int> counter{0};
+            ta.execute([&counter] {
+                tbb::parallel_for(0, 1000, [&counter] (int) { ++counter; });
+            });
+            REQUIRE(counter == 1000);
+        }
+        REQUIRE(ta.get_arrival_predictor().retention_duration() == microseconds(0));
+    }
+}
+
 //! \brief \ref interface \ref requirement
 TEST_CASE("Test task_arena leavy policy settings") {
     using leave_policy = tbb::task_arena::leave_policy;
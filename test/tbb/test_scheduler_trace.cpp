@@ -0,0 +1,111 @@
+/*
+    Copyright (c) 2025 UXL Foundation Contributors
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+// The flow graph reports the execution of node bodies only if the profiling tools support is enabled
+#define TBB_USE_PROFILING_TOOLS 1
+
+#include "common/test.h"
+#include "common/utils.h"
+
+#include "tbb/global_control.h"
+#include "tbb/parallel_for.h"
+#include "tbb/task_arena.h"
+#include "tbb/flow_graph.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+
+//! \file test_scheduler_trace.cpp
+//! \brief Test for the scheduler trace recorder enabled with TBB_TRACE
+
+std::size_t count_occurrences(const std::string& text, const std::string& pattern) {
+    std::size_t count = 0;
+    for (std::size_t pos = text.find(pattern); pos != std::string::npos; pos = text.find(pattern, pos + 1)) {
+        ++count;
+    }
+    return count;
+}
+
+//! \brief \ref requirement
+TEST_CASE("Scheduler events are written in the Chrome trace format") {
+    const char* tracing = std::getenv("TBB_TRACE");
+    const char* file_name = std::getenv("TBB_TRACE_FILE");
+    if (!tracing || std::strcmp(tracing, "1") != 0 || !file_name) {
+        // The recorder is enabled only by the environment before the library is loaded
+        return;
+    }
+
+    constexpr int num_short_lived_threads = 20;
+    tbb::task_scheduler_handle handle{tbb::attach{}};
+    {
+        tbb::global_control concurrency(tbb::global_control::max_allowed_parallelism, 2);
+        std::atomic<int> executed{0};
+        tbb::parallel_for(0, 1000, [&executed] (int) { ++executed; });
+        REQUIRE(executed == 1000);
+
+        // Each thread is joined before the next one starts, so they can share a single buffer
+        for (int i = 0; i < num_short_lived_threads; ++i) {
+            std::thread thread([&executed] {
+                tbb::parallel_for(0, 10, [&executed] (int) { ++executed; });
+            });
+            thread.join();
+        }
+        REQUIRE(executed == 1000 + 10 * num_short_lived_threads);
+        executed = 1000;
+
+        tbb::task_arena arena(2);
+        arena.execute([&executed] {
+            tbb::flow::graph g;
+            tbb::flow::function_node<int, int> node(g, tbb::flow::unlimited, [&executed] (int v) {
+                ++executed;
+                return v;
+            });
+            for (int i = 0; i < 100; ++i) {
+                node.try_put(i);
+            }
+            g.wait_for_all();
+        });
+        REQUIRE(executed == 1100);
+    }
+    // The trace is written when the worker threads are finished
+    REQUIRE(tbb::finalize(handle, std::nothrow));
+
+    std::ifstream file(file_name);
+    REQUIRE_MESSAGE(file.good(), "The trace file is not written");
+    std::stringstream content;
+    content << file.rdbuf();
+    const std::string trace = content.str();
+
+    CHECK(trace.find("{\"displayTimeUnit\":\"ns\",\"traceEvents\":[") == 0);
+    CHECK(trace.rfind("]}") != std::string::npos);
+    CHECK(count_occurrences(trace, "\"name\":\"spawn\",\"ph\":\"i\"") > 0);
+    CHECK(count_occurrences(trace, "\"name\":\"arena\",\"ph\":\"B\"") > 0);
+    CHECK(count_occurrences(trace, "\"name\":\"flow\",\"ph\":\"B\"") >= 100);
+
+    // Each begin event is matched by the end event because no buffer is overflowed
+    const std::size_t execute_begins = count_occurrences(trace, "\"name\":\"execute\",\"ph\":\"B\"");
+    CHECK(execute_begins >= 100);
+    CHECK(execute_begins == count_occurrences(trace, "\"name\":\"execute\",\"ph\":\"E\""));
+    CHECK(count_occurrences(trace, "\"name\":\"flow\",\"ph\":\"B\"") ==
+          count_occurrences(trace, "\"name\":\"flow\",\"ph\":\"E\""));
+    // The threads that shared a buffer keep their own rows
+    CHECK(count_occurrences(trace, "\"args\":{\"name\":\"thread ") > std::size_t(num_short_lived_threads));
+}
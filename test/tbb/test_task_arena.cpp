@@ -15,6 +15,8 @@
     limitations under the License.
 */
 
+#define TBB_PREVIEW_TASK_ARENA_WARM_UP 1
+
 #include "common/test.h"
 
 #define __TBB_EXTRA_DEBUG 1
@@ -1022,6 +1024,38 @@ namespace TestIsolatedExecuteNS {
         tbb::detail::d1::wait(waiter, ctx);
         // while (completed < TestEnqueueTask::N + N) utils::yield();
     }
+
+    // Each level leaves its tasks in the task pool and enters the next isolated region, so the pool
+    // holds the tasks of all the enclosing regions and is relocated on the way.
+    void RunDeepNestingLevel( int level, tbb::enumerable_thread_specific<int>& isolated_level, std::atomic<int>& executed ) {
+        const int num_pending_tasks = 100;
+        const int max_level = 16;
+        tbb::task_group tg;
+        for ( int i = 0; i < num_pending_tasks; ++i ) {
+            tg.run( [&isolated_level, &executed, level] {
+                CHECK_FAST_MESSAGE( isolated_level.local() <= level, "A task of an enclosing region is executed in the isolated region" );
+                ++executed;
+            } );
+        }
+        if ( level < max_level ) {
+            int previous_level = isolated_level.local();
+            isolated_level.local() = level + 1;
+            tbb::this_task_arena::isolate( [&] {
+                RunDeepNestingLevel( level + 1, isolated_level, executed );
+            } );
+            isolated_level.local() = previous_level;
+        }
+        tg.wait();
+    }
+
+    void DeepNestingTest() {
+        tbb::enumerable_thread_specific<int> isolated_level( 0 );
+        for ( int i = 0; i < 10; ++i ) {
+            std::atomic<int> executed{0};
+            RunDeepNestingLevel( 0, isolated_level, executed );
+            REQUIRE( executed == 17 * 100 );
+        }
+    }
 }
 
 void TestIsolatedExecute() {
@@ -1041,6 +1075,7 @@ void TestIsolatedExecute() {
     TestIsolatedExecuteNS::HeavyMixTest();
     TestIsolatedExecuteNS::TestNonConstBody();
     TestIsolatedExecuteNS::TestEnqueue();
+    TestIsolatedExecuteNS::DeepNestingTest();
 }
 
 //-----------------------------------------------------------------------------------------//
@@ -2263,3 +2298,108 @@ TEST_CASE("ODR-use task_arena constants") {
     CHECK(task_arena_ptr != nullptr);
 }
 #endif // __TBB_CPP17_PRESENT
+
+#if TBB_HAS_TASK_ARENA_WARM_UP
+class worker_entry_tracker : public tbb::task_scheduler_observer {
+    tbb::concurrent_set<std::thread::id>& my_workers;
+public:
+    worker_entry_tracker(tbb::task_arena& arena, tbb::concurrent_set<std::thread::id>& workers)
+        : tbb::task_scheduler_observer(arena), my_workers(workers)
+    {
+        observe(true);
+    }
+    ~worker_entry_tracker() {
+        observe(false);
+    }
+    void on_scheduler_entry(bool is_worker) override {
+        if (is_worker) {
+            my_workers.insert(std::this_thread::get_id());
+        }
+    }
+};
+
+//! \brief \ref interface \ref requirement
+TEST_CASE("Workers join the arena on warm-up") {
+    constexpr int num_workers = 3;
+    tbb::global_control concurrency(tbb::global_control::max_allowed_parallelism, num_workers + 1);
+    // The high priority isolates the arena from the arenas of other test cases still demanding workers
+    tbb::task_arena arena(num_workers + 1, 1, tbb::task_arena::priority::high);
+    tbb::concurrent_set<std::thread::id> workers;
+    worker_entry_tracker tracker(arena, workers);
+
+    arena.warm_up();
+    CHECK(arena.is_active());
+    CHECK_MESSAGE(workers.size() == num_workers, "Each worker the arena can have must join it");
+    CHECK(workers.count(std::this_thread::get_id()) == 0);
+
+    // The warm-up does not prevent the arena from being used
+    std::atomic<int> executed{0};
+    arena.execute([&executed] {
+        tbb::parallel_for(0, 100, [&executed](int) { ++executed; });
+    });
+    CHECK(executed == 100);
+
+    // There is nothing to warm up in the arena without workers
+    tbb::task_arena workerless(1, 1);
+    workerless.warm_up();
+    CHECK(workerless.is_active());
+}
+
+//! \brief \ref error_guessing
+TEST_CASE("Warm-up returns when no worker comes") {
+    tbb::global_control concurrency(tbb::global_control::max_allowed_parallelism, 2);
+    // The only worker is held by the arena of a higher priority
+    tbb::task_arena busy_arena(2, 1, tbb::task_arena::priority::high);
+    std::atomic<bool> started{false};
+    std::atomic<bool> release{false};
+    std::atomic<bool> done{false};
+    busy_arena.enqueue([&] {
+        started = true;
+        utils::SpinWaitUntilEq(release, true);
+        done = true;
+    });
+    utils::SpinWaitUntilEq(started, true);
+
+    tbb::task_arena arena(2, 1, tbb::task_arena::priority::low);
+    auto start = std::chrono::steady_clock::now();
+    arena.warm_up();
+    CHECK(std::chrono::steady_clock::now() - start < std::chrono::seconds(10));
+
+    release = true;
+    utils::SpinWaitUntilEq(done, true);
+    // The skipped warm-up tasks do not prevent the arena from being used
+    std::atomic<int> executed{0};
+    arena.execute([&executed] {
+        tbb::parallel_for(0, 100, [&executed](int) { ++executed; });
+    });
+    CHECK(executed == 100);
+}
+
+//! \brief \ref error_guessing
+TEST_CASE("Warm-up from the arena itself returns immediately") {
+    tbb::global_control concurrency(tbb::global_control::max_allowed_parallelism, 2);
+    tbb::task_arena arena(2, 1, tbb::task_arena::priority::high);
+    // Each blocked call would wait for the warm-up time limit
+    constexpr int num_calls = 10;
+    auto warm_up_from_arena = [&arena] {
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < num_calls; ++i) {
+            arena.warm_up();
+        }
+        return std::chrono::steady_clock::now() - start;
+    };
+
+    std::chrono::steady_clock::duration external_duration{};
+    arena.execute([&] { external_duration = warm_up_from_arena(); });
+    CHECK(external_duration < std::chrono::milliseconds(100));
+
+    std::atomic<bool> done{false};
+    std::chrono::steady_clock::duration worker_duration{};
+    arena.enqueue([&] {
+        worker_duration = warm_up_from_arena();
+        done = true;
+    });
+    utils::SpinWaitUntilEq(done, true);
+    CHECK(worker_duration < std::chrono::milliseconds(100));
+}
+#endif // TBB_HAS_TASK_ARENA_WARM_UP
@@ -0,0 +1,150 @@
+/*
+    Copyright (c) 2025 UXL Foundation Contributors
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#define TBB_PREVIEW_TASK_ARENA_DEADLINES 1
+
+#include "common/test.h"
+#include "common/utils.h"
+#include "common/spin_barrier.h"
+
+#include "tbb/global_control.h"
+#include "tbb/task_arena.h"
+#include "tbb/task_group.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+//! \file test_task_arena_deadlines.cpp
+//! \brief Test for [preview] task_arena enqueue with deadlines functionality
+
+using deadline_type = std::chrono::steady_clock::time_point;
+
+//! Occupies the only worker of the arena until released, so the enqueued tasks accumulate in the arena
+class worker_blocker {
+public:
+    explicit worker_blocker(tbb::task_arena& arena) {
+        arena.enqueue([this] {
+            my_started = true;
+            utils::SpinWaitUntilEq(my_released, true);
+        });
+        utils::SpinWaitUntilEq(my_started, true);
+    }
+
+    void release() {
+        my_released = true;
+    }
+
+private:
+    std::atomic<bool> my_started{false};
+    std::atomic<bool> my_released{false};
+};
+
+//! Records the order in which the tasks are executed
+class execution_log {
+public:
+    explicit execution_log(std::size_t size) : my_records(size) {}
+
+    void record(std::int64_t value) {
+        my_records[my_size++] = value;
+    }
+
+    void wait_for(std::size_t size) const {
+        utils::SpinWaitUntilEq(my_size, size);
+    }
+
+    const std::vector<std::int64_t>& records() const {
+        return my_records;
+    }
+
+private:
+    std::vector<std::int64_t> my_records;
+    std::atomic<std::size_t> my_size{0};
+};
+
+//! \brief \ref interface \ref requirement
+TEST_CASE("Enqueued tasks are executed in the order of deadlines") {
+    tbb::global_control concurrency(tbb::global_control::max_allowed_parallelism, 2);
+    // The external thread does not take the tasks, so the single worker executes all of them
+    tbb::task_arena arena(2, /*reserved_for_masters*/ 1);
+
+    constexpr int num_producers = 4;
+    constexpr int tasks_per_producer = 250;
+    execution_log log(num_producers * tasks_per_producer);
+    const deadline_type origin = std::chrono::steady_clock::now() + std::chrono::seconds(1);
+
+    worker_blocker blocker(arena);
+    // The producers contend for the lanes of the arena
+    utils::NativeParallelFor(num_producers, [&] (int producer) {
+        utils::FastRandom<> random(producer);
+        for (int i = 0; i < tasks_per_producer; ++i) {
+            std::int64_t offset = std::int64_t(random.get() % 100000);
+            arena.enqueue([&log, offset] { log.record(offset); }, origin + std::chrono::microseconds(offset));
+        }
+    });
+    blocker.release();
+    log.wait_for(num_producers * tasks_per_producer);
+
+    const std::vector<std::int64_t>& offsets = log.records();
+    for (std::size_t i = 1; i < offsets.size(); ++i) {
+        REQUIRE_MESSAGE(offsets[i - 1] <= offsets[i], "The tasks are not executed in the order of deadlines");
+    }
+}
+
+//! \brief \ref interface \ref requirement
+TEST_CASE("Tasks with deadlines are preferred to other enqueued tasks") {
+    tbb::global_control concurrency(tbb::global_control::max_allowed_parallelism, 2);
+    tbb::task_arena arena(2, /*reserved_for_masters*/ 1);
+
+    constexpr int num_tasks = 100;
+    execution_log log(2 * num_tasks);
+    const deadline_type deadline = std::chrono::steady_clock::now();
+
+    worker_blocker blocker(arena);
+    for (int i = 0; i < num_tasks; ++i) {
+        arena.enqueue([&log] { log.record(0); });
+        arena.enqueue([&log] { log.record(1); }, deadline + std::chrono::microseconds(i));
+    }
+    blocker.release();
+    log.wait_for(2 * num_tasks);
+
+    const std::vector<std::int64_t>& kinds = log.records();
+    for (int i = 0; i < num_tasks; ++i) {
+        REQUIRE(kinds[i] == 1);
+        REQUIRE(kinds[num_tasks + i] == 0);
+    }
+}
+
+//! \brief \ref interface \ref requirement
+TEST_CASE("Enqueue with deadline into the current arena and with task_handle") {
+    tbb::global_control concurrency(tbb::global_control::max_allowed_parallelism, 2);
+    tbb::task_arena arena(2);
+
+    constexpr int num_tasks = 100;
+    std::atomic<int> executed{0};
+    tbb::task_group tg;
+    arena.execute([&] {
+        for (int i = 0; i < num_tasks; ++i) {
+            deadline_type deadline = std::chrono::steady_clock::now() + std::chrono::microseconds(num_tasks - i);
+            tbb::this_task_arena::enqueue([&executed] { ++executed; }, deadline);
+            tbb::this_task_arena::enqueue(tg.defer([&executed] { ++executed; }), deadline);
+        }
+    });
+    arena.enqueue(tg.defer([&executed] { ++executed; }), std::chrono::steady_clock::now());
+    arena.wait_for(tg);
+    utils::SpinWaitUntilEq(executed, 2 * num_tasks + 1);
+}
@@ -0,0 +1,482 @@
+/*
+    Copyright (c) 2025 UXL Foundation Contributors
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#define TBB_PREVIEW_TASK_ARENA_STATISTICS 1
+#define TBB_PREVIEW_TASK_ARENA_WEIGHTS 1
+#define TBB_PREVIEW_TASK_ARENA_MIN_CONCURRENCY 1
+
+#include "common/test.h"
+#include "common/utils.h"
+#include "common/spin_barrier.h"
+#include "common/utils_concurrency_limit.h"
+#include "common/utils_env.h"
+
+#include "tbb/global_control.h"
+#include "tbb/task_arena.h"
+#include "tbb/task_group.h"
+#include "tbb/parallel_for.h"
+#include "tbb/task.h"
+#include "tbb/task_scheduler_observer.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <initializer_list>
+
+//! \file test_task_arena_statistics.cpp
+//! \brief Test for [preview] task_arena statistics functionality
+
+using statistics_type = tbb::task_arena_statistics;
+
+std::uint64_t total_steals(const statistics_type& stats) {
+    std::uint64_t total = 0;
+    for (std::uint64_t count : stats.steals_by_locality) {
+        total += count;
+    }
+    return total;
+}
+
+//! The external thread spawns a task and does not execute it, so it can be executed only by a thief
+void force_steal(tbb::task_arena& arena) {
+    arena.execute([] {
+        std::atomic<int> stolen{0};
+        tbb::task_group tg;
+        tg.run([&stolen] { stolen = 1; });
+        utils::SpinWaitUntilEq(stolen, 1);
+        tg.wait();
+    });
+}
+
+//! \brief \ref interface \ref requirement
+TEST_CASE("Steals are accounted in arena statistics") {
+    // At least one worker is required to steal the task
+    tbb::global_control concurrency(tbb::global_control::max_allowed_parallelism, 2);
+    tbb::task_arena arena(2);
+    statistics_type before = arena.get_statistics();
+    force_steal(arena);
+    statistics_type after = arena.get_statistics();
+
+    for (unsigned level = 0; level < statistics_type::locality_levels_count; ++level) {
+        CHECK_MESSAGE(after.steals_by_locality[level] >= before.steals_by_locality[level],
+                      "Statistics counters must not decrease");
+    }
+    CHECK_MESSAGE(total_steals(after) > total_steals(before), "The steal is not accounted");
+}
+
+//! \brief \ref interface
+TEST_CASE("Statistics of the current arena") {
+    tbb::task_arena arena(utils::get_platform_max_threads());
+    arena.execute([&arena] {
+        std::atomic<int> sum{0};
+        tbb::parallel_for(0, 1000, [&sum] (int i) { sum += i; });
+        CHECK(sum == 999 * 1000 / 2);
+        statistics_type current = tbb::this_task_arena::get_statistics();
+        statistics_type explicit_arena = arena.get_statistics();
+        CHECK(total_steals(current) <= total_steals(explicit_arena));
+    });
+}
+
+//! \brief \ref interface
+TEST_CASE("Statistics of independent arenas are independent") {
+    tbb::global_control concurrency(tbb::global_control::max_allowed_parallelism, 2);
+    tbb::task_arena busy_arena(2);
+    tbb::task_arena idle_arena(2);
+    idle_arena.initialize();
+    force_steal(busy_arena);
+    CHECK(total_steals(busy_arena.get_statistics()) > 0);
+    CHECK(total_steals(idle_arena.get_statistics()) == 0);
+}
+
+//! \brief \ref interface \ref requirement
+TEST_CASE("Tasks moved by batch stealing are accounted") {
+    // The batch size is read from the environment when the library is initialized
+    const char* batch_size = utils::GetEnv("TBB_STEAL_BATCH_SIZE");
+    bool batch_stealing = batch_size && std::atol(batch_size) > 0;
+
+    tbb::global_control concurrency(tbb::global_control::max_allowed_parallelism, 2);
+    tbb::task_arena arena(2);
+    constexpr int num_tasks = 100;
+    arena.execute([] {
+        // The external thread does not take the spawned tasks, so the worker steals all of them
+        std::atomic<int> executed{0};
+        tbb::task_group tg;
+        for (int i = 0; i < num_tasks; ++i) {
+            tg.run([&executed] { ++executed; });
+        }
+        utils::SpinWaitUntilEq(executed, num_tasks);
+        tg.wait();
+    });
+    statistics_type stats = arena.get_statistics();
+    if (batch_stealing) {
+        CHECK_MESSAGE(stats.steals_saved_by_batching > 0, "The tasks are not moved in batches");
+        CHECK(total_steals(stats) + stats.steals_saved_by_batching >= std::uint64_t(num_tasks));
+    } else {
+        CHECK(stats.steals_saved_by_batching == 0);
+    }
+}
+
+//! \brief \ref interface \ref requirement
+TEST_CASE("Scheduler events are accounted in arena statistics") {
+    tbb::global_control concurrency(tbb::global_control::max_allowed_parallelism, 2);
+    tbb::task_arena arena(2);
+    statistics_type before = arena.get_statistics();
+
+    constexpr int num_tasks = 100;
+    std::atomic<int> executed{0};
+    arena.execute([&executed] {
+        tbb::task_group tg;
+        for (int i = 0; i < num_tasks; ++i) {
+            tg.run([&executed] { ++executed; });
+        }
+        tg.wait();
+    });
+    for (int i = 0; i < num_tasks; ++i) {
+        arena.enqueue([&executed] { ++executed; });
+    }
+    utils::SpinWaitUntilEq(executed, 2 * num_tasks);
+    force_steal(arena);
+    statistics_type after = arena.get_statistics();
+
+    CHECK(after.spawned_tasks - before.spawned_tasks >= std::uint64_t(num_tasks));
+    CHECK(after.enqueued_tasks - before.enqueued_tasks == std::uint64_t(num_tasks));
+    CHECK(after.executed_tasks - before.executed_tasks >= std::uint64_t(2 * num_tasks));
+    CHECK(after.stolen_tasks == total_steals(after));
+    CHECK(after.stolen_tasks > before.stolen_tasks);
+    CHECK(after.wakeups > before.wakeups);
+    CHECK(after.worker_joins > 0);
+    CHECK(after.worker_leaves <= after.worker_joins);
+}
+
+//! \brief \ref interface \ref requirement
+TEST_CASE("Buckets of the latency histogram") {
+    using histogram_type = statistics_type::latency_histogram;
+    const unsigned buckets_count = histogram_type::buckets_count;
+    const unsigned sub_buckets_count = histogram_type::sub_buckets_count;
+    for (unsigned i = 0; i < buckets_count; ++i) {
+        std::uint64_t lower_bound = histogram_type::bucket_lower_bound(i);
+        REQUIRE(histogram_type::bucket_index(lower_bound) == i);
+        if (i + 1 < buckets_count) {
+            std::uint64_t next_bound = histogram_type::bucket_lower_bound(i + 1);
+            REQUIRE(next_bound > lower_bound);
+            REQUIRE(histogram_type::bucket_index(next_bound - 1) == i);
+            // Small values are exact, the width of other buckets is bounded relative to their values
+            if (lower_bound < sub_buckets_count) {
+                REQUIRE(next_bound - lower_bound == 1);
+            } else {
+                REQUIRE((next_bound - lower_bound) * sub_buckets_count <= lower_bound);
+            }
+        }
+    }
+    REQUIRE(histogram_type::bucket_index(~std::uint64_t(0)) == buckets_count - 1);
+
+    histogram_type histogram;
+    REQUIRE(histogram.total_count() == 0);
+    for (std::uint64_t value = 1; value <= 1000; ++value) {
+        ++histogram.counts[histogram_type::bucket_index(value * 1000)];
+    }
+    REQUIRE(histogram.total_count() == 1000);
+    std::uint64_t median = histogram.percentile(0.5);
+    CHECK((median <= 500000 && median * sub_buckets_count >= 500000 * (sub_buckets_count - 1)));
+    CHECK(histogram.percentile(1.0) <= 1000000);
+    CHECK(histogram.percentile(1.0) >= histogram.percentile(0.99));
+
+    histogram_type merged;
+    merged.merge(histogram);
+    merged.merge(histogram);
+    CHECK(merged.total_count() == 2000);
+    CHECK(merged.percentile(0.5) == median);
+}
+
+//! \brief \ref interface \ref requirement
+TEST_CASE("Enqueue latency is accounted in arena statistics") {
+    // The tracking is enabled from the environment when the library is initialized
+    const char* tracking = utils::GetEnv("TBB_ENQUEUE_LATENCY");
+    bool latency_tracking = tracking && std::strcmp(tracking, "1") == 0;
+
+    tbb::global_control concurrency(tbb::global_control::max_allowed_parallelism, 2);
+    tbb::task_arena arena(2);
+    statistics_type before = arena.get_statistics();
+
+    constexpr int num_tasks = 100;
+    std::atomic<int> executed{0};
+    for (int i = 0; i < num_tasks; ++i) {
+        arena.enqueue([&executed] { ++executed; });
+    }
+    utils::SpinWaitUntilEq(executed, num_tasks);
+    statistics_type after = arena.get_statistics();
+
+    std::uint64_t recorded = after.enqueue_latency.total_count() - before.enqueue_latency.total_count();
+    if (latency_tracking) {
+        CHECK(recorded == std::uint64_t(num_tasks));
+        CHECK(after.enqueue_latency.percentile(0.5) <= after.enqueue_latency.percentile(1.0));
+    } else {
+        CHECK(recorded == 0);
+    }
+}
+
+bool cpu_time_accounting_enabled() {
+    // The accounting is enabled from the environment when the library is initialized
+    const char* accounting = utils::GetEnv("TBB_ARENA_CPU_TIME");
+    return accounting && std::strcmp(accounting, "1") == 0;
+}
+
+//! Keeps the calling thread busy for the given time
+void busy_wait(std::chrono::milliseconds duration) {
+    auto start = std::chrono::steady_clock::now();
+    while (std::chrono::steady_clock::now() - start < duration) {
+        utils::doDummyWork(100);
+    }
+}
+
+//! \brief \ref interface \ref requirement
+TEST_CASE("CPU time is accounted per arena") {
+    tbb::task_arena busy_arena(2, 1);
+    tbb::task_arena idle_arena(2, 1);
+    busy_arena.execute([] {
+        tbb::parallel_for(0, 4, [] (int) { busy_wait(std::chrono::milliseconds(20)); });
+    });
+    idle_arena.execute([] {});
+
+    std::uint64_t busy_time = busy_arena.get_statistics().cpu_time_ns;
+    std::uint64_t idle_time = idle_arena.get_statistics().cpu_time_ns;
+    if (cpu_time_accounting_enabled()) {
+        CHECK(busy_time > 0);
+        CHECK(busy_time > idle_time);
+
+        // The time keeps growing while a thread is in the arena
+        busy_arena.execute([busy_time] {
+            busy_wait(std::chrono::milliseconds(10));
+            CHECK(tbb::this_task_arena::get_statistics().cpu_time_ns > busy_time);
+        });
+    } else {
+        CHECK(busy_time == 0);
+        CHECK(idle_time == 0);
+    }
+}
+
+//! The observer collects the CPU time of its arena when threads leave it
+class cpu_time_observer : public tbb::task_scheduler_observer {
+public:
+    explicit cpu_time_observer(tbb::task_arena& arena) : tbb::task_scheduler_observer(arena) {
+        observe(true);
+    }
+    ~cpu_time_observer() override {
+        observe(false);
+    }
+    void on_scheduler_exit(bool) override {
+        std::uint64_t cpu_time = tbb::this_task_arena::get_statistics().cpu_time_ns;
+        std::uint64_t observed = my_observed_cpu_time.load();
+        while (observed < cpu_time && !my_observed_cpu_time.compare_exchange_weak(observed, cpu_time)) {}
+    }
+    std::atomic<std::uint64_t> my_observed_cpu_time{0};
+};
+
+//! \brief \ref interface \ref requirement
+TEST_CASE("CPU time is available to observers on exit from the arena") {
+    tbb::task_arena arena(2, 1);
+    cpu_time_observer observer(arena);
+    arena.execute([] { busy_wait(std::chrono::milliseconds(10)); });
+
+    if (cpu_time_accounting_enabled()) {
+        CHECK_MESSAGE(observer.my_observed_cpu_time > 0, "The time of the leaving thread is not charged yet");
+        CHECK(observer.my_observed_cpu_time <= arena.get_statistics().cpu_time_ns);
+    } else {
+        CHECK(observer.my_observed_cpu_time == 0);
+    }
+}
+
+#if __TBB_RESUMABLE_TASKS
+//! Suspends the calling task several times; each suspension is resumed immediately
+void suspend_and_resume(tbb::task_arena& arena, int num_suspends) {
+    arena.execute([num_suspends] {
+        for (int i = 0; i < num_suspends; ++i) {
+            tbb::task::suspend([] (tbb::task::suspend_point sp) { tbb::task::resume(sp); });
+        }
+    });
+}
+
+//! \brief \ref interface \ref requirement
+TEST_CASE("Reuse of suspend points is accounted in arena statistics") {
+    constexpr int num_suspends = 100;
+    {
+        tbb::task_arena arena(1, 1);
+        suspend_and_resume(arena, num_suspends);
+        statistics_type stats = arena.get_statistics();
+
+        std::uint64_t suspends = stats.reused_suspend_points + stats.created_suspend_points;
+        CHECK(suspends <= std::uint64_t(num_suspends));
+        CHECK(stats.created_suspend_points > 0);
+        CHECK_MESSAGE(stats.reused_suspend_points > 0, "Suspend points are not taken from the cache");
+    }
+
+    // The stacks of the destroyed arena are returned to the pool of the process
+    tbb::task_arena arena(1, 1);
+    statistics_type before = arena.get_statistics();
+    suspend_and_resume(arena, num_suspends);
+    statistics_type after = arena.get_statistics();
+    CHECK(after.created_suspend_points > 0);
+    if (after.mapped_stacks > 0) {
+        CHECK_MESSAGE(after.reused_stacks > before.reused_stacks, "Stacks are not taken from the pool");
+    }
+}
+#endif // __TBB_RESUMABLE_TASKS
+
+// global_control::max_allowed_parallelism functionality is not covered by TCM
+#if !__TBB_TCM_TESTING_ENABLED
+//! Keeps the arena demanding all of its workers until the release
+void saturate(tbb::task_arena& arena, std::atomic<bool>& release, std::atomic<int>& num_tasks) {
+    for (int i = 0; i < 2 * arena.max_concurrency(); ++i) {
+        ++num_tasks;
+        arena.enqueue([&release, &num_tasks] {
+            utils::SpinWaitUntilEq(release, true);
+            --num_tasks;
+        });
+    }
+}
+
+//! Releases the tasks and waits until the arenas stop demanding workers
+void release_workers(std::initializer_list<tbb::task_arena*> arenas, std::atomic<bool>& release, std::atomic<int>& num_tasks) {
+    release = true;
+    utils::SpinWaitUntilEq(num_tasks, 0);
+    for (tbb::task_arena* arena : arenas) {
+        utils::SpinWaitWhile([arena] { return arena->get_statistics().allotted_workers != 0; });
+    }
+}
+
+std::uint64_t allotted_workers(tbb::task_arena& arena) {
+    return arena.get_statistics().allotted_workers;
+}
+
+//! \brief \ref interface \ref requirement
+TEST_CASE("Workers are shared between saturated arenas by their weights") {
+    constexpr int num_workers = 10;
+    tbb::global_control parallelism(tbb::global_control::max_allowed_parallelism, num_workers + 1);
+
+    // The arenas of the other test cases have the normal priority and do not compete with these ones
+    constexpr auto priority = tbb::task_arena::priority::high;
+    tbb::task_arena heavy(tbb::task_arena::constraints{}.set_max_concurrency(num_workers + 1).set_weight(7), 1, priority);
+    tbb::task_arena light(tbb::task_arena::constraints{}.set_max_concurrency(num_workers + 1).set_weight(3), 1, priority);
+    tbb::task_arena narrow(tbb::task_arena::constraints{}.set_max_concurrency(2).set_weight(7), 1, priority);
+    heavy.initialize();
+    light.initialize();
+    narrow.initialize();
+    CHECK(heavy.weight() == 7);
+
+    std::atomic<bool> release{false};
+    std::atomic<int> num_tasks{0};
+
+    // The arena borrows the whole share while the other arenas do not demand workers
+    saturate(heavy, release, num_tasks);
+    CHECK(allotted_workers(heavy) == num_workers);
+    CHECK(allotted_workers(light) == 0);
+
+    saturate(light, release, num_tasks);
+    CHECK(allotted_workers(heavy) == 7);
+    CHECK(allotted_workers(light) == 3);
+
+    // The share the narrow arena cannot use is redistributed by the weights of the others
+    saturate(narrow, release, num_tasks);
+    CHECK(allotted_workers(narrow) == 1);
+    CHECK(allotted_workers(heavy) + allotted_workers(light) == num_workers - 1);
+    CHECK(allotted_workers(heavy) >= 6);
+    CHECK(allotted_workers(light) >= 2);
+
+    release_workers({&heavy, &light, &narrow}, release, num_tasks);
+}
+
+//! \brief \ref interface \ref requirement
+TEST_CASE("Arenas without weights share workers by their demand") {
+    constexpr int num_workers = 10;
+    tbb::global_control parallelism(tbb::global_control::max_allowed_parallelism, num_workers + 1);
+
+    constexpr auto priority = tbb::task_arena::priority::high;
+    tbb::task_arena first(num_workers + 1, 1, priority);
+    tbb::task_arena second(num_workers + 1, 1, priority);
+    CHECK(first.weight() == int(tbb::task_arena::automatic));
+
+    std::atomic<bool> release{false};
+    std::atomic<int> num_tasks{0};
+    saturate(first, release, num_tasks);
+    saturate(second, release, num_tasks);
+    CHECK(allotted_workers(first) == num_workers / 2);
+    CHECK(allotted_workers(second) == num_workers / 2);
+
+    release_workers({&first, &second}, release, num_tasks);
+}
+
+//! \brief \ref interface \ref requirement
+TEST_CASE("Guaranteed workers are reserved for the arena under contention") {
+    constexpr int num_workers = 10;
+    tbb::global_control parallelism(tbb::global_control::max_allowed_parallelism, num_workers + 1);
+
+    // The reserved slot counts toward the minimal concurrency, so two workers are guaranteed
+    tbb::task_arena critical(tbb::task_arena::constraints{}.set_max_concurrency(5).set_min_concurrency(3), 1);
+    tbb::task_arena batch(num_workers + 1, 1, tbb::task_arena::priority::high);
+    critical.initialize();
+    CHECK(critical.min_concurrency() == 3);
+    CHECK(batch.min_concurrency() == int(tbb::task_arena::automatic));
+
+    std::atomic<bool> release{false};
+    std::atomic<int> num_tasks{0};
+    // The guarantee does not take workers while the arena has no work
+    saturate(batch, release, num_tasks);
+    CHECK(allotted_workers(batch) == num_workers);
+    CHECK(allotted_workers(critical) == 0);
+
+    // The arena of the lower priority gets its guaranteed workers but nothing more
+    saturate(critical, release, num_tasks);
+    CHECK(allotted_workers(critical) == 2);
+    CHECK(allotted_workers(batch) == num_workers - 2);
+
+    release_workers({&critical, &batch}, release, num_tasks);
+}
+
+//! \brief \ref interface \ref requirement
+TEST_CASE("Workers migrate between arenas directly") {
+    // A single worker serves the arenas one after another
+    tbb::global_control parallelism(tbb::global_control::max_allowed_parallelism, 2);
+    tbb::task_arena first(2, 1, tbb::task_arena::priority::high);
+    tbb::task_arena second(2, 1, tbb::task_arena::priority::high);
+    second.initialize();
+
+    std::atomic<bool> release{false};
+    std::atomic<int> num_tasks{2};
+    std::atomic<bool> started{false};
+    first.enqueue([&] {
+        started = true;
+        utils::SpinWaitUntilEq(release, true);
+        --num_tasks;
+    });
+    utils::SpinWaitUntilEq(started, true);
+    // The second arena gets the worker when the first one runs out of work
+    second.enqueue([&] { --num_tasks; });
+    release = true;
+    utils::SpinWaitUntilEq(num_tasks, 0);
+
+    statistics_type stats = second.get_statistics();
+    CHECK(stats.worker_joins > 0);
+    CHECK_MESSAGE(stats.worker_handoffs > 0, "The worker did not move to the arena directly");
+    CHECK(stats.worker_handoffs <= stats.worker_joins);
+    const char* tracking = utils::GetEnv("TBB_MIGRATION_LATENCY");
+    if (tracking && std::strcmp(tracking, "1") == 0) {
+        CHECK(stats.migration_latency.total_count() > 0);
+    } else {
+        CHECK(stats.migration_latency.total_count() == 0);
+    }
+}
+#endif // !__TBB_TCM_TESTING_ENABLED
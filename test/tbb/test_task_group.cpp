@@ -15,6 +15,8 @@
     limitations under the License.
 */
 
+#define TBB_PREVIEW_WORK_FIRST_TASK_GROUP 1
+
 #include "common/test.h"
 
 #if _MSC_VER
@@ -31,11 +33,13 @@
 #include "tbb/enumerable_thread_specific.h"
 
 #include "tbb/task_group.h"
+#include "tbb/parallel_for.h"
 
 #include "common/concurrency_tracker.h"
 
 #include <atomic>
 #include <stdexcept>
+#include <thread>
 #include <unordered_map>
 
 //! \file test_task_group.cpp
@@ -915,6 +919,134 @@ TEST_CASE("Move semantics test for the isolated task group") {
 //TODO: add test void isolated_task_group::run(d2::task_handle&& h) and isolated_task_group::::run_and_wait(d2::task_handle&& h)
 #endif /* TBB_PREVIEW_ISOLATED_TASK_GROUP */
 
+#if __TBB_PREVIEW_WORK_FIRST_TASK_GROUP
+#if !__TBB_USE_ADDRESS_SANITIZER && !EMSCRIPTEN
+//! Test for thread safety for the work_first_task_group
+//! \brief \ref error_guessing
+TEST_CASE("Thread safety test for the work-first task group") {
+    if (tbb::this_task_arena::max_concurrency() < 2) {
+        // The test requires more than one thread to check thread safety
+        return;
+    }
+    for (unsigned p=MinThread; p <= MaxThread; ++p) {
+        if (p < 2) {
+            continue;
+        }
+        tbb::global_control limit(tbb::global_control::max_allowed_parallelism, p);
+        g_MaxConcurrency = p;
+        TestThreadSafety<tbb::work_first_task_group>();
+    }
+}
+#endif
+
+//! Fibonacci test for the work-first task group
+//! \brief \ref interface \ref requirement
+TEST_CASE("Fibonacci test for the work-first task group") {
+    for (unsigned p=MinThread; p <= MaxThread; ++p) {
+        tbb::global_control limit(tbb::global_control::max_allowed_parallelism, p);
+        tbb::task_arena a(p);
+        g_MaxConcurrency = p;
+        a.execute([] {
+            RunFibonacciTests<tbb::work_first_task_group>();
+        });
+    }
+}
+
+//! Cancellation and exception test for the work-first task group
+//! \brief \ref interface \ref requirement
+TEST_CASE("Cancellation and exception test for the work-first task group") {
+    for (unsigned p = MinThread; p <= MaxThread; ++p) {
+        tbb::global_control limit(tbb::global_control::max_allowed_parallelism, p);
+        tbb::task_arena a(p);
+        g_MaxConcurrency = p;
+        a.execute([] {
+            RunCancellationAndExceptionHandlingTests<tbb::work_first_task_group>();
+        });
+    }
+}
+
+//! Constant functor and move semantics test for the work-first task group
+//! \brief \ref interface \ref requirement
+TEST_CASE("Constant functor and move semantics test for the work-first task group") {
+    TestConstantFunctorRequirement<tbb::work_first_task_group>();
+    TestMoveSemantics<tbb::work_first_task_group>();
+}
+
+//! The last submitted task is executed by the waiting thread
+//! \brief \ref requirement
+TEST_CASE("The work-first task group executes the last task by the waiting thread") {
+    CHECK_MESSAGE(TBB_HAS_WORK_FIRST_TASK_GROUP == 202610, "Incorrect feature test macro for work_first_task_group");
+
+    tbb::task_arena arena(4);
+    arena.execute([] {
+        for (int repeat = 0; repeat < 100; ++repeat) {
+            tbb::work_first_task_group tg;
+            std::atomic<int> executed{0};
+            std::thread::id last_executor;
+            for (int i = 0; i < 10; ++i) {
+                tg.run([&executed] { ++executed; });
+            }
+            tg.run([&last_executor] { last_executor = std::this_thread::get_id(); });
+            CHECK(tg.wait() == tbb::task_group_status::complete);
+            CHECK(executed == 10);
+            CHECK(last_executor == std::this_thread::get_id());
+
+            // The task handle is held back in the same way
+            tbb::task_handle h = tg.defer([&last_executor] { last_executor = std::this_thread::get_id(); });
+            last_executor = std::thread::id{};
+            tg.run(std::move(h));
+            CHECK(tg.wait() == tbb::task_group_status::complete);
+            CHECK(last_executor == std::this_thread::get_id());
+        }
+    });
+
+    // The held task is cancelled together with the group
+    tbb::work_first_task_group tg;
+    bool executed = false;
+    tg.run([&executed] { executed = true; });
+    tg.cancel();
+    CHECK(tg.wait() == tbb::task_group_status::canceled);
+    CHECK(!executed);
+}
+
+//! Submits the tasks of a binary tree into the same group from the tasks of the group
+template <typename TaskGroup>
+void RunTree(TaskGroup& tg, int depth, std::atomic<int>& executed) {
+    ++executed;
+    if (depth > 0) {
+        tg.run([&tg, depth, &executed] { RunTree(tg, depth - 1, executed); });
+        tg.run([&tg, depth, &executed] { RunTree(tg, depth - 1, executed); });
+    }
+}
+
+//! The tasks submitted by the tasks of the group while it is waited for are executed
+//! \brief \ref error_guessing
+TEST_CASE("The work-first task group runs the tasks submitted by its own tasks") {
+    for (unsigned p = MinThread; p <= MaxThread; ++p) {
+        tbb::global_control limit(tbb::global_control::max_allowed_parallelism, p);
+        tbb::task_arena arena(p);
+        arena.execute([] {
+            for (int repeat = 0; repeat < 100; ++repeat) {
+                tbb::work_first_task_group tg;
+                bool executed = false;
+                tg.run([&tg, &executed] { tg.run([&executed] { executed = true; }); });
+                CHECK(tg.wait() == tbb::task_group_status::complete);
+                CHECK(executed);
+
+                executed = false;
+                CHECK(tg.run_and_wait([&tg, &executed] { tg.run([&executed] { executed = true; }); }) == tbb::task_group_status::complete);
+                CHECK(executed);
+
+                std::atomic<int> num_executed{0};
+                tg.run([&tg, &num_executed] { RunTree(tg, 6, num_executed); });
+                CHECK(tg.wait() == tbb::task_group_status::complete);
+                CHECK(num_executed == (1 << 7) - 1);
+            }
+        });
+    }
+}
+#endif // __TBB_PREVIEW_WORK_FIRST_TASK_GROUP
+
 void run_deep_stealing(tbb::task_group& tg1, tbb::task_group& tg2, int num_tasks, std::atomic<int>& tasks_executed) {
     for (int i = 0; i < num_tasks; ++i) {
         tg2.run([&tg1, &tasks_executed] {
@@ -1162,6 +1294,138 @@ TEST_CASE("Respect task_group_context passed from outside") {
 #endif
 }
 
+namespace cancellation_propagation {
+
+//! Creates a tree of nested task groups whose innermost tasks wait until the stop condition holds
+template <typename StopCondition>
+void RunNested(int depth, std::atomic<int>& waiting, bool expect_cancelled, const StopCondition& stop) {
+    if (depth == 0) {
+        ++waiting;
+        utils::SpinWaitWhile([&stop] { return !stop(); });
+        CHECK(tbb::is_current_task_group_canceling() == expect_cancelled);
+        // A context bound after the cancellation of its ancestor inherits the cancellation
+        tbb::task_group late_group;
+        late_group.run([] {});
+        CHECK((late_group.wait() == tbb::task_group_status::canceled) == expect_cancelled);
+        return;
+    }
+    tbb::task_group tg;
+    for (int i = 0; i < 2; ++i) {
+        tg.run([depth, &waiting, expect_cancelled, &stop] { RunNested(depth - 1, waiting, expect_cancelled, stop); });
+    }
+    tg.wait();
+}
+
+void Test() {
+    const int depth = 6;
+    for (int rep = 0; rep < 20; ++rep) {
+        std::atomic<int> waiting_cancelled{0};
+        std::atomic<int> waiting_other{0};
+        std::atomic<bool> cancelled{false};
+
+        // The tree of the other external thread waits for the cancellation of the first tree
+        std::thread other([&] {
+            tbb::task_group other_group;
+            other_group.run([&] {
+                RunNested(depth, waiting_other, false, [&cancelled] { return cancelled.load(); });
+            });
+            CHECK(other_group.wait() == tbb::task_group_status::complete);
+        });
+
+        tbb::task_group cancelled_group;
+        std::thread canceller([&] {
+            utils::SpinWaitWhile([&] { return waiting_cancelled == 0 || waiting_other == 0; });
+            cancelled_group.cancel();
+            cancelled = true;
+        });
+        cancelled_group.run([&] {
+            RunNested(depth, waiting_cancelled, true, [] { return tbb::is_current_task_group_canceling(); });
+        });
+        CHECK(cancelled_group.wait() == tbb::task_group_status::canceled);
+
+        canceller.join();
+        other.join();
+    }
+}
+
+//! Cancels a task group while its tasks run nested parallel algorithms
+void TestNestedAlgorithms() {
+    for (int rep = 0; rep < 20; ++rep) {
+        std::atomic<int> waiting{0};
+        std::atomic<int> late_iterations{0};
+        tbb::task_group tg;
+        std::thread canceller([&] {
+            utils::SpinWaitWhile([&waiting] { return waiting == 0; });
+            tg.cancel();
+        });
+        tg.run([&] {
+            tbb::parallel_for(0, 2, [&](int) {
+                tbb::parallel_for(0, 2, [&](int) {
+                    ++waiting;
+                    utils::SpinWaitWhile([] { return !tbb::is_current_task_group_canceling(); });
+                    // The context of the innermost algorithm gets a child only after the cancellation
+                    tbb::parallel_for(0, 10, [&late_iterations](int) { ++late_iterations; });
+                }, tbb::simple_partitioner());
+            }, tbb::simple_partitioner());
+        });
+        CHECK(tg.wait() == tbb::task_group_status::canceled);
+        canceller.join();
+        CHECK(late_iterations == 0);
+    }
+}
+
+//! Creates a chain of nested task groups whose innermost task waits for the cancellation
+void RunChain(int depth, std::atomic<bool>& reached) {
+    if (depth == 0) {
+        reached = true;
+        utils::SpinWaitWhile([] { return !tbb::is_current_task_group_canceling(); });
+        return;
+    }
+    tbb::task_group tg;
+    tg.run([depth, &reached] { RunChain(depth - 1, reached); });
+    CHECK(tg.wait() == tbb::task_group_status::canceled);
+}
+
+void TestDeepNesting() {
+    const int depth = 500;
+    for (int rep = 0; rep < 5; ++rep) {
+        std::atomic<bool> reached{false};
+        tbb::task_group root;
+        std::thread canceller([&] {
+            utils::SpinWaitWhile([&reached] { return !reached; });
+            root.cancel();
+        });
+        root.run([&reached] { RunChain(depth, reached); });
+        CHECK(root.wait() == tbb::task_group_status::canceled);
+        canceller.join();
+    }
+}
+
+} // namespace cancellation_propagation
+
+//! The cancellation reaches the contexts of the cancelled tree, including the ones bound concurrently with it,
+//! and does not affect other trees
+//! \brief \ref requirement
+TEST_CASE("Cancellation propagation across trees of contexts") {
+    tbb::global_control control(tbb::global_control::max_allowed_parallelism, 4);
+    cancellation_propagation::Test();
+}
+
+//! The cancellation reaches the innermost context of a deeply nested chain
+//! \brief \ref error_guessing
+TEST_CASE("Cancellation propagation through deeply nested contexts") {
+    tbb::global_control control(tbb::global_control::max_allowed_parallelism, 4);
+    cancellation_propagation::TestDeepNesting();
+}
+
+//! The cancellation reaches the contexts of nested algorithms, which are linked to their parents only
+//! when they get children
+//! \brief \ref requirement
+TEST_CASE("Cancellation propagation into nested algorithms") {
+    tbb::global_control control(tbb::global_control::max_allowed_parallelism, 4);
+    cancellation_propagation::TestNestedAlgorithms();
+}
+
 #if __TBB_PREVIEW_TASK_GROUP_EXTENSIONS
 //! The test for task_handle inside other task waiting with run
 //! \brief \ref requirement
@@ -2657,6 +2921,100 @@ TEST_CASE("test single task wait") {
 TEST_CASE("test task_group::get_status_of") {
     test_get_status_of();
 }
+
+//! Sums the Fibonacci numbers of the leaves: spawns fib(n - 1) and continues with fib(n - 2)
+struct fib_continuation_body {
+    tbb::task_continuation<fib_continuation_body> operator()() const {
+        if (n < 2) {
+            sum += n;
+            return {};
+        }
+        tg.run(fib_continuation_body{n - 1, tg, sum});
+        return tbb::continue_with(fib_continuation_body{n - 2, tg, sum});
+    }
+
+    int n;
+    tbb::task_group& tg;
+    std::atomic<long>& sum;
+};
+
+//! Records the task that executes each step of the chain
+struct recording_continuation_body {
+    tbb::task_continuation<recording_continuation_body> operator()() const {
+        executors.push_back(tbb::detail::d1::current_task_ptr());
+        if (step + 1 == num_steps) {
+            return {};
+        }
+        return recording_continuation_body{step + 1, num_steps, executors};
+    }
+
+    int step;
+    int num_steps;
+    std::vector<tbb::detail::d1::task*>& executors;
+};
+
+//! \brief \ref interface \ref requirement
+TEST_CASE("test task_group continuations") {
+    CHECK_MESSAGE(TBB_HAS_TASK_GROUP_CONTINUATIONS == 202610, "Incorrect feature test macro for task_group continuations");
+
+    tbb::global_control concurrency(tbb::global_control::max_allowed_parallelism, 2);
+    tbb::task_group tg;
+
+    {
+        std::atomic<long> sum{0};
+        tg.run(fib_continuation_body{20, tg, sum});
+        tg.wait();
+        CHECK(sum == 6765);
+
+        sum = 0;
+        tg.run_and_wait(fib_continuation_body{20, tg, sum});
+        CHECK(sum == 6765);
+    }
+    {
+        // All steps of the chain are executed in the storage of the same task
+        std::vector<tbb::detail::d1::task*> executors;
+        tg.run(recording_continuation_body{0, 100, executors});
+        tg.wait();
+        REQUIRE(executors.size() == 100);
+        for (tbb::detail::d1::task* t : executors) {
+            CHECK(t == executors.front());
+        }
+    }
+    {
+        // The successors wait for the last step of the chain
+        std::vector<tbb::detail::d1::task*> executors;
+        bool chain_completed = false;
+        tbb::task_handle chain = tg.defer(recording_continuation_body{0, 10, executors});
+        tbb::task_completion_handle chain_completion = chain;
+        tbb::task_handle successor = tg.defer([&] { chain_completed = executors.size() == 10; });
+        tbb::task_group::set_task_order(chain, successor);
+        tg.run(std::move(successor));
+        tg.run(std::move(chain));
+        tg.wait();
+        CHECK(chain_completed);
+        CHECK(tg.get_status_of(chain_completion) == tbb::task_group_status::complete);
+    }
+}
+
+//! \brief \ref error_guessing
+TEST_CASE("test cancellation of task_group continuations") {
+    tbb::task_group tg;
+    struct cancelling_body {
+        tbb::task_continuation<cancelling_body> operator()() const {
+            if (++steps == 10) {
+                tg.cancel();
+            }
+            return cancelling_body{tg, steps};
+        }
+
+        tbb::task_group& tg;
+        int& steps;
+    };
+    int steps = 0;
+    tg.run(cancelling_body{tg, steps});
+    CHECK(tg.wait() == tbb::task_group_status::canceled);
+    CHECK(steps == 10);
+}
 #endif // __TBB_PREVIEW_TASK_GROUP_EXTENSIONS
 
 #if _MSC_VER
@@ -0,0 +1,158 @@
+/*
+    Copyright (c) 2025 UXL Foundation Contributors
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#if _MSC_VER && !defined(__INTEL_COMPILER)
+// structure was padded due to alignment specifier
+#pragma warning( disable: 4324 )
+#endif
+
+#include "common/test.h"
+#include "common/utils.h"
+
+#include "../../src/tbb/task_stream.h"
+
+#include <atomic>
+#include <vector>
+
+//! \file test_task_stream.cpp
+//! \brief Test for [internal] functionality
+
+using tbb::detail::r1::task_stream;
+using tbb::detail::r1::front_accessor;
+using tbb::detail::r1::random_lane_selector;
+using tbb::detail::r1::subsequent_lane_selector;
+using tbb::detail::r1::FastRandom;
+
+//! A task that is only stored in the stream and never executed
+struct node_task : tbb::detail::d1::task {
+    explicit node_task(unsigned node = 0) : my_node(node) {}
+
+    tbb::detail::d1::task* execute(tbb::detail::d1::execution_data&) override { return nullptr; }
+    tbb::detail::d1::task* cancel(tbb::detail::d1::execution_data&) override { return nullptr; }
+
+    unsigned my_node;
+    std::atomic<int> my_pops{0};
+};
+
+unsigned node_of(tbb::detail::d1::task* t) {
+    return static_cast<node_task*>(t)->my_node;
+}
+
+//! \brief \ref error_guessing
+TEST_CASE("Lanes of the task stream are partitioned by NUMA nodes") {
+    task_stream<front_accessor> stream;
+    stream.initialize(/*n_lanes*/ 8, /*n_groups*/ 2);
+    REQUIRE(stream.is_partitioned());
+
+    FastRandom random(&stream);
+    unsigned hint = 0;
+    constexpr int tasks_per_node = 100;
+    std::vector<node_task> tasks(2 * tasks_per_node);
+    for (int i = 0; i < 2 * tasks_per_node; ++i) {
+        tasks[i].my_node = i % 2;
+        stream.push_local(&tasks[i], tasks[i].my_node, random_lane_selector(random));
+    }
+
+    // The local lanes are drained without touching the lanes of the other node
+    for (int i = 0; i < tasks_per_node; ++i) {
+        tbb::detail::d1::task* t = stream.pop_local(/*numa_node*/ 1, subsequent_lane_selector(hint));
+        REQUIRE(t != nullptr);
+        REQUIRE(node_of(t) == 1);
+    }
+    REQUIRE(stream.pop_local(/*numa_node*/ 1, subsequent_lane_selector(hint)) == nullptr);
+    REQUIRE_FALSE(stream.empty());
+
+    // The remote lanes are still reachable
+    for (int i = 0; i < tasks_per_node; ++i) {
+        tbb::detail::d1::task* t = stream.pop(subsequent_lane_selector(hint));
+        REQUIRE(t != nullptr);
+        REQUIRE(node_of(t) == 0);
+    }
+    REQUIRE(stream.empty());
+}
+
+//! \brief \ref error_guessing
+TEST_CASE("Each NUMA group of the task stream has its own lanes") {
+    task_stream<front_accessor> stream;
+    // There are fewer lanes than groups need, so the number of lanes is increased
+    stream.initialize(/*n_lanes*/ 2, /*n_groups*/ 4);
+    REQUIRE(stream.is_partitioned());
+
+    FastRandom random(&stream);
+    unsigned hint = 0;
+    // Nodes 0 and 4 share the group, as well as nodes 1 and 5
+    std::vector<node_task> tasks(6);
+    for (unsigned i = 0; i < tasks.size(); ++i) {
+        tasks[i].my_node = i;
+        stream.push_local(&tasks[i], i, random_lane_selector(random));
+    }
+    for (unsigned node = 0; node < 4; ++node) {
+        int popped = 0;
+        while (tbb::detail::d1::task* t = stream.pop_local(node, subsequent_lane_selector(hint))) {
+            REQUIRE(node_of(t) % 4 == node);
+            ++popped;
+        }
+        REQUIRE(popped == (node < 2 ? 2 : 1));
+    }
+    REQUIRE(stream.empty());
+
+    task_stream<front_accessor> plain_stream;
+    plain_stream.initialize(/*n_lanes*/ 4);
+    REQUIRE_FALSE(plain_stream.is_partitioned());
+}
+
+//! \brief \ref error_guessing
+TEST_CASE("Concurrent local first pops take each task once") {
+    constexpr unsigned num_nodes = 2;
+    constexpr int num_threads = 4;
+    constexpr int tasks_per_thread = 10000;
+    task_stream<front_accessor> stream;
+    stream.initialize(/*n_lanes*/ num_threads, num_nodes);
+
+    std::vector<node_task> tasks(num_threads * tasks_per_thread);
+    std::atomic<int> popped{0};
+    utils::NativeParallelFor(num_threads, [&] (int idx) {
+        const unsigned node = unsigned(idx) % num_nodes;
+        FastRandom random(&tasks[idx * tasks_per_thread]);
+        unsigned hint = 0;
+        for (int i = 0; i < tasks_per_thread; ++i) {
+            node_task& t = tasks[idx * tasks_per_thread + i];
+            t.my_node = node;
+            stream.push_local(&t, node, random_lane_selector(random));
+            // Every other iteration takes a task, preferring the local lanes
+            if (i % 2) {
+                tbb::detail::d1::task* popped_task = stream.pop_local(node, subsequent_lane_selector(hint));
+                if (!popped_task) {
+                    popped_task = stream.pop(subsequent_lane_selector(hint));
+                }
+                if (popped_task) {
+                    ++static_cast<node_task*>(popped_task)->my_pops;
+                    ++popped;
+                }
+            }
+        }
+    });
+    unsigned hint = 0;
+    while (tbb::detail::d1::task* t = stream.pop(subsequent_lane_selector(hint))) {
+        ++static_cast<node_task*>(t)->my_pops;
+        ++popped;
+    }
+    REQUIRE(stream.empty());
+    REQUIRE(popped == num_threads * tasks_per_thread);
+    for (node_task& t : tasks) {
+        REQUIRE(t.my_pops == 1);
+    }
+}